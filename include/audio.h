@@ -8,56 +8,8 @@
 
 #include <raylib.h>
 
-#define SOUND_COUNT 46
-
-typedef enum {
-    SND_AMMO,
-    SND_APPLAUSE,
-    SND_BALL2BALL,
-    SND_BALLLOST,
-    SND_BALLSHOT,
-    SND_BOING,
-    SND_BOMB,
-    SND_BONUS,
-    SND_BUZZER,
-    SND_CLICK,
-    SND_DDLOO,
-    SND_DOH1,
-    SND_DOH2,
-    SND_DOH3,
-    SND_DOH4,
-    SND_EVILLAUGH,
-    SND_GAMEOVER,
-    SND_GATE,
-    SND_HITHERE,
-    SND_HYPSPC,
-    SND_INTRO,
-    SND_KEY,
-    SND_LOOKSBAD,
-    SND_METAL,
-    SND_MGUN,
-    SND_OUCH,
-    SND_PADDLE,
-    SND_PING,
-    SND_SHARK,
-    SND_SHOOT,
-    SND_SHOTGUN,
-    SND_SPRING,
-    SND_STAMP,
-    SND_STICKY,
-    SND_SUPBONS,
-    SND_TOGGLE,
-    SND_TONE,
-    SND_TOUCH,
-    SND_WALLSOFF,
-    SND_WARP,
-    SND_WEEEK,
-    SND_WHIZZO,
-    SND_WHOOSH,
-    SND_WZZZ,
-    SND_WZZZ2,
-    SND_YOUAGOD
-} SoundID;
+#include "core/core_sound.h"
+#include "core/core_jobs.h"
 
 typedef struct AudioSystem {
     Sound sounds[SOUND_COUNT];
@@ -66,8 +18,8 @@ typedef struct AudioSystem {
 
 extern AudioSystem audio;
 
-// Initialize audio system
-bool initAudioFiles(void);
+// Initialize audio system, decoding the sounds on jobs when given
+bool initAudioFiles(CoreJobs *jobs);
 
 // Free all resources
 void FreeAudioSystem(void);
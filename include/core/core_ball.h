@@ -0,0 +1,148 @@
+#ifndef _CORE_BALL_H_
+#define _CORE_BALL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_types.h"
+#include "core/core_real.h"
+
+#define CORE_BALL_WIDTH  20
+#define CORE_BALL_HEIGHT 19
+
+#ifndef CORE_MAX_BALLS
+#define CORE_MAX_BALLS   512    // at most 65535, order[] is 16 bit
+#endif
+
+// things one ball can do in a step before the rest are dropped
+#define CORE_BALL_RECORDS 8
+
+typedef enum {
+    BALL_SPAWNED,   // waiting on the paddle for release
+    BALL_ACTIVE,    // flying
+    BALL_ATTACHED,  // caught by a sticky paddle
+    BALL_LOST       // fell out this step, removed before the step ends
+} BALL_STATES;
+
+typedef enum {
+    BALL_RECORD_EVENT,  // push event with sound
+    BALL_RECORD_BLOCK,  // hit the block at row, col
+    BALL_RECORD_CATCH   // landed on the sticky paddle and stayed there
+} BALL_RECORD_KINDS;
+
+/*
+ * Balls move independently of each other against the state the step started
+ * from, and write down what they hit instead of changing anything shared.
+ * The records of all balls are then applied in order of time, then ball.
+ */
+typedef struct CoreBallRecord {
+    CoreReal time;      // seconds into the step
+    uint8_t kind;       // BALL_RECORD_KINDS
+    uint8_t event;      // CoreEventType
+    uint8_t sound;      // SoundID
+    uint8_t row;
+    uint8_t col;
+} CoreBallRecord;
+
+/*
+ * Every ball in play, one array per field, in CoreReal units. Balls 0..count-1 are live and
+ * removing one moves the last ball into its slot, so the step loops run over
+ * packed arrays and adding or losing balls never allocates. Indices are only
+ * stable until the next ball is removed.
+ *
+ * The first group is read and written for every ball every tick; the rest
+ * only matters while a ball sits on the paddle or is being drawn.
+ */
+typedef struct CoreBallPool {
+    int count;
+
+    CoreReal x[CORE_MAX_BALLS];     // upper left
+    CoreReal y[CORE_MAX_BALLS];
+    CoreReal vx[CORE_MAX_BALLS];    // directional velocity, y points up
+    CoreReal vy[CORE_MAX_BALLS];
+    int speed[CORE_MAX_BALLS];      // pixels per second
+    uint8_t state[CORE_MAX_BALLS];  // BALL_STATES
+
+    uint16_t order[CORE_MAX_BALLS]; // live balls by left edge, kept sorted between ticks
+
+    CoreReal prevX[CORE_MAX_BALLS]; // position before the last tick, for interpolation
+    CoreReal prevY[CORE_MAX_BALLS];
+    CoreReal anchorX[CORE_MAX_BALLS];  // offset from the paddle while attached
+    CoreReal anchorY[CORE_MAX_BALLS];
+
+    bool sticky;                // the next ball to land on the paddle stays there
+    CoreAngle releaseAngle;     // launch guide shared by the balls on the paddle
+    int guideDirection;         // 1 or -1
+
+    // scratch for CoreMoveBalls(), only meaningful during a step
+    uint8_t recordCount[CORE_MAX_BALLS];
+    CoreBallRecord records[CORE_MAX_BALLS][CORE_BALL_RECORDS];
+} CoreBallPool;
+
+
+/**
+ * @brief Empties the pool and puts a single new ball on the paddle
+ *
+ */
+void CoreResetBalls(CoreGame *game);
+
+/**
+ * @brief Takes a free slot for a new ball
+ *
+ * Position and velocity are converted to CoreReal.
+ *
+ * @return the ball's index, or -1 if all CORE_MAX_BALLS are in play
+ */
+int CoreAddBall(CoreGame *game, CoreVec2 position, CoreVec2 velocity, int speed, BALL_STATES state);
+
+/**
+ * @brief Frees a ball's slot by moving the last ball into it
+ *
+ */
+void CoreRemoveBall(CoreGame *game, int ball);
+
+/**
+ * @brief Starts a second ball from where this one is, heading the other way across
+ *
+ * @return the new ball's index, or -1 if the pool is full
+ */
+int CoreSplitBall(CoreGame *game, int ball);
+
+// Launches the balls waiting on the paddle and lets go of any it has caught
+void CoreReleaseBalls(CoreGame *game);
+
+/**
+ * @brief Advances every ball dt seconds and resolves wall, paddle and block contacts
+ *
+ * Balls move on the game's workers when it has them, with the same result
+ * as moving them one after another. Block hits and events are then applied
+ * in time order. Lost balls are removed; the life ends (MODE_LOSE) when the
+ * last one goes. Balls that would meet during the next dt then rebound off
+ * each other.
+ */
+void CoreMoveBalls(CoreGame *game, float dt);
+
+/**
+ * @brief Swings the launch direction guide while a ball waits on the paddle
+ *
+ */
+void CoreRotateGuide(CoreGame *game, float dt);
+
+bool CoreBallWaiting(const CoreGame *game);
+CoreVec2 CoreBallPosition(const CoreGame *game, int ball);
+CoreRect CoreBallCollisionRec(const CoreGame *game, int ball);
+
+/**
+ * @brief The swept box test of the ball step, for tracing a ball ahead of it
+ *
+ * Whether box, moved by motionX and motionY, touches target on the way,
+ * decided exactly as the ball step decides it. toi gets the fraction of the
+ * motion at first touch and xAxis whether the face touched is vertical; a
+ * box already overlapping target touches at 0 if it is heading further in.
+ */
+bool CoreBallSweep(CoreRect box, float motionX, float motionY, CoreRect target, float *toi, bool *xAxis);
+
+void CoreSetBallSticky(CoreGame *game);
+void CoreIncreaseBallSpeed(CoreGame *game, int ball);
+
+#endif // _CORE_BALL_H_
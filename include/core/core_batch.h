@@ -0,0 +1,62 @@
+#ifndef _CORE_BATCH_H_
+#define _CORE_BATCH_H_
+
+/*
+ * Many games of one level stepped together, for training and evaluating
+ * bots. The games sit in one contiguous array and each step spreads them
+ * over a set of worker threads; every game takes its own controls and
+ * gives back a reward and whether its episode has ended.
+ *
+ * An episode runs from a fresh level until it is cleared, the last life is
+ * lost or the tick limit is reached; lives restart on their own in between.
+ * A game whose episode ended starts a new one, from a new seed, at the
+ * start of the next step, so done flags report the final state first.
+ *
+ * Each game is about 78 KB with the default CORE_MAX_BALLS; builds that
+ * run thousands at once may want to lower it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_game.h"
+
+#define CORE_BATCH_BLOCK_REWARD  1.0f     // per destructible block removed
+#define CORE_BATCH_LIFE_REWARD   -10.0f   // per ball lost with no other in play
+#define CORE_BATCH_CLEAR_REWARD  100.0f   // for clearing the level
+#define CORE_BATCH_MAX_TICKS     (10ull * 60 * CORE_TICK_RATE)
+
+typedef struct CoreBatch CoreBatch;
+
+/**
+ * @brief Loads levelFile once and starts count games of it
+ *
+ * Game i's episodes are seeded from seed and i, so results do not depend
+ * on the number of threads.
+ * @param threadCount threads stepping the games, the caller included; 0 for one per CPU
+ * @return NULL if the level could not be loaded or memory or threads ran out
+ */
+CoreBatch *CoreBatchCreate(int count, const char *levelFile, uint64_t seed, int threadCount);
+void CoreBatchDestroy(CoreBatch *batch);
+
+int CoreBatchCount(const CoreBatch *batch);
+
+// Ticks after which an episode ends undecided, CORE_BATCH_MAX_TICKS to start with
+void CoreBatchSetMaxTicks(CoreBatch *batch, unsigned long long maxTicks);
+
+// Ends game's episode now and starts the next
+void CoreBatchReset(CoreBatch *batch, int game);
+
+/**
+ * @brief Steps every game one tick
+ *
+ * @param actions one set of controls per game
+ * @param rewards receives each game's reward for the tick, may be NULL
+ * @param done receives whether each game's episode ended this tick, may be NULL
+ */
+void CoreBatchStep(CoreBatch *batch, const CoreInput *actions, float *rewards, bool *done);
+
+// The state of a game as the last step left it; valid until the next step
+const CoreGame *CoreBatchGame(const CoreBatch *batch, int game);
+
+#endif // _CORE_BATCH_H_
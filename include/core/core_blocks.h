@@ -0,0 +1,130 @@
+#ifndef _CORE_BLOCKS_H_
+#define _CORE_BLOCKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_types.h"
+#include "core/core_simd.h"
+
+#define CORE_ROW_MAX 15
+#define CORE_COL_MAX 9
+
+typedef enum {
+	UPPER_LEFT,
+	UPPER_RIGHT,
+	LOWER_LEFT,
+	LOWER_RIGHT
+} CORNERS;
+
+typedef enum {
+	WALL_LEFT,
+	WALL_RIGHT,
+	WALL_TOP,
+	WALL_BOTTOM
+} WALLS;
+
+typedef struct CorePlayArea {
+    int screenWidth;
+    int screenHeight;
+    int playWidth;
+    int playHeight;
+    int colWidth;
+    int rowHeight;
+} CorePlayArea;
+
+/*
+ * The board as bit rows: bit col of active[row] is set while that block is
+ * in play, and solid[row] marks blocks that can never be destroyed. Both
+ * masks together fit in one cache line, so empty rows are skipped and
+ * blocks are counted without touching the hitboxes.
+ *
+ * The hitbox edges are kept a second time as one padded array per row and
+ * edge, so CoreOverlapRow() can test a whole row at once.
+ */
+typedef struct CoreBlockGrid {
+    uint16_t active[CORE_ROW_MAX];
+    uint16_t solid[CORE_ROW_MAX];
+    char type[CORE_ROW_MAX][CORE_COL_MAX];         // level file character
+    uint8_t hits[CORE_ROW_MAX][CORE_COL_MAX];      // hits left before destroyed
+    CoreRect hitbox[CORE_ROW_MAX][CORE_COL_MAX];   // sized like the block's texture
+    float left[CORE_ROW_MAX][CORE_SIMD_ROW];
+    float top[CORE_ROW_MAX][CORE_SIMD_ROW];
+    float right[CORE_ROW_MAX][CORE_SIMD_ROW];
+    float bottom[CORE_ROW_MAX][CORE_SIMD_ROW];
+} CoreBlockGrid;
+
+#define CORE_ROW_MASK ((uint16_t)((1u << CORE_COL_MAX) - 1))
+
+static inline int CoreBitCount(uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(bits);
+#else
+    int count = 0;
+    for (; bits; bits &= bits - 1) count++;
+    return count;
+#endif
+}
+
+static inline int CoreLowestBit(uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(bits);
+#else
+    int index = 0;
+    while (!(bits & 1u)) { bits >>= 1; index++; }
+    return index;
+#endif
+}
+
+void CoreInitPlayArea(CorePlayArea *playArea, int screenWidth, int screenHeight);
+CoreVec2 CorePlayCorner(const CorePlayArea *playArea, CORNERS corner);
+CoreRect CorePlayWall(const CorePlayArea *playArea, WALLS wall);
+
+/**
+ * @brief Reads a level file (name line, time line, 15x9 block characters)
+ *
+ * @return false if the file could not be opened or its header is malformed
+ */
+bool CoreLoadBlocks(CoreGame *game, const char *filename);
+
+void CoreAddBlock(CoreGame *game, int row, int col, char ch);
+bool CoreIsBlockActive(const CoreGame *game, int row, int col);
+char CoreBlockTypeAt(const CoreGame *game, int row, int col);
+
+// destructible blocks still in play
+int CoreBlocksRemaining(const CoreGame *game);
+
+/**
+ * @brief Cells a ball can get to from below the grid, a column mask per row
+ *
+ * Anything but a solid block can be passed through, so destructible blocks
+ * missing from reached are walled in and can never be cleared.
+ */
+void CoreReachableCells(const CoreBlockGrid *grid, uint16_t reached[CORE_ROW_MAX]);
+
+CoreRect CoreBlockCollisionRec(const CoreGame *game, int row, int col);
+
+/**
+ * @brief Finds the grid cells a rectangle touches
+ *
+ * Every hitbox sits inside its own cell, so only blocks in these cells can
+ * overlap the rectangle.
+ *
+ * @return false if the rectangle misses the block grid entirely
+ */
+bool CoreBlockCellRange(const CoreGame *game, CoreRect bounds, int *rowMin, int *rowMax, int *colMin, int *colMax);
+
+// Active blocks in a row whose hitboxes overlap or touch bounds, as a column bit mask
+uint32_t CoreBlockRowOverlap(const CoreGame *game, int row, CoreRect bounds);
+
+/**
+ * @brief Applies the effect of a ball touching a block
+ *
+ * Sets MODE_WIN once the last destructible block is gone.
+ *
+ * @param ball index of the ball that hit it
+ */
+void CoreActivateBlock(CoreGame *game, int ball, int row, int col);
+void CoreDeactivateBlock(CoreGame *game, int row, int col);
+
+#endif // _CORE_BLOCKS_H_
@@ -0,0 +1,85 @@
+#ifndef _CORE_BLOCKTYPES_H_
+#define _CORE_BLOCKTYPES_H_
+
+/*
+ * Block type registry. One entry per level file character holds everything
+ * the game needs to know about that kind of block, so loading a level or
+ * hitting a block is a single indexed lookup.
+ */
+
+#include <stdbool.h>
+
+#include "core/core_types.h"
+#include "core/core_sound.h"
+
+// Block images, loaded by the renderer in this order
+typedef enum {
+    BLOCK_TEX_NONE,
+    BLOCK_TEX_HYPERSPACE,
+    BLOCK_TEX_BULLET,
+    BLOCK_TEX_MAXAMMO,
+    BLOCK_TEX_RED,
+    BLOCK_TEX_GREEN,
+    BLOCK_TEX_BLUE,
+    BLOCK_TEX_TAN,
+    BLOCK_TEX_PURPLE,
+    BLOCK_TEX_YELLOW,
+    BLOCK_TEX_BLACK,
+    BLOCK_TEX_ROAMER,
+    BLOCK_TEX_BOMB,
+    BLOCK_TEX_DEATH,
+    BLOCK_TEX_EXTRABALL,
+    BLOCK_TEX_MGUN,
+    BLOCK_TEX_WALLOFF,
+    BLOCK_TEX_RANDOM,
+    BLOCK_TEX_DROP,
+    BLOCK_TEX_TIMER,
+    BLOCK_TEX_MULTIBALL,
+    BLOCK_TEX_STICKY,
+    BLOCK_TEX_REVERSE,
+    BLOCK_TEX_PAD_SHRINK,
+    BLOCK_TEX_PAD_EXPAND,
+    BLOCK_TEX_COUNTER,          // plain counter, followed by the numbered ones
+    BLOCK_TEX_COUNT = BLOCK_TEX_COUNTER + 6
+} BLOCK_TEXTURE;
+
+// What a block does to the game when a ball destroys it
+typedef void (*CoreBlockEffect)(CoreGame *game, int ball, int row, int col);
+
+typedef struct CoreBlockType {
+    bool defined;               // false for empty cells and unknown characters
+    unsigned char texture;      // BLOCK_TEXTURE
+    bool textureShowsHits;      // draw texture + hits left - 1 (counter blocks)
+    unsigned char width;        // hitbox, matching the texture
+    unsigned char height;
+    unsigned char hitPoints;    // hits to destroy, 0 for solid blocks
+    SoundID sound;              // played on every hit
+    CoreBlockEffect effect;
+} CoreBlockType;
+
+// extra block types the game and tools read at startup, when the file is there
+#define CORE_BLOCK_TYPES_FILE "resource/blocktypes.data"
+
+const CoreBlockType *CoreGetBlockType(char ch);
+
+/**
+ * @brief Adds or overrides block types from a text file
+ *
+ * Each line is "<char> <like> [width height hits [effect]]": the new
+ * character copies the type of <like>, then takes any sizes, hit count and
+ * effect (none, sticky, reverse, speed, shrink, grow, bomb, multiball)
+ * given. Lines starting with '#' are comments. Call at startup, before any
+ * level loads.
+ *
+ * @return false if the file cannot be read or a line is malformed
+ */
+bool CoreLoadBlockTypes(const char *filename);
+
+/**
+ * @brief CoreLoadBlockTypes() if the file exists; the built-in types stand without it
+ *
+ * @return false if the file exists but cannot be read or a line is malformed
+ */
+bool CoreLoadOptionalBlockTypes(const char *filename);
+
+#endif // _CORE_BLOCKTYPES_H_
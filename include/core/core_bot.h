@@ -0,0 +1,34 @@
+#ifndef _CORE_BOT_H_
+#define _CORE_BOT_H_
+
+/*
+ * A player for headless runs and soak tests. Each tick it traces every
+ * ball it might have to catch, off the walls and the active blocks, to
+ * where it will come down to the paddle, and steers the paddle with the
+ * same left and right controls a player uses toward the one due first.
+ *
+ * The trace reflects cleanly where the game adds a little random spin,
+ * and assumes every block it meets is still there after the hit, so the
+ * guess firms up as the ball comes down. Tracing one ball costs about a
+ * quarter of a microsecond.
+ */
+
+#include <stdbool.h>
+
+#include "core/core_game.h"
+
+#define CORE_BOT_BOUNCES 16     // reflections traced before giving up on a ball
+
+/**
+ * @brief Where a flying ball will next reach the height of the paddle
+ *
+ * @param landingX left edge of the ball's collision box as it gets there
+ * @param seconds time until then
+ * @return false if the ball is not flying or does not get there within CORE_BOT_BOUNCES bounces
+ */
+bool CoreBotPredict(const CoreGame *game, int ball, float *landingX, float *seconds);
+
+// A CoreInputFn; context is unused
+void CoreBotInput(void *context, const CoreGame *game, CoreInput *input);
+
+#endif // _CORE_BOT_H_
@@ -0,0 +1,54 @@
+#ifndef _CORE_BYTES_H_
+#define _CORE_BYTES_H_
+
+/*
+ * Little-endian fields for the core's file formats, read and written a
+ * byte at a time so files move between machines unchanged.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+static inline void CorePutU16(unsigned char *out, unsigned value) {
+    out[0] = value & 0xff;
+    out[1] = (value >> 8) & 0xff;
+}
+
+static inline unsigned CoreGetU16(const unsigned char *in) {
+    return in[0] | (in[1] << 8);
+}
+
+static inline void CorePutU32(unsigned char *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (value >> (8 * i)) & 0xff;
+}
+
+static inline uint32_t CoreGetU32(const unsigned char *in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)in[i] << (8 * i);
+    return value;
+}
+
+static inline void CorePutU64(unsigned char *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = (value >> (8 * i)) & 0xff;
+}
+
+static inline uint64_t CoreGetU64(const unsigned char *in) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+static inline void CorePutF32(unsigned char *out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    CorePutU32(out, bits);
+}
+
+static inline float CoreGetF32(const unsigned char *in) {
+    uint32_t bits = CoreGetU32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+#endif // _CORE_BYTES_H_
@@ -0,0 +1,36 @@
+#ifndef _CORE_CLOCK_H_
+#define _CORE_CLOCK_H_
+
+/*
+ * Fixed timestep clock. Frame time is banked in an accumulator and spent in
+ * whole ticks of CORE_TICK_DT, so the simulation runs at the same rate on
+ * every display. Whatever is left over is the interpolation factor the
+ * renderer uses to blend the previous and current tick.
+ */
+
+#define CORE_TICK_RATE 240
+#define CORE_TICK_DT   (1.0f / CORE_TICK_RATE)
+
+// longest frame we try to catch up on, so a stall cannot snowball
+#define CORE_MAX_FRAME_TIME 0.25
+
+typedef struct CoreClock {
+    double accumulator;
+} CoreClock;
+
+void CoreClockReset(CoreClock *clock);
+
+/**
+ * @brief Banks a frame's elapsed time
+ *
+ * @return number of ticks to step this frame (may be 0)
+ */
+int CoreClockAdvance(CoreClock *clock, double frameTime);
+
+/**
+ * @brief Fraction of a tick left in the accumulator, in [0, 1)
+ *
+ */
+float CoreClockAlpha(const CoreClock *clock);
+
+#endif // _CORE_CLOCK_H_
@@ -0,0 +1,123 @@
+#ifndef _CORE_DATASET_H_
+#define _CORE_DATASET_H_
+
+/*
+ * Gameplay collected for analysis: one fixed-size record per tick, holding
+ * the state after the tick, the controls that drove it and the events it
+ * raised. Records go to shard files of a fixed number of records each,
+ * named <prefix>-00000.xbds, <prefix>-00001.xbds and so on.
+ *
+ * Capturing only copies the record into a ring; a thread of the writer's
+ * own moves records from there into the memory-mapped shard, flushes it
+ * and starts the next when it is full. If the ring fills because the disk
+ * cannot keep up, records are dropped and counted rather than the game
+ * being held up.
+ *
+ * A shard is a 64 byte CoreDatasetHeader followed by the records, in the
+ * byte order of the machine that wrote it. Readers map the file and use
+ * the records where they lie.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/core_game.h"
+
+#define CORE_DATASET_VERSION        1
+#define CORE_DATASET_SHARD_RECORDS  (1u << 20)  // about 100 MB, over an hour at 240 Hz
+#define CORE_DATASET_RING_RECORDS   (1u << 14)  // records in flight to the writer thread, a power of two
+#define CORE_DATASET_BYTE_ORDER     0x01020304u // as written by the machine that made the shard
+
+// CoreDatasetRecord.inputFlags
+#define DATASET_INPUT_ABSOLUTE  0x01
+#define DATASET_INPUT_RELEASE   0x02
+#define DATASET_INPUT_REVERSE   0x04
+#define DATASET_INPUT_GROW      0x08
+#define DATASET_INPUT_SHRINK    0x10
+
+typedef struct CoreDatasetHeader {
+    char magic[4];              // "XBDS"
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t byteOrder;         // CORE_DATASET_BYTE_ORDER
+    uint32_t reserved;
+    uint64_t count;             // records in the shard
+    uint8_t unused[40];
+} CoreDatasetHeader;
+
+// One tick
+typedef struct CoreDatasetRecord {
+    uint64_t tick;
+    uint32_t session;           // whatever the capturer uses to tell runs apart
+    uint32_t events;            // bit (1 << CoreEventType) for each kind raised this tick
+
+    // the lowest flying ball, else the first ball; all 0 with no balls
+    float ballX;
+    float ballY;
+    float ballVX;               // y points up, as in the game
+    float ballVY;
+    float paddlePosition;
+    float inputPaddleX;
+
+    uint16_t ballCount;
+    uint16_t blocksRemaining;
+    int16_t timeRemaining;
+    int8_t livesRemaining;
+    uint8_t mode;               // GAME_MODES
+    uint8_t paddleIndex;
+    uint8_t reverse;
+    uint8_t inputMove;          // PADDLE_NONE, PADDLE_LEFT or PADDLE_RIGHT
+    uint8_t inputFlags;         // DATASET_INPUT_ bits
+
+    uint16_t active[CORE_ROW_MAX];  // blocks still in play, a column mask per row
+    uint8_t unused[14];
+} CoreDatasetRecord;
+
+typedef struct CoreDatasetWriter CoreDatasetWriter;
+
+/**
+ * @brief Starts the writer thread; shards are created as records arrive
+ *
+ * @param shardRecords records per shard, 0 for CORE_DATASET_SHARD_RECORDS
+ * @return NULL if the thread could not be started
+ */
+CoreDatasetWriter *CoreDatasetStart(const char *prefix, size_t shardRecords);
+
+/**
+ * @brief Queues the record of a tick just stepped
+ *
+ * Call from one thread at a time, after the step and before its events
+ * are cleared; it neither blocks nor allocates.
+ * @param input the controls the step was given
+ * @param events CoreEventMask() of the step's events
+ */
+void CoreDatasetCapture(CoreDatasetWriter *writer, const CoreGame *game, const CoreInput *input,
+                        uint32_t events, uint32_t session);
+
+/**
+ * @brief Writes what is queued, closes the last shard and stops the thread
+ *
+ * @return false if a shard could not be written
+ */
+bool CoreDatasetStop(CoreDatasetWriter *writer);
+
+// Records dropped so far because the ring was full
+unsigned long long CoreDatasetDropped(const CoreDatasetWriter *writer);
+
+
+// A shard mapped for reading
+typedef struct CoreDatasetShard {
+    const CoreDatasetRecord *records;
+    size_t count;
+
+    void *view;                 // the whole file
+    size_t size;
+    void *handle;               // the file mapping, where the system has one
+} CoreDatasetShard;
+
+// Maps a shard; false if it is missing, damaged or from another version or byte order
+bool CoreDatasetOpen(CoreDatasetShard *shard, const char *filename);
+void CoreDatasetClose(CoreDatasetShard *shard);
+
+#endif // _CORE_DATASET_H_
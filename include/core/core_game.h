@@ -0,0 +1,175 @@
+#ifndef _CORE_GAME_H_
+#define _CORE_GAME_H_
+
+/*
+ * Headless game simulation. Everything needed to play a level lives in a
+ * CoreGame and is advanced by CoreGameStep(); nothing in here touches a
+ * window, the GPU or the audio device, so the core can be linked by tools
+ * that never call InitWindow().
+ */
+
+#include <stdbool.h>
+
+#include "core/core_types.h"
+#include "core/core_sound.h"
+#include "core/core_blocks.h"
+#include "core/core_blocktypes.h"
+#include "core/core_paddle.h"
+#include "core/core_ball.h"
+#include "core/core_clock.h"
+#include "core/core_rng.h"
+#include "core/core_workers.h"
+
+#define CORE_INITIAL_LIVES 3
+#define CORE_MAX_EVENTS    64
+#define CORE_DEFAULT_SEED  0x5842u    // used until CoreGameSeed() picks another
+
+// the window the game is played in; saves, replays and rasters all depend on it
+#define CORE_SCREEN_WIDTH  575
+#define CORE_SCREEN_HEIGHT 720
+
+typedef enum {
+    MODE_INITGAME,
+    MODE_PLAY,
+    MODE_WIN,
+    MODE_LOSE,
+    MODE_CANCEL,
+    MODE_EXIT
+} GAME_MODES;
+
+typedef enum {
+    CORE_EVENT_BALL_SHOT,
+    CORE_EVENT_BALL_LOST,
+    CORE_EVENT_BALL_HIT,
+    CORE_EVENT_WALL_BOUNCE,
+    CORE_EVENT_PADDLE_HIT,
+    CORE_EVENT_BLOCK_HIT,
+    CORE_EVENT_LEVEL_CLEARED
+} CoreEventType;
+
+// Something the frontend may want to react to (sound, effects, stats)
+typedef struct CoreEvent {
+    CoreEventType type;
+    SoundID sound;
+    int row;    // block events only
+    int col;
+    char blockType;
+} CoreEvent;
+
+// Player controls for one step, filled by whatever drives the game
+typedef struct CoreInput {
+    int paddleMove;         // PADDLE_NONE, PADDLE_LEFT or PADDLE_RIGHT
+    bool paddleAbsolute;    // place the paddle at paddleX (mouse control)
+    float paddleX;
+    bool releaseBall;
+    bool toggleReverse;
+    int paddleSizeChange;   // 0, SIZE_UP or SIZE_DOWN
+} CoreInput;
+
+// Where the paddle was before the last tick, for interpolation (balls keep their own)
+typedef struct CoreRenderPrev {
+    float paddlePosition;
+} CoreRenderPrev;
+
+struct CoreGame {
+    CorePlayArea playArea;
+    unsigned long long tick;
+    CoreRng rng;            // every random choice the rules make comes from here
+
+    CoreBlockGrid grid;
+    char levelName[256];
+
+    int timeRemaining;
+    bool timerActive;
+    float timerElapsed;
+
+    CorePaddle paddle;
+    CoreBallPool balls;
+    CoreRenderPrev prev;
+
+    int livesRemaining;
+    GAME_MODES mode;
+
+    CoreEvent events[CORE_MAX_EVENTS];
+    int eventCount;
+
+    CoreWorkers *workers;   // not owned; NULL steps everything on the calling thread
+};
+
+/**
+ * @brief Clears all state and sizes the play area for the given screen
+ *
+ */
+void CoreGameInit(CoreGame *game, int screenWidth, int screenHeight);
+
+/**
+ * @brief Restarts the game's random number stream
+ *
+ * Two games with the same seed, level and inputs play out identically.
+ */
+void CoreGameSeed(CoreGame *game, uint64_t seed);
+
+/**
+ * @brief Lets the game spread ball movement over a set of threads
+ *
+ * The outcome is identical with or without workers. One set may be shared
+ * by games stepped one at a time, and must outlive them; pass NULL to go
+ * back to a single thread. CoreGameInit() clears it.
+ */
+void CoreGameSetWorkers(CoreGame *game, CoreWorkers *workers);
+
+/**
+ * @brief Loads a level and restores the full set of lives
+ *
+ */
+bool CoreGameNewLevel(CoreGame *game, const char *filename);
+
+/**
+ * @brief Sets up a level built in memory, as CoreGameNewLevel() does from a file
+ *
+ * @param blocks level file characters, row by row
+ */
+void CoreGameSetLevel(CoreGame *game, const char *name, int timeRemaining,
+                      const char blocks[CORE_ROW_MAX][CORE_COL_MAX]);
+
+/**
+ * @brief Spends a life: centers the paddle, puts a single new ball on it and enters MODE_PLAY
+ *
+ */
+void CoreGameStartLife(CoreGame *game);
+
+/**
+ * @brief Advances the game by dt seconds using the given controls
+ *
+ * Normally called with CORE_TICK_DT from a CoreClock loop.
+ * The paddle responds in every mode; the balls and countdown timer only run in MODE_PLAY.
+ */
+void CoreGameStep(CoreGame *game, const CoreInput *input, float dt);
+
+/**
+ * @brief Ball and paddle positions blended between the last two ticks
+ *
+ * @param alpha CoreClockAlpha() of the clock driving the game
+ */
+CoreVec2 CoreLerpBallPosition(const CoreGame *game, int ball, float alpha);
+float CoreLerpPaddlePosition(const CoreGame *game, float alpha);
+
+/**
+ * @brief Folds a frame's controls into input still waiting for a tick
+ *
+ * Presses are kept until a tick consumes them; held and pointer state take the newest value.
+ */
+void CoreInputMerge(CoreInput *pending, const CoreInput *frame);
+
+// Drops one-shot presses once a tick has seen them
+void CoreInputClearPresses(CoreInput *input);
+
+void CoreTimeDecrement(CoreGame *game, float dt);
+void CorePushEvent(CoreGame *game, CoreEventType type, SoundID sound);
+void CorePushBlockEvent(CoreGame *game, SoundID sound, int row, int col);
+void CoreClearEvents(CoreGame *game);
+
+// A bit (1 << CoreEventType) for each kind of event from events[from] on
+uint32_t CoreEventMask(const CoreGame *game, int from);
+
+#endif // _CORE_GAME_H_
@@ -0,0 +1,32 @@
+#ifndef _CORE_HASH_H_
+#define _CORE_HASH_H_
+
+/*
+ * Fingerprints of the game state, cheap enough to take every tick. Two
+ * games that hash the same have the same balls, paddle, blocks, timer,
+ * lives and random state, so comparing hashes tick by tick shows where two
+ * runs of one replay first part ways.
+ *
+ * Only state that carries into the next tick is covered: not the positions
+ * kept for interpolation, the events, or the level name.
+ */
+
+#include <stdint.h>
+
+#include "core/core_game.h"
+
+typedef enum {
+    HASH_BALLS,     // the live part of the pool, sticky and the launch guide
+    HASH_PADDLE,
+    HASH_BLOCKS,    // active, solid, type and hits left
+    HASH_RULES,     // tick, random state, timer, lives and mode
+    HASH_PART_COUNT
+} HASH_PARTS;
+
+uint64_t CoreHashPart(const CoreGame *game, HASH_PARTS part);
+const char *CoreHashPartName(HASH_PARTS part);
+
+// All the parts in one
+uint64_t CoreGameHash(const CoreGame *game);
+
+#endif // _CORE_HASH_H_
@@ -0,0 +1,72 @@
+#ifndef _CORE_JOBS_H_
+#define _CORE_JOBS_H_
+
+/*
+ * Background jobs with dependencies. Ready jobs wait in one queue, oldest
+ * first, for whichever thread is free. Jobs marked CORE_JOB_MAIN only ever
+ * run on the thread that created the system (for raylib, which uploads to
+ * the GPU from that thread alone), inside CoreJobsWait() or
+ * CoreJobsRunMain().
+ *
+ * Meant for coarse work such as decoding a file at startup. Work split over
+ * every ball or every game goes to CoreWorkers instead.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CORE_MAX_JOBS 1024      // jobs submitted and not yet finished
+
+typedef struct CoreJobs CoreJobs;
+
+// 0 is never a job, so it can mean "none" in dependency lists
+typedef uint32_t CoreJob;
+
+typedef void (*CoreJobFn)(void *data);
+
+typedef enum {
+    CORE_JOB_ANY  = 0,
+    CORE_JOB_MAIN = 1 << 0      // run on the creating thread only
+} CORE_JOB_FLAGS;
+
+/**
+ * @brief Starts threadCount - 1 worker threads; the calling thread becomes the main thread
+ *
+ * @param threadCount total threads including the caller, 0 for one per CPU
+ * @return NULL if the threads could not be started
+ */
+CoreJobs *CoreJobsCreate(int threadCount);
+
+// Jobs still queued are dropped, so wait for anything that matters first
+void CoreJobsDestroy(CoreJobs *jobs);
+int CoreJobsThreadCount(const CoreJobs *jobs);
+
+/**
+ * @brief Queues fn(data) to run once every job in after has finished
+ *
+ * Finished jobs and 0 entries in after are skipped. fn may be NULL for a job
+ * that only joins others. Jobs can add more jobs. When CORE_MAX_JOBS are
+ * outstanding the caller helps run them until a slot frees up.
+ *
+ * @return the job, or 0 if it could not be recorded
+ */
+CoreJob CoreJobsAdd(CoreJobs *jobs, CoreJobFn fn, void *data, const CoreJob *after, int afterCount, unsigned flags);
+
+bool CoreJobsDone(const CoreJobs *jobs, CoreJob job);
+
+/**
+ * @brief Runs queued jobs on this thread until job has finished
+ *
+ * On the main thread this includes CORE_JOB_MAIN jobs.
+ */
+void CoreJobsWait(CoreJobs *jobs, CoreJob job);
+
+/**
+ * @brief Runs the CORE_JOB_MAIN jobs that are ready, without waiting for more
+ *
+ * Call once a frame from the main thread while jobs run in the background.
+ * @return the number run
+ */
+int CoreJobsRunMain(CoreJobs *jobs);
+
+#endif // _CORE_JOBS_H_
@@ -0,0 +1,70 @@
+#ifndef _CORE_PADDLE_H_
+#define _CORE_PADDLE_H_
+
+#include <stdbool.h>
+
+#include "core/core_types.h"
+
+#define PADDLE_NONE		0
+#define PADDLE_LEFT		1
+#define PADDLE_RIGHT	2
+
+#define DIST_BASE   	30
+
+#define SIZE_UP         1
+#define SIZE_DOWN       2
+
+#define CORE_PADDLE_COUNT  3
+#define CORE_PADDLE_HEIGHT 15
+
+typedef struct CorePaddle {
+    int index;      // 0 small, 1 medium, 2 huge
+    float position; // upper left x, kept sub-pixel
+    bool reverse;
+} CorePaddle;
+
+
+/**
+ * @brief Sets the paddle to the default size, turns off Reverse, and centers the paddle on the screen
+ *
+ */
+void CoreResetPaddle(CoreGame *game);
+
+
+/**
+ * @brief Moves the paddle horizontally.
+ *
+ * The paddle will move horizontally PADDLE_VEL * dt pixels based on the direction passed.
+ * The direction moved takes into account the current value of the Reverse flag.
+ *
+ * @param direction PADDLE_LEFT, PADDLE_RIGHT or PADDLE_NONE to only clamp
+ */
+void CoreMovePaddle(CoreGame *game, int direction, float dt);
+
+
+/**
+ * @brief Places the paddle at x, clamped to the play area
+ *
+ */
+void CoreSetPaddlePosition(CoreGame *game, float x);
+
+
+/**
+ * @brief Changes the size of the paddle
+ *
+ * Increases or decreases the size of the paddle by one increment.
+ * Does nothing if paddle is at the maximum or minimum size
+ *
+ * @param changeDirection SIZE_UP or SIZE_DOWN
+ */
+void CoreChangePaddleSize(CoreGame *game, int changeDirection);
+
+void CoreToggleReverse(CoreGame *game);
+
+int CorePaddleSize(const CoreGame *game);
+const char *CorePaddleDescription(const CoreGame *game);
+int CorePaddlePositionY(const CoreGame *game);
+CoreRect CorePaddleCollisionRec(const CoreGame *game);
+CoreVec2 CoreBallSpawnPointOnPaddle(const CoreGame *game);
+
+#endif // _CORE_PADDLE_H_
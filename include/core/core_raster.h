@@ -0,0 +1,44 @@
+#ifndef _CORE_RASTER_H_
+#define _CORE_RASTER_H_
+
+/*
+ * A small picture of the game for bots and analysis, drawn on the CPU
+ * into a buffer the caller owns. Each pixel holds what is there (wall,
+ * block, paddle, ball, ...) straight from the grid and ball state, with no
+ * textures and no allocation; an 84x105 frame takes a few microseconds.
+ *
+ * The whole screen is scaled to the buffer, so anything drawn covers at
+ * least the pixels its rectangle touches and a ball is never lost between
+ * pixels. The paddle is drawn over the blocks, and the balls over both.
+ */
+
+#include <stdint.h>
+
+#include "core/core_game.h"
+
+#define CORE_RASTER_WIDTH  84     // a usual size, the window shrunk about 6.85 times each way
+#define CORE_RASTER_HEIGHT 105
+
+typedef enum {
+    RASTER_EMPTY,
+    RASTER_WALL,            // outside the play area
+    RASTER_BLOCK,           // one hit left
+    RASTER_BLOCK_HARD,      // more than one hit left
+    RASTER_BLOCK_SPECIAL,   // does something when destroyed
+    RASTER_BLOCK_SOLID,     // cannot be destroyed
+    RASTER_PADDLE,
+    RASTER_BALL,
+    RASTER_KIND_COUNT
+} RASTER_KINDS;
+
+// Gray levels for the kinds, darkest for empty space
+extern const uint8_t CoreRasterGray[RASTER_KIND_COUNT];
+
+/**
+ * @brief Draws game into pixels, width * height bytes, row by row from the top left
+ *
+ * @param palette the byte to write for each RASTER_KINDS, or NULL to write the kinds themselves
+ */
+void CoreRasterize(const CoreGame *game, uint8_t *pixels, int width, int height, const uint8_t *palette);
+
+#endif // _CORE_RASTER_H_
@@ -0,0 +1,100 @@
+#ifndef _CORE_REAL_H_
+#define _CORE_REAL_H_
+
+/*
+ * Number type for ball motion. Normally a float; building with
+ * CORE_FIXED_POINT defined makes it a 64-bit integer with 16 fraction
+ * bits, so every ball update is integer arithmetic and gives bit-identical
+ * results on any compiler, optimizer setting and CPU.
+ *
+ * Angles are whole fractions of a turn and trig comes from a fixed table in
+ * both builds, so neither one depends on the C library's sin/cos.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifdef CORE_FIXED_POINT
+
+typedef int64_t CoreReal;
+
+#define REAL_FRACTION_BITS 16
+#define REAL_ONE ((CoreReal)1 << REAL_FRACTION_BITS)
+#define REAL_MAX INT64_MAX
+
+// compile time constant from a decimal number, rounded to nearest
+#define REAL_C(x) ((CoreReal)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+static inline CoreReal RealFromFloat(float v) {
+    return (CoreReal)floor((double)v * 65536.0 + 0.5);
+}
+
+static inline float RealToFloat(CoreReal v) {
+    return (float)v / 65536.0f;
+}
+
+static inline CoreReal RealFromInt(int v) {
+    return (CoreReal)v * REAL_ONE;
+}
+
+// split a so the full product never needs more than 64 bits
+static inline CoreReal RealMul(CoreReal a, CoreReal b) {
+    CoreReal whole = a / REAL_ONE;
+    CoreReal fraction = a - whole * REAL_ONE;
+    return whole * b + (fraction * b) / REAL_ONE;
+}
+
+static inline CoreReal RealDiv(CoreReal a, CoreReal b) {
+    return (a * REAL_ONE) / b;
+}
+
+// a must be below 2^31 (about 32000.0 squared pixels)
+CoreReal RealSqrt(CoreReal a);
+
+#else
+
+typedef float CoreReal;
+
+#define REAL_ONE 1.0f
+#define REAL_MAX INFINITY
+#define REAL_C(x) ((float)(x))
+
+static inline CoreReal RealFromFloat(float v) { return v; }
+static inline float RealToFloat(CoreReal v) { return v; }
+static inline CoreReal RealFromInt(int v) { return (float)v; }
+static inline CoreReal RealMul(CoreReal a, CoreReal b) { return a * b; }
+static inline CoreReal RealDiv(CoreReal a, CoreReal b) { return a / b; }
+static inline CoreReal RealSqrt(CoreReal a) { return sqrtf(a); }
+
+#endif // CORE_FIXED_POINT
+
+static inline CoreReal RealMin(CoreReal a, CoreReal b) { return (a < b) ? a : b; }
+static inline CoreReal RealMax(CoreReal a, CoreReal b) { return (a > b) ? a : b; }
+static inline CoreReal RealAbs(CoreReal a) { return (a < 0) ? -a : a; }
+static inline CoreReal RealHalf(CoreReal a) { return a / 2; }
+
+typedef struct CoreRealRect {
+    CoreReal x;
+    CoreReal y;
+    CoreReal width;
+    CoreReal height;
+} CoreRealRect;
+
+// Angle in 1/ANGLE_TURN of a full turn, counter-clockwise from +x
+typedef int32_t CoreAngle;
+
+#define ANGLE_TURN 65536
+#define ANGLE_DEGREES(d) ((CoreAngle)((d) * ANGLE_TURN / 360))
+
+CoreReal CoreSin(CoreAngle angle);
+CoreReal CoreCos(CoreAngle angle);
+float CoreAngleRadians(CoreAngle angle);
+
+// Turns the vector (x, y) counter-clockwise by angle
+void CoreRotate(CoreReal *x, CoreReal *y, CoreAngle angle);
+
+// Length of (x, y) computed without overflow in either build
+CoreReal CoreLength(CoreReal x, CoreReal y);
+
+#endif // _CORE_REAL_H_
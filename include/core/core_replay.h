@@ -0,0 +1,87 @@
+#ifndef _CORE_REPLAY_H_
+#define _CORE_REPLAY_H_
+
+/*
+ * Recorded sessions. A replay holds what a game started from (play area and
+ * random state, taken right after CoreGameInit()) and then, in order, every
+ * level loaded, every life started and the controls of every tick. Played
+ * back it gives the same game, tick for tick, on any machine running a
+ * build with the same CoreReal and block types.
+ *
+ * The file is little-endian binary: a header, then entries of one tag byte.
+ * Ticks with identical controls are stored once with a repeat count, so a
+ * held key costs a few bytes however long it is held.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/core_game.h"
+
+#define CORE_REPLAY_VERSION 1
+
+typedef struct CoreRecorder {
+    FILE *file;
+    CoreInput run;          // controls of the ticks not yet written
+    uint32_t runLength;
+    bool failed;            // a write went wrong; the file is incomplete
+} CoreRecorder;
+
+/**
+ * @brief Starts recording game to a new file
+ *
+ * Call right after CoreGameInit() and CoreGameSeed(), before the first level.
+ */
+bool CoreRecorderOpen(CoreRecorder *recorder, const char *filename, const CoreGame *game);
+
+// Call alongside the matching game calls, in the order they happen
+void CoreRecorderLevel(CoreRecorder *recorder, const char *filename);   // CoreGameNewLevel()
+void CoreRecorderLife(CoreRecorder *recorder);                          // CoreGameStartLife()
+void CoreRecorderQuit(CoreRecorder *recorder);                          // the player gave up
+void CoreRecorderTick(CoreRecorder *recorder, const CoreInput *input);  // CoreGameStep()
+
+// Finishes the file; false if any of it could not be written
+bool CoreRecorderClose(CoreRecorder *recorder);
+
+
+typedef struct CoreReplay {
+    int screenWidth;
+    int screenHeight;
+    uint64_t rngState;
+    bool fixedPoint;            // recorded by a CORE_FIXED_POINT build
+    unsigned long long ticks;   // in the whole replay
+
+    unsigned char *data;        // the entries
+    size_t size;
+    size_t position;            // next entry to read
+    CoreInput input;            // controls of the current run
+    uint32_t repeat;            // ticks left in it
+} CoreReplay;
+
+/**
+ * @brief Reads a replay file
+ *
+ * A file cut short, say by a crash while recording, plays up to its last whole entry.
+ * @return false if the file cannot be read or is not a replay this build can play
+ */
+bool CoreReplayLoad(CoreReplay *replay, const char *filename);
+void CoreReplayFree(CoreReplay *replay);
+
+/**
+ * @brief Resets game to how the recording started and plays up to the first tick
+ *
+ * Can be called again to play the replay from the top. Like CoreGameInit(),
+ * it clears the game's workers.
+ * @return false if a recorded level could not be loaded
+ */
+bool CoreReplayStart(CoreReplay *replay, CoreGame *game);
+
+/**
+ * @brief Steps game one recorded tick, then plays what happened before the next one
+ *
+ * @return false once the replay has no ticks left (game is untouched)
+ */
+bool CoreReplayStep(CoreReplay *replay, CoreGame *game);
+
+#endif // _CORE_REPLAY_H_
@@ -0,0 +1,62 @@
+#ifndef _CORE_REWIND_H_
+#define _CORE_REWIND_H_
+
+/*
+ * The last stretch of a level, kept so play can be wound back. After each
+ * tick the state is captured into a fixed ring of bytes: a full keyframe
+ * about once a second, and in between only what changed since the tick
+ * before (the scalar game fields, ball fields, active rows and hit
+ * counters that differ). With one ball a tick takes about 50 bytes, so
+ * the default 2 MB holds over a minute at 240 Hz; with many balls it holds
+ * less, as the oldest seconds are dropped to make room.
+ *
+ * Nothing is allocated after CoreRewindCreate(). Block types, layout and
+ * hitboxes are not kept, so the buffer covers one level: clear it whenever
+ * another level is loaded.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/core_game.h"
+
+#define CORE_REWIND_BYTES     (2u << 20)
+#define CORE_REWIND_KEY_TICKS CORE_TICK_RATE    // ticks between keyframes
+
+typedef struct CoreRewind CoreRewind;
+
+/**
+ * @brief Allocates a rewind buffer
+ *
+ * @param bytes size of the ring, 0 for CORE_REWIND_BYTES; raised if too small to hold a full game
+ */
+CoreRewind *CoreRewindCreate(size_t bytes);
+void CoreRewindDestroy(CoreRewind *rewind);
+
+// Forgets every captured tick
+void CoreRewindClear(CoreRewind *rewind);
+
+/**
+ * @brief Captures the game as it is after a tick
+ *
+ * Ticks need not be consecutive, but must increase; capturing an earlier
+ * tick than the newest clears the buffer first.
+ */
+void CoreRewindCapture(CoreRewind *rewind, const CoreGame *game);
+
+/**
+ * @brief Puts game back to the newest captured tick at or before tick
+ *
+ * Earlier ticks than the buffer holds give the oldest one. The ticks after
+ * the one restored are dropped, as play carries on from there. Events are
+ * cleared and interpolation starts from the restored positions.
+ * @return false if nothing has been captured (game is untouched)
+ */
+bool CoreRewindTo(CoreRewind *rewind, CoreGame *game, unsigned long long tick);
+
+// The range of ticks held; both 0 when empty
+unsigned long long CoreRewindOldest(const CoreRewind *rewind);
+unsigned long long CoreRewindNewest(const CoreRewind *rewind);
+size_t CoreRewindBytesUsed(const CoreRewind *rewind);
+
+#endif // _CORE_REWIND_H_
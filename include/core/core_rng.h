@@ -0,0 +1,33 @@
+#ifndef _CORE_RNG_H_
+#define _CORE_RNG_H_
+
+/*
+ * Seeded random numbers for the simulation. Each game owns its generator,
+ * so two games started from the same seed and fed the same input make the
+ * same choices, whatever else the process calls rand() for.
+ */
+
+#include <stdint.h>
+
+typedef struct CoreRng {
+    uint64_t state;
+} CoreRng;
+
+void CoreRngSeed(CoreRng *rng, uint64_t seed);
+uint32_t CoreRngNext(CoreRng *rng);
+
+// Two draws, the first for the high half, in that order on every compiler
+uint64_t CoreRngNext64(CoreRng *rng);
+
+/**
+ * @brief Seeds one of many independent generators from a shared seed
+ *
+ * Streams are told apart by number, so work split across threads can draw
+ * its own numbers without the result depending on who ran first.
+ */
+void CoreRngStream(CoreRng *rng, uint64_t seed, uint32_t stream);
+
+// 0 .. count - 1
+int CoreRngRange(CoreRng *rng, int count);
+
+#endif // _CORE_RNG_H_
@@ -0,0 +1,57 @@
+#ifndef _CORE_RUN_H_
+#define _CORE_RUN_H_
+
+/*
+ * Plays a level without a frontend. Controls come from a callback once a
+ * tick; when a ball is lost the next life starts straight away, and the run
+ * is over when the level is cleared or the last life is gone.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_game.h"
+
+// Fills the controls for the tick about to be stepped
+typedef void (*CoreInputFn)(void *context, const CoreGame *game, CoreInput *input);
+
+typedef struct CoreRunStats {
+    unsigned long long ticks;
+    int livesLost;
+    int blockHits;
+    int paddleHits;
+    uint16_t blocksHit[CORE_ROW_MAX];   // cells hit at least once, a column mask per row
+    uint32_t tickEvents;                // CoreEventMask() of the last tick
+    bool cleared;
+} CoreRunStats;
+
+/**
+ * @brief Loads a level into game and starts its first life
+ *
+ * The game must have been through CoreGameInit(); its seed is kept.
+ */
+bool CoreRunStart(CoreGame *game, const char *levelFile, CoreRunStats *stats);
+
+/**
+ * @brief Steps one tick with controls from input, then starts the next life if the ball was lost
+ *
+ * Events are counted into stats and cleared.
+ * @return false once the run is over (stats->cleared tells how)
+ */
+bool CoreRunStep(CoreGame *game, CoreInputFn input, void *context, CoreRunStats *stats);
+
+/**
+ * @brief Plays out the level just loaded into game, as one of many seeded games
+ *
+ * Seeds game from the numbered stream of seed, starts its first life and
+ * steps it with controls from input until the run is over or maxTicks
+ * ticks have been played. The level must have been put in place with
+ * CoreGameNewLevel() or CoreGameSetLevel(), and nothing played since.
+ */
+void CoreRunGame(CoreGame *game, uint64_t seed, uint32_t stream, unsigned long long maxTicks,
+                 CoreInputFn input, void *context, CoreRunStats *stats);
+
+// Adds game's pending events to stats, for callers stepping the game themselves
+void CoreRunCountEvents(const CoreGame *game, CoreRunStats *stats);
+
+#endif // _CORE_RUN_H_
@@ -0,0 +1,74 @@
+#ifndef _CORE_SAVE_H_
+#define _CORE_SAVE_H_
+
+/*
+ * Saved games. A save holds everything needed to carry on playing: the
+ * board (each block's type, whether it is still in play and its hits
+ * left), every ball, the paddle, the timer, lives and the random state,
+ * with the level file it came from so the next level can follow.
+ *
+ * The file is little-endian binary with a version and a checksum. Ball
+ * motion is stored as the saving build's CoreReal and converted when a
+ * build with the other kind loads it. Hitboxes come from the block types
+ * when the save is restored, so the block types should match.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/core_game.h"
+
+#define CORE_SAVE_VERSION   1
+#define CORE_SAVE_NAME_MAX  1024    // level file names, with the terminator
+#define CORE_SAVE_MAX_BYTES (2048 + CORE_SAVE_NAME_MAX + CORE_MAX_BALLS * 64)
+
+// An encoded game, ready to write or restore
+typedef struct CoreSave {
+    size_t size;
+    unsigned char data[CORE_SAVE_MAX_BYTES];
+} CoreSave;
+
+/**
+ * @brief Encodes game, which was loaded from levelFile
+ *
+ * @return false if levelFile is too long to store
+ */
+bool CoreSaveCapture(CoreSave *save, const CoreGame *game, const char *levelFile);
+
+/**
+ * @brief Writes a save to a file
+ *
+ * The file is written under another name and then renamed over the old
+ * one, so a crash part way leaves the last save whole.
+ */
+bool CoreSaveWrite(const CoreSave *save, const char *filename);
+
+// Reads a save file; false if it is missing, damaged or from a newer version
+bool CoreSaveRead(CoreSave *save, const char *filename);
+
+/**
+ * @brief Puts game in the state the save holds
+ *
+ * The save is checked in full first, and game is untouched if it does not
+ * hold a valid game. The game keeps its workers.
+ * @param levelFile receives the level file it came from, may be NULL
+ */
+bool CoreSaveRestore(const CoreSave *save, CoreGame *game, char *levelFile, size_t levelFileSize);
+
+
+/*
+ * Saves written on a thread of their own. Submitting encodes the game,
+ * which takes microseconds, and leaves the writing to the thread; if saves
+ * come faster than the disk takes them, only the newest is written.
+ * Submit from one thread at a time.
+ */
+typedef struct CoreAutosave CoreAutosave;
+
+// NULL if the thread could not be started
+CoreAutosave *CoreAutosaveStart(const char *filename);
+void CoreAutosaveSubmit(CoreAutosave *autosave, const CoreGame *game, const char *levelFile);
+
+// Writes anything still waiting and stops the thread; false if any save failed to write
+bool CoreAutosaveStop(CoreAutosave *autosave);
+
+#endif // _CORE_SAVE_H_
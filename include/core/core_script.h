@@ -0,0 +1,46 @@
+#ifndef _CORE_SCRIPT_H_
+#define _CORE_SCRIPT_H_
+
+/*
+ * Controls read from a text file, one per line, for headless runs:
+ *
+ *     # tick   action  [x]
+ *     0        release
+ *     240      left
+ *     300      stop
+ *     480      moveto  250
+ *
+ * Ticks count from CoreGameInit() and must not go backwards. Actions are
+ * release, reverse, grow and shrink (pressed once), left, right and stop
+ * (held until the next of them), and moveto x (places the paddle once).
+ */
+
+#include <stdbool.h>
+
+#include "core/core_game.h"
+
+typedef struct CoreScriptLine {
+    unsigned long long tick;
+    int action;
+    float x;
+} CoreScriptLine;
+
+typedef struct CoreScript {
+    CoreScriptLine *lines;
+    int count;
+    int next;           // first line not yet played
+    int paddleMove;     // held since the last left, right or stop
+} CoreScript;
+
+/**
+ * @brief Reads a script, reporting bad lines on stderr
+ *
+ * @return false if the file could not be read or had errors; script is left empty
+ */
+bool CoreScriptLoad(CoreScript *script, const char *filename);
+void CoreScriptFree(CoreScript *script);
+
+// A CoreInputFn; context is the CoreScript
+void CoreScriptInput(void *context, const CoreGame *game, CoreInput *input);
+
+#endif // _CORE_SCRIPT_H_
@@ -0,0 +1,47 @@
+#ifndef _CORE_SIMD_H_
+#define _CORE_SIMD_H_
+
+/*
+ * Batched box overlap test. Boxes are passed as separate left, top, right
+ * and bottom arrays so a whole row is compared a vector at a time. The
+ * widest version the CPU supports (AVX2, SSE2, or plain C) is chosen on
+ * first use.
+ *
+ * Boxes that only touch along an edge count as overlapping, so it can
+ * cull candidates for the swept test without missing a grazing contact.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_types.h"
+
+// boxes per row test; rows are padded to this many entries
+#define CORE_SIMD_ROW 16
+
+typedef enum {
+    CORE_SIMD_SCALAR,
+    CORE_SIMD_SSE2,
+    CORE_SIMD_AVX2
+} CoreSimdLevel;
+
+/**
+ * @brief Tests one box against a padded row of CORE_SIMD_ROW boxes
+ *
+ * @return bit i set if box overlaps entry i
+ */
+uint32_t CoreOverlapRow(CoreRect box, const float *left, const float *top, const float *right, const float *bottom);
+
+// Best level this CPU runs
+CoreSimdLevel CoreSimdBest(void);
+
+/**
+ * @brief Switches the kernel to one level, for benchmarks and comparison runs
+ *
+ * @return false, changing nothing, if the CPU cannot run that level
+ */
+bool CoreSimdUse(CoreSimdLevel level);
+
+const char *CoreSimdName(CoreSimdLevel level);
+
+#endif // _CORE_SIMD_H_
@@ -0,0 +1,97 @@
+#ifndef _CORE_SNAPSHOT_H_
+#define _CORE_SNAPSHOT_H_
+
+/*
+ * What a renderer needs from one tick of a game, copied out so it can be
+ * drawn on another thread while the simulation carries on. Snapshots are
+ * handed over through a triple buffer: the writer always has a slot to fill
+ * and the reader always has the newest finished one, and neither waits on
+ * the other. Events travel separately through a queue, so none are lost
+ * when the reader skips snapshots.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_game.h"
+
+typedef struct CoreSnapshot {
+    unsigned long long tick;
+    double time;                // CoreTimeNow() when published
+    GAME_MODES mode;
+    CorePlayArea playArea;
+
+    uint16_t active[CORE_ROW_MAX];
+    char type[CORE_ROW_MAX][CORE_COL_MAX];
+    uint8_t hits[CORE_ROW_MAX][CORE_COL_MAX];
+    CoreRect hitbox[CORE_ROW_MAX][CORE_COL_MAX];
+    int blocksRemaining;
+
+    int ballCount;
+    CoreVec2 ballPosition[CORE_MAX_BALLS];
+    CoreVec2 ballPrevious[CORE_MAX_BALLS];    // before the last tick
+    uint8_t ballState[CORE_MAX_BALLS];
+    CoreAngle releaseAngle;
+
+    float paddlePosition;
+    float paddlePrevious;
+    int paddleY;
+    int paddleIndex;
+    bool reverse;
+
+    int livesRemaining;
+    int timeRemaining;
+} CoreSnapshot;
+
+/**
+ * @brief Copies the drawable state of game
+ *
+ * time is left for the caller to stamp.
+ */
+void CoreSnapshotCapture(CoreSnapshot *snapshot, const CoreGame *game);
+
+// Positions blended between the last two ticks, as CoreLerpBallPosition() does
+CoreVec2 CoreSnapshotBallPosition(const CoreSnapshot *snapshot, int ball, float alpha);
+float CoreSnapshotPaddlePosition(const CoreSnapshot *snapshot, float alpha);
+
+
+/*
+ * One writer thread, one reader thread. The slot in the middle is swapped
+ * atomically with whichever side is done with its own.
+ */
+typedef struct CoreSnapshotBuffer {
+    CoreSnapshot slots[3];
+    volatile int middle;    // slot between the two sides, plus SNAPSHOT_FRESH if unread
+    int back;               // the writer's
+    int front;              // the reader's
+} CoreSnapshotBuffer;
+
+void CoreSnapshotBufferInit(CoreSnapshotBuffer *buffer);
+
+// The writer's slot; fill it, then publish
+CoreSnapshot *CoreSnapshotWriteSlot(CoreSnapshotBuffer *buffer);
+void CoreSnapshotPublish(CoreSnapshotBuffer *buffer);
+
+/**
+ * @brief The newest published snapshot
+ *
+ * It stays valid and unchanged until the reader calls this again.
+ * @param fresh set to whether it differs from the last call's, may be NULL
+ */
+const CoreSnapshot *CoreSnapshotRead(CoreSnapshotBuffer *buffer, bool *fresh);
+
+
+#define CORE_EVENT_QUEUE_SIZE 256   // a power of two
+
+// Events from one thread to one other, dropped when the reader falls this far behind
+typedef struct CoreEventQueue {
+    CoreEvent events[CORE_EVENT_QUEUE_SIZE];
+    volatile int head;      // next to read, moved by the reader
+    volatile int tail;      // next to write, moved by the writer
+} CoreEventQueue;
+
+void CoreEventQueueInit(CoreEventQueue *queue);
+bool CoreEventQueuePush(CoreEventQueue *queue, const CoreEvent *event);
+bool CoreEventQueuePop(CoreEventQueue *queue, CoreEvent *event);
+
+#endif // _CORE_SNAPSHOT_H_
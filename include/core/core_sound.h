@@ -0,0 +1,64 @@
+/**
+ * @file core_sound.h
+ * @brief Sound identifiers shared by the simulation core and the audio system
+ *
+ * The core never plays audio itself; it reports a SoundID with each event and
+ * the frontend decides whether to play it.
+ */
+
+#ifndef _CORE_SOUND_H_
+#define _CORE_SOUND_H_
+
+#define SOUND_COUNT 46
+
+typedef enum {
+    SND_NONE = -1,  // no sound
+    SND_AMMO,
+    SND_APPLAUSE,
+    SND_BALL2BALL,
+    SND_BALLLOST,
+    SND_BALLSHOT,
+    SND_BOING,
+    SND_BOMB,
+    SND_BONUS,
+    SND_BUZZER,
+    SND_CLICK,
+    SND_DDLOO,
+    SND_DOH1,
+    SND_DOH2,
+    SND_DOH3,
+    SND_DOH4,
+    SND_EVILLAUGH,
+    SND_GAMEOVER,
+    SND_GATE,
+    SND_HITHERE,
+    SND_HYPSPC,
+    SND_INTRO,
+    SND_KEY,
+    SND_LOOKSBAD,
+    SND_METAL,
+    SND_MGUN,
+    SND_OUCH,
+    SND_PADDLE,
+    SND_PING,
+    SND_SHARK,
+    SND_SHOOT,
+    SND_SHOTGUN,
+    SND_SPRING,
+    SND_STAMP,
+    SND_STICKY,
+    SND_SUPBONS,
+    SND_TOGGLE,
+    SND_TONE,
+    SND_TOUCH,
+    SND_WALLSOFF,
+    SND_WARP,
+    SND_WEEEK,
+    SND_WHIZZO,
+    SND_WHOOSH,
+    SND_WZZZ,
+    SND_WZZZ2,
+    SND_YOUAGOD
+} SoundID;
+
+#endif // _CORE_SOUND_H_
@@ -0,0 +1,85 @@
+#ifndef _CORE_THREAD_H_
+#define _CORE_THREAD_H_
+
+/*
+ * The few threading primitives the core needs, over pthreads or Win32.
+ */
+
+#include <stdbool.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef HANDLE CoreThread;
+typedef CRITICAL_SECTION CoreMutex;
+typedef CONDITION_VARIABLE CoreCond;
+#else
+#include <pthread.h>
+typedef pthread_t CoreThread;
+typedef pthread_mutex_t CoreMutex;
+typedef pthread_cond_t CoreCond;
+#endif
+
+typedef void (*CoreThreadFn)(void *arg);
+
+bool CoreThreadStart(CoreThread *thread, CoreThreadFn fn, void *arg);
+void CoreThreadJoin(CoreThread thread);
+
+// logical processors available to this process, at least 1
+int CoreCpuCount(void);
+
+// seconds on a monotonic clock, for measuring intervals
+double CoreTimeNow(void);
+void CoreSleep(double seconds);
+
+void CoreMutexInit(CoreMutex *mutex);
+void CoreMutexDestroy(CoreMutex *mutex);
+void CoreMutexLock(CoreMutex *mutex);
+void CoreMutexUnlock(CoreMutex *mutex);
+
+void CoreCondInit(CoreCond *cond);
+void CoreCondDestroy(CoreCond *cond);
+void CoreCondWait(CoreCond *cond, CoreMutex *mutex);
+void CoreCondSignal(CoreCond *cond);
+void CoreCondBroadcast(CoreCond *cond);
+
+#if defined(_MSC_VER)
+#define CORE_THREAD_LOCAL __declspec(thread)
+#else
+#define CORE_THREAD_LOCAL _Thread_local
+#endif
+
+// returns the value before adding
+static inline int CoreAtomicAdd(volatile int *value, int add) {
+#if defined(_MSC_VER)
+    return _InterlockedExchangeAdd((volatile long *)value, add);
+#else
+    return __atomic_fetch_add(value, add, __ATOMIC_ACQ_REL);
+#endif
+}
+
+static inline int CoreAtomicLoad(volatile int *value) {
+#if defined(_MSC_VER)
+    return _InterlockedOr((volatile long *)value, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void CoreAtomicStore(volatile int *value, int store) {
+#if defined(_MSC_VER)
+    _InterlockedExchange((volatile long *)value, store);
+#else
+    __atomic_store_n(value, store, __ATOMIC_RELEASE);
+#endif
+}
+
+// returns the value replaced
+static inline int CoreAtomicExchange(volatile int *value, int store) {
+#if defined(_MSC_VER)
+    return _InterlockedExchange((volatile long *)value, store);
+#else
+    return __atomic_exchange_n(value, store, __ATOMIC_ACQ_REL);
+#endif
+}
+
+#endif // _CORE_THREAD_H_
@@ -0,0 +1,34 @@
+#ifndef _CORE_TYPES_H_
+#define _CORE_TYPES_H_
+
+/*
+ * Plain geometry types used by the simulation core. They mirror the layout of
+ * raylib's Vector2 and Rectangle so the renderer can convert them field by
+ * field, but the core itself never includes raylib.h.
+ */
+
+#include <stdbool.h>
+
+#define CORE_PI 3.14159265358979323846f
+
+typedef struct CoreVec2 {
+    float x;
+    float y;
+} CoreVec2;
+
+typedef struct CoreRect {
+    float x;
+    float y;
+    float width;
+    float height;
+} CoreRect;
+
+typedef struct CoreGame CoreGame;
+
+// same test as raylib's CheckCollisionRecs()
+static inline bool CoreRectOverlap(CoreRect a, CoreRect b) {
+    return (a.x < b.x + b.width) && (a.x + a.width > b.x) &&
+           (a.y < b.y + b.height) && (a.y + a.height > b.y);
+}
+
+#endif // _CORE_TYPES_H_
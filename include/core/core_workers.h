@@ -0,0 +1,35 @@
+#ifndef _CORE_WORKERS_H_
+#define _CORE_WORKERS_H_
+
+/*
+ * A fixed set of threads that split a range of items between them. The
+ * calling thread works too, and CoreWorkersRun() returns once every item
+ * is done, so callers see a plain function call.
+ */
+
+#include <stdbool.h>
+
+typedef struct CoreWorkers CoreWorkers;
+
+// Handles items [begin, end); worker is 0 for the calling thread, else 1..count-1
+typedef void (*CoreRangeFn)(void *context, int worker, int begin, int end);
+
+/**
+ * @brief Starts threadCount - 1 helper threads
+ *
+ * @param threadCount total threads including the caller, 0 for one per CPU
+ * @return NULL if the threads could not be started
+ */
+CoreWorkers *CoreWorkersCreate(int threadCount);
+void CoreWorkersDestroy(CoreWorkers *workers);
+int CoreWorkersCount(const CoreWorkers *workers);
+
+/**
+ * @brief Runs fn over items 0..count-1 in batches of grain and waits for all of them
+ *
+ * Batches go to whichever thread is free, so fn must not depend on which
+ * worker handles which items.
+ */
+void CoreWorkersRun(CoreWorkers *workers, int count, int grain, CoreRangeFn fn, void *context);
+
+#endif // _CORE_WORKERS_H_
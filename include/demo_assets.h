@@ -0,0 +1,28 @@
+#ifndef _DEMO_ASSETS_H_
+#define _DEMO_ASSETS_H_
+
+/*
+ * Loads files on the job system: the decode runs on any thread and the
+ * upload to the GPU or audio device follows on the main thread. With no
+ * jobs the load happens before the call returns.
+ */
+
+#include <raylib.h>
+#include <stdbool.h>
+
+#include "core/core_jobs.h"
+
+/**
+ * @brief Fills *texture from an image file once the returned job finishes
+ *
+ * texture->id stays 0 if the file could not be read.
+ */
+CoreJob LoadTextureJob(CoreJobs *jobs, const char *fileName, Texture2D *texture);
+
+// As LoadTextureJob(), for a sound; sound->frameCount stays 0 on failure
+CoreJob LoadSoundJob(CoreJobs *jobs, const char *fileName, Sound *sound);
+
+// Waits for every job in the list, running queued work meanwhile
+void WaitForJobs(CoreJobs *jobs, const CoreJob *list, int count);
+
+#endif // _DEMO_ASSETS_H_
@@ -3,16 +3,13 @@
 
 #include <stdbool.h>
 
-#include "paddle.h"
+#include "core/core_game.h"
+#include "core/core_jobs.h"
+#include "core/core_snapshot.h"
 
-bool InitializeBall(void);
-void ResetBall(void);
+bool InitializeBall(CoreJobs *jobs);
 void FreeBall(void);
-void MoveBall(void);
-void DrawBall(void);
-void ReleaseBall(void);
-void SetBallSticky(void);
-void IncreaseBallSpeed(void);
+void DrawBalls(const CoreSnapshot *snapshot, float alpha);
 
 
-#endif // _DEMO_BALL_H_
\ No newline at end of file
+#endif // _DEMO_BALL_H_
@@ -27,5 +27,7 @@ bool IsInputPaddleRight(void);
 bool IsInputQuitGame(void);
 bool IsInputReleaseBall(void);
 bool IsInputRestartAfterEnd(void);
+bool IsInputRewind(void);
+bool IsInputRetry(void);
 
 #endif // _DEMO_CONTROLS_H_
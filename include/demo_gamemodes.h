@@ -1,22 +1,63 @@
 #ifndef _DEMO_GAMEMODES_H_
 #define _DEMO_GAMEMODES_H_
 
-typedef enum {
-    MODE_INITGAME,
-    MODE_PLAY,
-    MODE_WIN,
-    MODE_LOSE,
-    MODE_CANCEL,
-    MODE_EXIT
-} GAME_MODES;
+#include <stdbool.h>
+
+#include "core/core_game.h"
+#include "core/core_replay.h"
+#include "core/core_rewind.h"
+#include "core/core_save.h"
+#include "core/core_dataset.h"
+
+// only use the game directly while the sim thread is stopped
+CoreGame *GetGame(void);
 
 GAME_MODES GetGameMode(void);
 void SetGameMode(GAME_MODES mode);
+float GetPaddlePosition(void);
+
+/**
+ * @brief Saves every level, life and tick of controls from here on
+ *
+ * Set straight after CoreGameInit(), and back to NULL before closing the recorder.
+ */
+void SetRecorder(CoreRecorder *recorder);
+
+// Plays the replay in place of the player's controls, from the next MODE_INITGAME
+void SetReplay(CoreReplay *replay);
+
+// Keeps recent play so it can be wound back (hold BACKSPACE) or retried after losing a ball
+void SetRewind(CoreRewind *buffer);
+
+// Saves the game every few seconds of play, and on SaveGameNow(); not while replaying
+void SetAutosave(CoreAutosave *autosave);
+void SaveGameNow(void);
+
+// Writes every tick played, and the controls that drove it, to the dataset; not while replaying
+void SetDataset(CoreDatasetWriter *writer);
+
+/**
+ * @brief Carries on the game a save holds, in place of the next MODE_INITGAME
+ *
+ * Call after CoreGameInit(). Winning moves on from the level the save came from.
+ * @return false if the save does not hold a valid game (the game is untouched)
+ */
+bool ResumeGame(const CoreSave *save);
+
+/**
+ * @brief Moves stepping the game to its own thread, at the tick rate
+ *
+ * Frames then draw the newest published snapshot, so a slow frame no
+ * longer holds up the simulation.
+ * @return false if the thread could not be started (the game keeps stepping per frame)
+ */
+bool StartSimThread(void);
+void StopSimThread(void);
 
 void RunInitGameMode(const char *fileName);
-void RunPlayMode(void);
-void RunEndMode(void);
+void RunPlayMode(const CoreInput *input);
+void RunEndMode(const CoreInput *input);
 
 
 
-#endif // _DEMO_GAMEMODES_H_
\ No newline at end of file
+#endif // _DEMO_GAMEMODES_H_
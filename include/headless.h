@@ -0,0 +1,40 @@
+#ifndef _HEADLESS_H_
+#define _HEADLESS_H_
+
+/*
+ * Runs a level with no window and no audio device, for testing and
+ * benchmarking. The paddle is driven by the bot or by a script file.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct HeadlessOptions {
+    bool enabled;               // --headless
+    bool turbo;                 // --turbo: step as fast as possible instead of at the tick rate
+    const char *scriptFile;     // --script <file>; NULL plays with the bot
+    uint64_t seed;              // --seed <n>
+    bool seeded;
+    unsigned long long maxTicks;    // --max-ticks <n>; 0 for the default limit
+    int threads;                // --threads <n>: move balls on a pool of n threads; 0 or 1 for none
+    const char *recordFile;     // save the session as a replay
+    const char *replayFile;     // play a replay instead of the level, bot or script
+    const char *datasetPrefix;  // write every tick to dataset shards with this prefix
+} HeadlessOptions;
+
+/**
+ * @brief Takes a headless option and its value from the command line
+ *
+ * @return how many arguments were used, 0 if arguments[i] is not a headless option, -1 if its value is missing or bad
+ */
+int TakeHeadlessOption(HeadlessOptions *options, int argumentCount, char *arguments[], int i);
+
+/**
+ * @brief Plays levelFile, or the replay, to the end and prints the result
+ *
+ * @param blockTypesFile extra block types, skipped if the file is absent
+ * @return the exit code for main
+ */
+int RunHeadless(const HeadlessOptions *options, const char *levelFile, const char *blockTypesFile);
+
+#endif // _HEADLESS_H_
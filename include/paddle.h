@@ -46,24 +46,20 @@
  * =========================================================================
  */
 
-#define PADDLE_NONE		0
-#define PADDLE_LEFT		1
-#define PADDLE_RIGHT	2
-
-#define DIST_BASE   	30
-
-#define SIZE_UP         1
-#define SIZE_DOWN       2
-
 #include <stdbool.h>
 
+#include "core/core_game.h"
+#include "core/core_jobs.h"
+#include "core/core_snapshot.h"
+
 
 /**
  * @brief Loads paddle images into memory as Raylib Texture2D
  * @note If an image fails to load, Raylib close window flag is set to true
  * 
+ * @param jobs decodes the images in parallel, or NULL to load them one by one
  */
-bool InitialisePaddle(void);
+bool InitialisePaddle(CoreJobs *jobs);
 
 
 /**
@@ -76,94 +72,8 @@ void FreePaddle(void);
 /**
  * @brief Draws the current paddle image at the current paddle position
  * 
+ * @param alpha how far between the last two ticks to draw, from CoreClockAlpha()
  */
-void DrawPaddle(void);
-
-
-/**
- * @brief Moves the paddle horizontally.
- * 
- * The paddle will move horizontally a fixed amount based on the direction passed. 
- * The direction moved takes into account the current value of the Reverse flag.
- * 
- * @param direction PADDLE_LEFT or PADDLE_RIGHT to move
- */
-void MovePaddle(int direction);
-
-
-/**
- * @brief Sets the paddle to the default size, turns off Reverse, and centers the paddle on the screen
- * 
- */
-void ResetPaddleStart(void);
-
-
-/**
- * @brief Returns the paddle size in pixels
- * 
- * @return int 
- */
-int GetPaddleSize(void);
-
-
-/**
- * @brief Returns the paddle size as a description
- * 
- * @return char* c-string description of size
- */
-char *GetPaddleDescription(void);
-
-
-/**
- * @brief Returns the paddle position based on upper left corner
- * 
- * @return int upper left paddle pixel
- */
-int GetPaddlePositionX(void);
-
-int GetPaddlePositionY(void);
-
-Rectangle GetPaddleCollisionRec(void);
-
-
-/**
- * @brief Returns the Reverse flag value
- * 
- * @return int 1 for reverse on, 0 for reverse off
- */
-int GetPaddleReverse(void);
-
-
-/**
- * @brief Flips the value of the reverse flag
- * 
- */
-void ToggleReverse(void);
-
-
-/**
- * @brief Turns reverse flag off
- * 
- */
-void SetReverseOff(void);
-
-
-/**
- * @brief Changes the size of the paddle
- * 
- * Increases or decreases the size of the paddle by one increment.
- * Does nothing if paddle is at the maximum or minimum size
- * 
- * @param changeDirection SIZE_UP or SIZE_DOWN
- */
-void ChangePaddleSize(int changeDirection);
-
-Vector2 GetBallSpawnPointOnPaddle();
-
-void SetPaddlePosition(float x);
-
-// not used in program ??
-// #define PADDLE_HC  		4
-// #define PADDLE_HEIGHT 	9
+void DrawPaddle(const CoreSnapshot *snapshot, float alpha);
 
 #endif
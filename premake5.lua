@@ -1,5 +1,10 @@
 local raylib = require "build_files.raylib"
 
+newoption {
+    trigger = "fixed-point",
+    description = "Integer ball physics: identical results on every compiler and CPU"
+}
+
 workspace "xboing"
     configurations { "Debug", "Release" }
 
@@ -7,6 +12,8 @@ workspace "xboing"
         symbols "On"
     filter "configurations:Release"
         optimize "On"
+    filter "options:fixed-point"
+        defines { "CORE_FIXED_POINT" }
     filter {}
 
     startproject "rayboing"
@@ -17,6 +24,8 @@ workspace "xboing"
         location "build_files"
         targetdir "bin/%{cfg.buildcfg}"
 
+        links { "xboing_core" }
+
         raylib.setup_project()
 
         includedirs { "include", "src" }
@@ -27,6 +36,164 @@ workspace "xboing"
         }
 
         files { "src/**.c", "include/**.h"}
+        removefiles { "src/core/**.c", "include/core/**.h" }
+
+    -- Game rules without raylib: ball, paddle, blocks and game modes.
+    -- Link this to simulate games without opening a window.
+    project "xboing_core"
+        kind "StaticLib"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+
+        includedirs { "include" }
+
+        vpaths {
+            ["Header Files/*"] = { "include/core/**.h" },
+            ["Source Files/*"] = { "src/core/**.c" }
+        }
+
+        files { "src/core/**.c", "include/core/**.h" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        -- no fused multiply-add, so float builds round the same with or without FMA hardware
+        filter "toolset:gcc or toolset:clang"
+            buildoptions { "-ffp-contract=off" }
+        filter {}
+
+    -- Timing for the collision kernels, ns per box test at each SIMD level, and for many-ball steps per thread count.
+    project "bench_collide"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/bench_collide.c" }
+
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
+
+    -- Plays a replay on several threads at once and reports where any run diverges.
+    project "verify_replay"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/verify_replay.c" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
+
+    -- Lets the bot play every level many times over and reports how hard each one is.
+    project "analyze_levels"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/analyze_levels.c", "tools/tools_common.c", "tools/tools_common.h" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
+
+    -- Draws candidate levels to a target difficulty and keeps the one the bot plays closest to it.
+    project "generate_levels"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/generate_levels.c", "tools/tools_common.c", "tools/tools_common.h" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
+
+    -- Splits every level x seed x strategy into shards and plays them on local or remote workers.
+    project "sweep"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/sweep.c", "tools/tools_common.c", "tools/tools_common.h" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        filter "system:windows"
+            links { "ws2_32" }
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
+
+    -- Plays and rasterizes a batch of games on one thread and on many, and checks they agree.
+    project "check_batch"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/check_batch.c" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
+
+    -- Runs dependency graphs, nested jobs and main-thread uploads through the job system.
+    project "check_jobs"
+        kind "ConsoleApp"
+        language "C"
+        location "build_files"
+        targetdir "bin/%{cfg.buildcfg}"
+        debugdir "."
+
+        links { "xboing_core" }
+        includedirs { "include" }
+
+        files { "tools/check_jobs.c" }
+
+        filter "action:vs*"
+            defines { "_CRT_SECURE_NO_WARNINGS" }
+        filter "system:linux"
+            links { "m", "pthread" }
+        filter {}
 
     project "raylib"
         raylib.static_lib_target()
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "audio.h"
+#include "demo_assets.h"
 
 AudioSystem audio;
 static bool audioDeviceOK = false;
@@ -60,7 +61,7 @@ static const char *soundFiles[SOUND_COUNT] = {
 };
 
 
-bool initAudioFiles(void) {
+bool initAudioFiles(CoreJobs *jobs) {
     InitAudioDevice();
     audioDeviceOK = IsAudioDeviceReady();
     bool success = true;
@@ -68,14 +69,26 @@ bool initAudioFiles(void) {
         fprintf(stderr, "Audio device failed to initialize. Sounds disabled.\n");
         return true;  // Audio unavailable, skip loading sounds, game still opens
     }
+
+    CoreJob loads[SOUND_COUNT] = {0};
+    bool missing[SOUND_COUNT] = {false};
+
     for (int i = 0; i < SOUND_COUNT; i++) {
         if (!FileExists(soundFiles[i])) {
             fprintf(stderr, "Missing sound: %s\n", soundFiles[i]);
+            missing[i] = true;
             success = false;
             continue;
         }
 
-        audio.sounds[i] = LoadSound(soundFiles[i]);
+        loads[i] = LoadSoundJob(jobs, soundFiles[i], &audio.sounds[i]);
+    }
+
+    WaitForJobs(jobs, loads, SOUND_COUNT);
+
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (missing[i]) continue;
+
         if (audio.sounds[i].frameCount == 0) {
             fprintf(stderr, "Failed to load sound: %s\n", soundFiles[i]);
             success = false;
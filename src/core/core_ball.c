@@ -0,0 +1,821 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "core/core_game.h"
+
+static const int INITIAL_BALL_SPEED = 400;  // pixels per second
+static const int MAX_BALL_SPEED = 1000;
+
+static const int bounceVariance = 10;    // degrees either way
+
+// a split ball heading closer than this to straight up or down is turned aside by splitAngle
+#define SPLIT_MINIMUM_X REAL_C(0.2)
+static const CoreAngle splitAngle = ANGLE_DEGREES(30);
+
+// contacts closer together than this (as a fraction of the move) count as simultaneous
+#define TOI_EPSILON REAL_C(1e-4)
+#define MAX_CONTACTS 16
+// bounces resolved per step before the rest of the motion is dropped
+#define MAX_CONTACT_PASSES 8
+// balls handed to a worker at a time
+#define MOVE_GRAIN 32
+
+typedef enum {
+    CONTACT_WALL,
+    CONTACT_PADDLE,
+    CONTACT_BLOCK
+} CONTACT_KIND;
+
+// what the balls move against this step, shared read-only by the workers
+typedef struct {
+    CoreGame *game;
+    CoreReal dt;
+    uint64_t seed;  // each ball draws its bounces from its own stream of this
+} MoveJob;
+
+typedef struct {
+    CONTACT_KIND kind;
+    CoreReal toi;   // fraction of the motion at first touch
+    bool xAxis;     // touched a left or right face
+    int wall;
+    int row;
+    int col;
+} Contact;
+
+static CoreVec2 GetSpawnPoint(const CoreGame *game);
+static int AddBall(CoreGame *game, CoreReal x, CoreReal y, CoreReal vx, CoreReal vy, int speed, BALL_STATES state);
+static void SetDirection(CoreBallPool *balls, int ball, CoreReal x, CoreReal y);
+static void MoveRange(void *context, int worker, int begin, int end);
+static bool MoveBall(CoreGame *game, int ball, CoreReal dt, CoreRng *rng);
+static int FindContacts(const CoreGame *game, int ball, CoreReal motionX, CoreReal motionY, Contact *contacts, CoreReal *toi);
+static bool ResolveContacts(CoreGame *game, int ball, const Contact *contacts, int count, CoreReal time, CoreRng *rng);
+static void Record(CoreBallPool *balls, int ball, CoreReal time, BALL_RECORD_KINDS kind, int a, int b);
+static void ApplyRecords(CoreGame *game, int count);
+static void CollideBalls(CoreGame *game, CoreReal dt);
+static CoreRealRect CollisionBox(const CoreBallPool *balls, int ball);
+static CoreRealRect ToRealRect(CoreRect rect);
+
+
+void CoreResetBalls(CoreGame *game) {
+
+    CoreBallPool *balls = &game->balls;
+
+    balls->count = 0;
+    balls->sticky = false;
+    balls->releaseAngle = ANGLE_TURN / 4;  // points straight up
+    balls->guideDirection = 1;
+
+    CoreAddBall(game, GetSpawnPoint(game), (CoreVec2){0, 0}, 0, BALL_SPAWNED);
+
+}
+
+
+int CoreAddBall(CoreGame *game, CoreVec2 position, CoreVec2 velocity, int speed, BALL_STATES state) {
+    return AddBall(game, RealFromFloat(position.x), RealFromFloat(position.y),
+                   RealFromFloat(velocity.x), RealFromFloat(velocity.y), speed, state);
+}
+
+
+static int AddBall(CoreGame *game, CoreReal x, CoreReal y, CoreReal vx, CoreReal vy, int speed, BALL_STATES state) {
+
+    CoreBallPool *balls = &game->balls;
+
+    if (balls->count >= CORE_MAX_BALLS) return -1;
+
+    int i = balls->count++;
+
+    balls->x[i] = x;
+    balls->y[i] = y;
+    balls->vx[i] = vx;
+    balls->vy[i] = vy;
+    balls->speed[i] = speed;
+    balls->state[i] = state;
+
+    balls->order[i] = i;  // sorts into place on the next collision pass
+
+    balls->prevX[i] = x;  // nothing to blend in from
+    balls->prevY[i] = y;
+    balls->anchorX[i] = 0;
+    balls->anchorY[i] = 0;
+
+    return i;
+}
+
+
+void CoreRemoveBall(CoreGame *game, int ball) {
+
+    CoreBallPool *balls = &game->balls;
+    int last = --balls->count;
+
+    // drop the ball from the sort order and renumber the one taking its slot
+    int k = 0;
+    for (int i = 0; i <= last; i++) {
+        if (balls->order[i] == ball) continue;
+        balls->order[k++] = (balls->order[i] == last) ? ball : balls->order[i];
+    }
+
+    if (ball == last) return;
+
+    balls->x[ball] = balls->x[last];
+    balls->y[ball] = balls->y[last];
+    balls->vx[ball] = balls->vx[last];
+    balls->vy[ball] = balls->vy[last];
+    balls->speed[ball] = balls->speed[last];
+    balls->state[ball] = balls->state[last];
+    balls->prevX[ball] = balls->prevX[last];
+    balls->prevY[ball] = balls->prevY[last];
+    balls->anchorX[ball] = balls->anchorX[last];
+    balls->anchorY[ball] = balls->anchorY[last];
+
+}
+
+
+int CoreSplitBall(CoreGame *game, int ball) {
+
+    CoreBallPool *balls = &game->balls;
+    CoreReal vx = -balls->vx[ball];
+    CoreReal vy = balls->vy[ball];
+
+    // a ball going nearly straight would split into two on the same path
+    if (RealAbs(vx) < RealMul(RealFromInt(balls->speed[ball]), SPLIT_MINIMUM_X))
+        CoreRotate(&vx, &vy, splitAngle);
+
+    return AddBall(game, balls->x[ball], balls->y[ball], vx, vy, balls->speed[ball], BALL_ACTIVE);
+}
+
+
+void CoreReleaseBalls(CoreGame *game) {
+
+    CoreBallPool *balls = &game->balls;
+
+    for (int i = 0; i < balls->count; i++) {
+
+        if (balls->state[i] == BALL_SPAWNED) {
+            balls->speed[i] = INITIAL_BALL_SPEED;
+            SetDirection(balls, i, CoreCos(balls->releaseAngle), CoreSin(balls->releaseAngle));
+        } else if (balls->state[i] != BALL_ATTACHED) {
+            continue;
+        }
+
+        balls->state[i] = BALL_ACTIVE;
+        CorePushEvent(game, CORE_EVENT_BALL_SHOT, SND_BALLSHOT);
+    }
+
+    // Start the countdown timer on the first ball release
+    game->timerActive = true;
+}
+
+
+static CoreVec2 GetSpawnPoint(const CoreGame *game) {
+    CoreVec2 spawn = CoreBallSpawnPointOnPaddle(game);
+    return (CoreVec2){
+        spawn.x - CORE_BALL_WIDTH / 2,
+        spawn.y - CORE_BALL_HEIGHT
+    };
+}
+
+
+void CoreRotateGuide(CoreGame *game, float dt) {
+
+    const CoreAngle centerAngle = ANGLE_DEGREES(90);  // straight up
+    const CoreAngle angleSway = ANGLE_DEGREES(45);    // +/- 45 degrees
+    const float rotateSpeed = ANGLE_TURN / 4.0f;      // angle units per second
+
+    CoreBallPool *balls = &game->balls;
+
+    // rotate the guide between 45 and 135 degrees
+    balls->releaseAngle += (CoreAngle)(rotateSpeed * dt) * balls->guideDirection;
+    if (balls->releaseAngle > centerAngle + angleSway && balls->guideDirection > 0) {
+        balls->guideDirection = -1;
+    } else if (balls->releaseAngle < centerAngle - angleSway && balls->guideDirection < 0) {
+        balls->guideDirection = 1;
+    }
+
+}
+
+
+void CoreMoveBalls(CoreGame *game, float dt) {
+
+    CoreBallPool *balls = &game->balls;
+    MoveJob job = { game, RealFromFloat(dt), 0 };
+
+    // one draw per step, whatever the number of balls or threads
+    job.seed = CoreRngNext64(&game->rng);
+
+    // balls added by a block this step start moving on the next one
+    const int count = balls->count;
+    if (game->workers != NULL)
+        CoreWorkersRun(game->workers, count, MOVE_GRAIN, MoveRange, &job);
+    else
+        MoveRange(&job, 0, 0, count);
+
+    ApplyRecords(game, count);
+
+    // back to front, so every ball moved into a freed slot has been checked
+    for (int i = balls->count - 1; i >= 0; i--) {
+        if (balls->state[i] == BALL_LOST) CoreRemoveBall(game, i);
+    }
+
+    if (balls->count == 0 && game->mode == MODE_PLAY) game->mode = MODE_LOSE;
+
+    CollideBalls(game, job.dt);
+
+}
+
+
+/*
+ * Moves balls begin..end-1. A ball writes only its own slots, reading the
+ * paddle, walls and blocks as they were when the step began, so any number
+ * of ranges can run at once.
+ */
+static void MoveRange(void *context, int worker, int begin, int end) {
+
+    const MoveJob *job = context;
+    CoreBallPool *balls = &job->game->balls;
+
+    for (int i = begin; i < end; i++) {
+        CoreRng rng;
+        CoreRngStream(&rng, job->seed, (uint32_t)i);
+
+        balls->recordCount[i] = 0;
+        if (!MoveBall(job->game, i, job->dt, &rng)) balls->state[i] = BALL_LOST;
+    }
+}
+
+
+// Returns false if the ball fell out of the play area
+static bool MoveBall(CoreGame *game, int ball, CoreReal dt, CoreRng *rng) {
+
+    CoreBallPool *balls = &game->balls;
+    const CorePlayArea *playArea = &game->playArea;
+
+    switch (balls->state[ball]) {
+
+    case BALL_SPAWNED: {
+        // keep spawned ball on paddle center
+        CoreVec2 spawn = GetSpawnPoint(game);
+        balls->x[ball] = RealFromFloat(spawn.x);
+        balls->y[ball] = RealFromFloat(spawn.y);
+        return true;
+    }
+
+    case BALL_ATTACHED: {
+        const CoreReal paddleX = RealFromFloat(game->paddle.position);
+
+        balls->x[ball] = paddleX - balls->anchorX[ball];
+        balls->y[ball] = RealFromInt(CorePaddlePositionY(game)) - balls->anchorY[ball];
+
+        // check is the ball is hanging off the edge of the paddle
+        // when the paddle is moved against the wall
+        CoreReal boundary = RealFromFloat(CorePlayWall(playArea, WALL_LEFT).width);
+        if (balls->x[ball] < boundary) {
+            balls->x[ball] = boundary;
+            balls->anchorX[ball] = paddleX - balls->x[ball];
+        }
+
+        boundary = RealFromFloat(CorePlayWall(playArea, WALL_RIGHT).x - CORE_BALL_WIDTH);
+        if (balls->x[ball] > boundary) {
+            balls->x[ball] = boundary;
+            balls->anchorX[ball] = paddleX - balls->x[ball];
+        }
+
+        return true;
+    }
+
+    case BALL_LOST:
+        return false;
+
+    default:
+        break;
+    }
+
+    // fly the ball for dt, stopping at each contact to bounce off it
+    CoreReal remaining = dt;
+    for (int i = 0; i < MAX_CONTACT_PASSES && remaining > 0; i++) {
+
+        CoreReal motionX = RealMul(balls->vx[ball], remaining);
+        CoreReal motionY = -RealMul(balls->vy[ball], remaining);
+
+        Contact contacts[MAX_CONTACTS];
+        CoreReal toi = REAL_ONE;
+        int count = FindContacts(game, ball, motionX, motionY, contacts, &toi);
+
+        balls->x[ball] += RealMul(motionX, toi);
+        balls->y[ball] += RealMul(motionY, toi);
+
+        if (count == 0) break;
+
+        CoreReal time = dt - remaining + RealMul(remaining, toi);
+        if (!ResolveContacts(game, ball, contacts, count, time, rng)) return balls->state[ball] != BALL_LOST;
+
+        remaining = RealMul(remaining, REAL_ONE - toi);
+    }
+
+    return true;
+}
+
+
+/*
+ * Entry and exit times of one box edge pair along an axis. A box that is
+ * not moving on this axis is either always or never overlapping.
+ */
+static bool SweepAxis(CoreReal box, CoreReal boxSize, CoreReal motion, CoreReal target, CoreReal targetSize,
+                      CoreReal *entry, CoreReal *exit) {
+
+    if (motion > 0) {
+        *entry = RealDiv(target - (box + boxSize), motion);
+        *exit = RealDiv(target + targetSize - box, motion);
+    } else if (motion < 0) {
+        *entry = RealDiv(target + targetSize - box, motion);
+        *exit = RealDiv(target - (box + boxSize), motion);
+    } else {
+        if (box >= target + targetSize || box + boxSize <= target) return false;
+        *entry = -REAL_MAX;
+        *exit = REAL_MAX;
+    }
+
+    return true;
+}
+
+
+/*
+ * Swept test of a moving box against a still one. Returns true if the box
+ * touches the target during this motion, with the fraction of the motion at
+ * first touch and whether the contact face is vertical (x bounce). A box that
+ * already overlaps the target counts as touching at 0 when it is moving
+ * further in, using the axis of least penetration.
+ */
+static bool SweepRect(CoreRealRect box, CoreReal motionX, CoreReal motionY, CoreRealRect target, CoreReal *toi, bool *xAxis) {
+
+    CoreReal entryX, exitX, entryY, exitY;
+
+    if (!SweepAxis(box.x, box.width, motionX, target.x, target.width, &entryX, &exitX)) return false;
+    if (!SweepAxis(box.y, box.height, motionY, target.y, target.height, &entryY, &exitY)) return false;
+
+    CoreReal entry = RealMax(entryX, entryY);
+    CoreReal exit = RealMin(exitX, exitY);
+
+    if (entry > exit || entry > REAL_ONE || exit <= 0) return false;
+
+    if (entry >= 0) {
+        *toi = entry;
+        *xAxis = entryX > entryY;
+        return true;
+    }
+
+    // already overlapping: push out along the shallower axis, if heading into it
+    CoreReal dX = (box.x + RealHalf(box.width)) - (target.x + RealHalf(target.width));
+    CoreReal dY = (box.y + RealHalf(box.height)) - (target.y + RealHalf(target.height));
+    CoreReal overlapX = RealHalf(box.width + target.width) - RealAbs(dX);
+    CoreReal overlapY = RealHalf(box.height + target.height) - RealAbs(dY);
+
+    // heading in means moving against the offset (compared by sign, a product could overflow)
+    *toi = 0;
+    *xAxis = overlapX < overlapY;
+    if (*xAxis) return dX != 0 && motionX != 0 && (dX < 0) != (motionX < 0);
+    return dY != 0 && motionY != 0 && (dY < 0) != (motionY < 0);
+}
+
+
+// Keeps the contacts that happen first; ties within TOI_EPSILON are all kept
+static void AddContact(Contact *contacts, int *count, CoreReal *best, Contact contact) {
+
+    if (contact.toi < *best - TOI_EPSILON) {
+        *count = 0;
+        *best = contact.toi;
+    } else if (contact.toi > *best + TOI_EPSILON) {
+        return;
+    }
+
+    if (*count < MAX_CONTACTS) contacts[(*count)++] = contact;
+}
+
+
+static int FindContacts(const CoreGame *game, int ball, CoreReal motionX, CoreReal motionY, Contact *contacts, CoreReal *toi) {
+
+    const CoreRealRect box = CollisionBox(&game->balls, ball);
+    const CoreReal noHit = 2 * REAL_ONE;
+    CoreReal best = noHit;
+    int count = 0;
+
+    Contact contact = {0};
+
+    // play area walls
+    for (int wall = WALL_LEFT; wall <= WALL_BOTTOM; wall++) {
+        CoreRealRect target = ToRealRect(CorePlayWall(&game->playArea, wall));
+        if (SweepRect(box, motionX, motionY, target, &contact.toi, &contact.xAxis)) {
+            contact.kind = CONTACT_WALL;
+            contact.wall = wall;
+            AddContact(contacts, &count, &best, contact);
+        }
+    }
+
+    // only a falling ball can land on the paddle
+    if (game->balls.vy[ball] < 0 &&
+        SweepRect(box, motionX, motionY, ToRealRect(CorePaddleCollisionRec(game)), &contact.toi, &contact.xAxis)) {
+        contact.kind = CONTACT_PADDLE;
+        AddContact(contacts, &count, &best, contact);
+    }
+
+    // blocks, only in the cells the ball sweeps through; the broad phase
+    // works in float, grown a little so rounding never loses a touching block
+    const float margin = 1.0f / 64.0f;
+    CoreRect swept = {
+        RealToFloat(RealMin(box.x, box.x + motionX)) - margin,
+        RealToFloat(RealMin(box.y, box.y + motionY)) - margin,
+        RealToFloat(box.width + RealAbs(motionX)) + 2 * margin,
+        RealToFloat(box.height + RealAbs(motionY)) + 2 * margin
+    };
+
+    int rowMin, rowMax, colMin, colMax;
+    if (CoreBlockCellRange(game, swept, &rowMin, &rowMax, &colMin, &colMax)) {
+
+        const uint32_t colMask = ((2u << colMax) - 1) & ~((1u << colMin) - 1);
+
+        // the row kernel culls blocks the swept box cannot reach before the exact test
+        for (int row = rowMin; row <= rowMax; row++) {
+            if (!(game->grid.active[row] & colMask)) continue;
+
+            for (uint32_t bits = CoreBlockRowOverlap(game, row, swept) & colMask; bits; bits &= bits - 1) {
+                int col = CoreLowestBit(bits);
+
+                if (SweepRect(box, motionX, motionY, ToRealRect(game->grid.hitbox[row][col]), &contact.toi, &contact.xAxis)) {
+                    contact.kind = CONTACT_BLOCK;
+                    contact.row = row;
+                    contact.col = col;
+                    AddContact(contacts, &count, &best, contact);
+                }
+            }
+        }
+    }
+
+    *toi = (count > 0) ? best : REAL_ONE;
+    return count;
+}
+
+
+/*
+ * Applies everything the ball touched at one instant, time seconds into
+ * the step. Each axis flips at most once however many blocks were hit
+ * together. Returns false once the ball has stopped flying (lost, or stuck
+ * to the paddle).
+ */
+static bool ResolveContacts(CoreGame *game, int ball, const Contact *contacts, int count, CoreReal time, CoreRng *rng) {
+
+    CoreBallPool *balls = &game->balls;
+
+    bool flipx = false;
+    bool flipy = false;
+    bool wallSound = false;
+
+    for (int i = 0; i < count; i++) {
+
+        const Contact *contact = &contacts[i];
+
+        switch (contact->kind) {
+
+        case CONTACT_WALL:
+            if (contact->wall == WALL_BOTTOM) {
+                Record(balls, ball, time, BALL_RECORD_EVENT, CORE_EVENT_BALL_LOST, SND_BALLLOST);
+                balls->state[ball] = BALL_LOST;
+                return false;
+            }
+            wallSound = true;
+            if (contact->wall == WALL_TOP) flipy = true;
+            else flipx = true;
+            break;
+
+        case CONTACT_PADDLE: {
+            const CoreReal paddleY = RealFromInt(CorePaddlePositionY(game));
+            flipy = true;
+            balls->y[ball] = paddleY - CollisionBox(balls, ball).height;
+            Record(balls, ball, time, BALL_RECORD_EVENT, CORE_EVENT_PADDLE_HIT, SND_PADDLE);
+            // every ball landing in the step that finds the paddle sticky stays on it
+            if (balls->sticky) {
+                Record(balls, ball, time, BALL_RECORD_CATCH, 0, 0);
+                balls->state[ball] = BALL_ATTACHED;
+                balls->anchorX[ball] = RealFromFloat(game->paddle.position) - balls->x[ball];
+                balls->anchorY[ball] = paddleY - balls->y[ball];
+            }
+            break;
+        }
+
+        case CONTACT_BLOCK:
+            Record(balls, ball, time, BALL_RECORD_BLOCK, contact->row, contact->col);
+            if (contact->xAxis) flipx = true;
+            else flipy = true;
+            break;
+        }
+    }
+
+    if (wallSound) Record(balls, ball, time, BALL_RECORD_EVENT, CORE_EVENT_WALL_BOUNCE, SND_BOING);
+
+    // change directions if needed
+    if (flipx) balls->vx[ball] = -balls->vx[ball];
+    if (flipy) balls->vy[ball] = -balls->vy[ball];
+
+    // add variance to the angle on bounce
+    if (flipx || flipy) {
+
+        //original only returned negative variance
+        int degrees = CoreRngRange(rng, 2 * bounceVariance + 1) - bounceVariance;
+        CoreReal vx = balls->vx[ball];
+        CoreReal vy = balls->vy[ball];
+        CoreRotate(&vx, &vy, ANGLE_DEGREES(degrees));
+        SetDirection(balls, ball, vx, vy);
+
+    }
+
+    return balls->state[ball] == BALL_ACTIVE;
+}
+
+
+// Notes something for ApplyRecords(); a ball with a full list drops the rest
+static void Record(CoreBallPool *balls, int ball, CoreReal time, BALL_RECORD_KINDS kind, int a, int b) {
+
+    if (balls->recordCount[ball] >= CORE_BALL_RECORDS) return;
+
+    CoreBallRecord *record = &balls->records[ball][balls->recordCount[ball]++];
+    record->time = time;
+    record->kind = (uint8_t)kind;
+    record->event = (uint8_t)a;   // events take a and b as type and sound,
+    record->sound = (uint8_t)b;   // block hits as row and column
+    record->row = (uint8_t)a;
+    record->col = (uint8_t)b;
+}
+
+
+// Orders the records waiting at the heads of two balls' lists: time, then ball
+static bool RecordBefore(const CoreBallPool *balls, const uint8_t *next, int a, int b) {
+    CoreReal timeA = balls->records[a][next[a]].time;
+    CoreReal timeB = balls->records[b][next[b]].time;
+    return (timeA != timeB) ? timeA < timeB : a < b;
+}
+
+
+static void SiftDown(const CoreBallPool *balls, const uint8_t *next, int *heap, int size, int i) {
+
+    for (;;) {
+        int least = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+
+        if (left < size && RecordBefore(balls, next, heap[left], heap[least])) least = left;
+        if (right < size && RecordBefore(balls, next, heap[right], heap[least])) least = right;
+        if (least == i) return;
+
+        int swap = heap[i];
+        heap[i] = heap[least];
+        heap[least] = swap;
+        i = least;
+    }
+}
+
+
+/*
+ * Plays back what balls 0..count-1 did during the move, merging their
+ * lists (each already in time order) into one, so blocks, events and
+ * effects happen in the same order however the balls were split up. A
+ * block knocked out earlier in the step only bounces the balls that reach
+ * it later.
+ */
+static void ApplyRecords(CoreGame *game, int count) {
+
+    CoreBallPool *balls = &game->balls;
+
+    int heap[CORE_MAX_BALLS];
+    uint8_t next[CORE_MAX_BALLS];
+    int size = 0;
+
+    for (int i = 0; i < count; i++) {
+        next[i] = 0;
+        if (balls->recordCount[i] > 0) heap[size++] = i;
+    }
+
+    for (int i = size / 2 - 1; i >= 0; i--) SiftDown(balls, next, heap, size, i);
+
+    while (size > 0) {
+
+        const int ball = heap[0];
+        const CoreBallRecord *record = &balls->records[ball][next[ball]];
+
+        switch (record->kind) {
+
+        case BALL_RECORD_EVENT:
+            CorePushEvent(game, (CoreEventType)record->event, (SoundID)record->sound);
+            break;
+
+        case BALL_RECORD_BLOCK:
+            if (CoreIsBlockActive(game, record->row, record->col)) {
+                int speed = balls->speed[ball];
+                CoreActivateBlock(game, ball, record->row, record->col);
+                // a speed up counts from the bounce that earned it
+                if (balls->speed[ball] != speed)
+                    SetDirection(balls, ball, balls->vx[ball], balls->vy[ball]);
+            }
+            break;
+
+        case BALL_RECORD_CATCH:
+            balls->sticky = false;
+            break;
+        }
+
+        if (++next[ball] < balls->recordCount[ball]) {
+            SiftDown(balls, next, heap, size, 0);
+        } else {
+            heap[0] = heap[--size];
+            SiftDown(balls, next, heap, size, 0);
+        }
+    }
+}
+
+
+// Points the ball along (x, y), at its own speed
+static void SetDirection(CoreBallPool *balls, int ball, CoreReal x, CoreReal y) {
+
+    CoreReal length = CoreLength(x, y);
+    if (length <= 0) return;
+
+    const CoreReal speed = RealFromInt(balls->speed[ball]);
+    balls->vx[ball] = RealMul(RealDiv(x, length), speed);
+    balls->vy[ball] = RealMul(RealDiv(y, length), speed);
+}
+
+
+/*
+ * Predicts whether two flying balls meet within the next dt, as
+ * WhenBallsCollide() did in the original: solves for when the gap between
+ * their centers shrinks to two radii, moving in a straight line. Balls that
+ * already overlap, like the two halves of a split, are left to drift apart.
+ */
+static bool WhenBallsCollide(const CoreBallPool *balls, int a, int b, CoreReal dt, CoreReal *time) {
+
+    const CoreReal r2 = RealFromInt(CORE_BALL_WIDTH * CORE_BALL_WIDTH);  // (radius + radius) squared
+
+    // screen space deltas; both balls are the same size so corners stand in for centers
+    CoreReal px = balls->x[a] - balls->x[b];
+    CoreReal py = balls->y[a] - balls->y[b];
+    CoreReal vx = RealMul(balls->vx[a] - balls->vx[b], dt);
+    CoreReal vy = -RealMul(balls->vy[a] - balls->vy[b], dt);
+
+    CoreReal v2 = RealMul(vx, vx) + RealMul(vy, vy);
+    CoreReal cross = RealMul(vx, py) - RealMul(vy, px);
+    CoreReal tmp2 = RealMul(v2, r2) - RealMul(cross, cross);
+
+    if (tmp2 < 0 || v2 <= REAL_C(1e-6)) return false;
+
+    CoreReal tmin = RealDiv(-(RealMul(px, vx) + RealMul(py, vy)) - RealSqrt(tmp2), v2);
+    if (tmin < 0 || tmin > REAL_ONE) return false;
+
+    *time = tmin;
+    return true;
+}
+
+
+/*
+ * Swaps the balls' velocity along the line between their centers at the
+ * moment they touch, as Ball2BallCollision() did with equal masses. Each
+ * ball then keeps its own speed, like after any other bounce.
+ */
+static void Ball2BallCollision(CoreBallPool *balls, int a, int b, CoreReal dt, CoreReal time) {
+
+    const CoreReal elapsed = RealMul(dt, time);
+    CoreReal px = (balls->x[a] - balls->x[b]) + RealMul(balls->vx[a] - balls->vx[b], elapsed);
+    CoreReal py = (balls->y[a] - balls->y[b]) - RealMul(balls->vy[a] - balls->vy[b], elapsed);
+    CoreReal plen = CoreLength(px, py);
+    if (plen <= 0) return;
+
+    px = RealDiv(px, plen);
+    py = RealDiv(py, plen);
+
+    CoreReal vx = balls->vx[a] - balls->vx[b];
+    CoreReal vy = -(balls->vy[a] - balls->vy[b]);
+    CoreReal k = -(RealMul(vx, px) + RealMul(vy, py));
+
+    balls->vx[a] += RealMul(k, px);
+    balls->vy[a] -= RealMul(k, py);
+    balls->vx[b] -= RealMul(k, px);
+    balls->vy[b] += RealMul(k, py);
+
+    SetDirection(balls, a, balls->vx[a], balls->vy[a]);
+    SetDirection(balls, b, balls->vx[b], balls->vy[b]);
+}
+
+
+/*
+ * Sort and sweep along x. Each ball covers the span its box sweeps this
+ * tick; after sorting by the left end, only balls whose spans overlap need
+ * the exact test, and the scan for a ball stops at the first one starting
+ * past its right end. The order is kept from the last tick and balls move
+ * little between ticks, so an insertion sort is close to linear.
+ */
+static void CollideBalls(CoreGame *game, CoreReal dt) {
+
+    CoreBallPool *balls = &game->balls;
+    const int count = balls->count;
+    const CoreReal width = RealFromInt(CORE_BALL_WIDTH);
+    const CoreReal height = RealFromInt(CORE_BALL_HEIGHT);
+
+    CoreReal left[CORE_MAX_BALLS];
+    CoreReal right[CORE_MAX_BALLS];
+
+    for (int i = 0; i < count; i++) {
+        CoreReal move = RealMul(balls->vx[i], dt);
+        left[i] = balls->x[i] + RealMin(move, 0);
+        right[i] = balls->x[i] + width + RealMax(move, 0);
+    }
+
+    uint16_t *order = balls->order;
+    for (int i = 1; i < count; i++) {
+        uint16_t ball = order[i];
+        int j = i - 1;
+        while (j >= 0 && left[order[j]] > left[ball]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = ball;
+    }
+
+    for (int i = 0; i < count; i++) {
+
+        int a = order[i];
+        if (balls->state[a] != BALL_ACTIVE) continue;
+
+        CoreReal moveA = -RealMul(balls->vy[a], dt);
+        CoreReal topA = balls->y[a] + RealMin(moveA, 0);
+        CoreReal bottomA = balls->y[a] + height + RealMax(moveA, 0);
+
+        for (int j = i + 1; j < count && left[order[j]] <= right[a]; j++) {
+
+            int b = order[j];
+            if (balls->state[b] != BALL_ACTIVE) continue;
+
+            CoreReal moveB = -RealMul(balls->vy[b], dt);
+            if (balls->y[b] + RealMin(moveB, 0) > bottomA ||
+                balls->y[b] + height + RealMax(moveB, 0) < topA) continue;
+
+            CoreReal time;
+            if (WhenBallsCollide(balls, a, b, dt, &time)) {
+                Ball2BallCollision(balls, a, b, dt, time);
+                CorePushEvent(game, CORE_EVENT_BALL_HIT, SND_BALL2BALL);
+            }
+        }
+    }
+}
+
+
+bool CoreBallWaiting(const CoreGame *game) {
+    for (int i = 0; i < game->balls.count; i++) {
+        if (game->balls.state[i] == BALL_SPAWNED) return true;
+    }
+    return false;
+}
+
+
+CoreVec2 CoreBallPosition(const CoreGame *game, int ball) {
+    return (CoreVec2){ RealToFloat(game->balls.x[ball]), RealToFloat(game->balls.y[ball]) };
+}
+
+
+static CoreRealRect CollisionBox(const CoreBallPool *balls, int ball) {
+    const int padding = 2; // Adjust padding as needed, make collision box bigger
+    return (CoreRealRect){
+        balls->x[ball], balls->y[ball],
+        RealFromInt(CORE_BALL_WIDTH + padding), RealFromInt(CORE_BALL_HEIGHT + padding)
+    };
+}
+
+
+static CoreRealRect ToRealRect(CoreRect rect) {
+    return (CoreRealRect){
+        RealFromFloat(rect.x), RealFromFloat(rect.y), RealFromFloat(rect.width), RealFromFloat(rect.height)
+    };
+}
+
+
+CoreRect CoreBallCollisionRec(const CoreGame *game, int ball) {
+    CoreRealRect box = CollisionBox(&game->balls, ball);
+    return (CoreRect){ RealToFloat(box.x), RealToFloat(box.y), RealToFloat(box.width), RealToFloat(box.height) };
+}
+
+
+bool CoreBallSweep(CoreRect box, float motionX, float motionY, CoreRect target, float *toi, bool *xAxis) {
+
+    CoreReal realToi;
+    if (!SweepRect(ToRealRect(box), RealFromFloat(motionX), RealFromFloat(motionY), ToRealRect(target), &realToi, xAxis)) return false;
+
+    *toi = RealToFloat(realToi);
+    return true;
+}
+
+
+void CoreSetBallSticky(CoreGame *game) {
+    game->balls.sticky = true;
+}
+
+
+void CoreIncreaseBallSpeed(CoreGame *game, int ball) {
+    if (game->balls.speed[ball] < MAX_BALL_SPEED) {
+        game->balls.speed[ball] = (int)(game->balls.speed[ball] * 1.25f); //speed cap, hopefully not as fast anymore?
+    }
+}
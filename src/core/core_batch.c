@@ -0,0 +1,163 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_batch.h"
+#include "core/core_run.h"
+#include "core/core_workers.h"
+
+// games handed to a worker at a time
+#define STEP_GRAIN 16
+
+struct CoreBatch {
+    int count;
+    uint64_t seed;
+    unsigned long long maxTicks;
+    CoreWorkers *workers;   // NULL steps every game on the calling thread
+
+    CoreGame start;         // the level as loaded, copied into each new episode
+
+    CoreGame *games;        // count games, side by side
+    CoreRunStats *stats;    // this episode's so far
+    uint32_t *episodes;     // episodes started per game
+    bool *ended;            // starts over on the next step
+};
+
+// the controls of one step, shared read-only by the workers
+typedef struct StepJob {
+    CoreBatch *batch;
+    const CoreInput *actions;
+    float *rewards;
+    bool *done;
+} StepJob;
+
+
+static void StartEpisode(CoreBatch *batch, int game) {
+
+    CoreGame *out = &batch->games[game];
+    memcpy(out, &batch->start, sizeof(*out));
+
+    // a stream per game and episode, whichever thread gets there first
+    CoreRng rng;
+    CoreRngStream(&rng, batch->seed, (uint32_t)game + (uint32_t)batch->count * batch->episodes[game]++);
+    CoreGameSeed(out, CoreRngNext64(&rng));
+
+    CoreGameStartLife(out);
+    CoreClearEvents(out);
+
+    memset(&batch->stats[game], 0, sizeof(batch->stats[game]));
+    batch->ended[game] = false;
+}
+
+
+// Plays the input set aside for this game
+static void ActionInput(void *context, const CoreGame *game, CoreInput *input) {
+    (void)game;
+    *input = *(const CoreInput *)context;
+}
+
+
+static void StepRange(void *context, int worker, int begin, int end) {
+
+    (void)worker;
+    const StepJob *job = context;
+    CoreBatch *batch = job->batch;
+
+    for (int i = begin; i < end; i++) {
+        if (batch->ended[i]) StartEpisode(batch, i);
+
+        CoreGame *game = &batch->games[i];
+        CoreRunStats *stats = &batch->stats[i];
+        int blocks = CoreBlocksRemaining(game);
+        int livesLost = stats->livesLost;
+
+        CoreInput action = job->actions[i];
+        bool playing = CoreRunStep(game, ActionInput, &action, stats) && stats->ticks < batch->maxTicks;
+
+        float reward = (blocks - CoreBlocksRemaining(game)) * CORE_BATCH_BLOCK_REWARD
+                     + (stats->livesLost - livesLost) * CORE_BATCH_LIFE_REWARD;
+        if (stats->cleared) reward += CORE_BATCH_CLEAR_REWARD;
+
+        batch->ended[i] = !playing;
+        if (job->rewards != NULL) job->rewards[i] = reward;
+        if (job->done != NULL) job->done[i] = !playing;
+    }
+}
+
+
+CoreBatch *CoreBatchCreate(int count, const char *levelFile, uint64_t seed, int threadCount) {
+
+    if (count < 1) return NULL;
+
+    CoreBatch *batch = calloc(1, sizeof(*batch));
+    if (batch == NULL) return NULL;
+
+    batch->count = count;
+    batch->seed = seed;
+    batch->maxTicks = CORE_BATCH_MAX_TICKS;
+
+    CoreGameInit(&batch->start, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    bool loaded = CoreGameNewLevel(&batch->start, levelFile);
+
+    batch->games = malloc(count * sizeof(*batch->games));
+    batch->stats = malloc(count * sizeof(*batch->stats));
+    batch->episodes = calloc(count, sizeof(*batch->episodes));
+    batch->ended = malloc(count * sizeof(*batch->ended));
+    if (threadCount != 1) batch->workers = CoreWorkersCreate(threadCount);
+
+    if (!loaded || batch->games == NULL || batch->stats == NULL || batch->episodes == NULL || batch->ended == NULL ||
+        (threadCount != 1 && batch->workers == NULL)) {
+        CoreBatchDestroy(batch);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        StartEpisode(batch, i);
+    }
+
+    return batch;
+}
+
+
+void CoreBatchDestroy(CoreBatch *batch) {
+
+    if (batch == NULL) return;
+
+    CoreWorkersDestroy(batch->workers);
+    free(batch->games);
+    free(batch->stats);
+    free(batch->episodes);
+    free(batch->ended);
+    free(batch);
+}
+
+
+int CoreBatchCount(const CoreBatch *batch) {
+    return batch->count;
+}
+
+
+void CoreBatchSetMaxTicks(CoreBatch *batch, unsigned long long maxTicks) {
+    batch->maxTicks = maxTicks;
+}
+
+
+void CoreBatchReset(CoreBatch *batch, int game) {
+    if (game >= 0 && game < batch->count) StartEpisode(batch, game);
+}
+
+
+void CoreBatchStep(CoreBatch *batch, const CoreInput *actions, float *rewards, bool *done) {
+
+    StepJob job = { batch, actions, rewards, done };
+
+    if (batch->workers != NULL)
+        CoreWorkersRun(batch->workers, batch->count, STEP_GRAIN, StepRange, &job);
+    else
+        StepRange(&job, 0, 0, batch->count);
+}
+
+
+const CoreGame *CoreBatchGame(const CoreBatch *batch, int game) {
+    return &batch->games[game];
+}
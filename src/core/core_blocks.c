@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "core/core_game.h"
+
+static const int PLAY_X_OFFSET = 35;
+static const int PLAY_Y_OFFSET = 60;
+
+static const int PLAY_X_PADDING = 40;
+static const int PLAY_Y_PADDING = 70;
+
+static const int PADDLE_ROWS = 3;
+
+
+void CoreInitPlayArea(CorePlayArea *playArea, int screenWidth, int screenHeight) {
+
+    playArea->screenWidth = screenWidth;
+    playArea->screenHeight = screenHeight;
+
+    playArea->playWidth = screenWidth - (PLAY_X_PADDING * 2);
+    playArea->playHeight = screenHeight - (PLAY_Y_PADDING * 2);
+
+    playArea->colWidth = playArea->playWidth / CORE_COL_MAX;
+    playArea->rowHeight = playArea->playHeight / (CORE_ROW_MAX + PADDLE_ROWS);
+
+}
+
+
+bool CoreLoadBlocks(CoreGame *game, const char *filename) {
+
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    // Get header info
+    if (!fgets(game->levelName, sizeof(game->levelName), fp)) { // read level name
+        fclose(fp);
+        return false;
+    }
+    if (fscanf(fp, "%d", &game->timeRemaining) != 1) { // read time bonus
+        fclose(fp);
+        return false;
+    }
+    getc(fp); // consume newline after timeBonus
+
+    // a short file leaves the remaining cells empty
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (int col = 0; col < CORE_COL_MAX; col++) {
+            CoreAddBlock(game, row, col, '.');
+        }
+    }
+
+    int row = 0;
+    int column = 0;
+    int ch;
+
+    while ((ch = getc(fp)) != EOF) { // read character by character
+        if (ch == '\n' || ch == '\r') continue; // skip newlines
+
+        CoreAddBlock(game, row, column, (char)ch);
+
+        column++;
+        if (column >= CORE_COL_MAX) { // move to next row
+            column = 0;
+            row++;
+            if (row >= CORE_ROW_MAX) break; // stop if we exceed max rows
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+
+static void SetHitbox(CoreBlockGrid *grid, int row, int col, CoreRect hitbox) {
+    grid->hitbox[row][col] = hitbox;
+    grid->left[row][col] = hitbox.x;
+    grid->top[row][col] = hitbox.y;
+    grid->right[row][col] = hitbox.x + hitbox.width;
+    grid->bottom[row][col] = hitbox.y + hitbox.height;
+}
+
+
+void CoreAddBlock(CoreGame *game, int row, int col, char ch) {
+
+    if (row < 0 || row >= CORE_ROW_MAX || col < 0 || col >= CORE_COL_MAX) return;
+
+    CoreBlockGrid *grid = &game->grid;
+    const CorePlayArea *playArea = &game->playArea;
+    const uint16_t bit = 1u << col;
+
+    const CoreBlockType *info = CoreGetBlockType(ch);
+
+    grid->type[row][col] = ch;
+    grid->hits[row][col] = info->hitPoints;
+    grid->active[row] &= ~bit;
+    grid->solid[row] &= ~bit;
+
+    if (!info->defined) {
+        SetHitbox(grid, row, col, (CoreRect){0});
+        return;
+    }
+
+    // center the hitbox in its cell; it may not spill out or the broad phase would miss it
+    int width = info->width < playArea->colWidth ? info->width : playArea->colWidth;
+    int height = info->height < playArea->rowHeight ? info->height : playArea->rowHeight;
+    int offsetX = (playArea->colWidth - width) / 2;
+    int offsetY = (playArea->rowHeight - height) / 2;
+
+    SetHitbox(grid, row, col, (CoreRect){
+        (col * playArea->colWidth) + offsetX + PLAY_X_OFFSET,
+        (row * playArea->rowHeight) + offsetY + PLAY_Y_OFFSET,
+        width,
+        height
+    });
+
+    grid->active[row] |= bit;
+    if (info->hitPoints == 0) grid->solid[row] |= bit;  //solid wall blocks cannot be destroyed and should not count
+
+}
+
+
+static inline bool inBounds(int row, int col) { // check if row and column are within valid range
+    return (row >= 0 && row < CORE_ROW_MAX && col >= 0 && col < CORE_COL_MAX);
+}
+
+
+CoreRect CoreBlockCollisionRec(const CoreGame *game, int row, int col) {
+    if (!inBounds(row, col)) { // out of bounds
+        return (CoreRect){ 0, 0, 0, 0 }; // return empty rectangle
+    }
+    return game->grid.hitbox[row][col];
+}
+
+
+uint32_t CoreBlockRowOverlap(const CoreGame *game, int row, CoreRect bounds) {
+    const CoreBlockGrid *grid = &game->grid;
+    return grid->active[row] & CoreOverlapRow(bounds, grid->left[row], grid->top[row], grid->right[row], grid->bottom[row]);
+}
+
+
+bool CoreBlockCellRange(const CoreGame *game, CoreRect bounds, int *rowMin, int *rowMax, int *colMin, int *colMax) {
+
+    const CorePlayArea *playArea = &game->playArea;
+
+    float left = (bounds.x - PLAY_X_OFFSET) / playArea->colWidth;
+    float right = (bounds.x + bounds.width - PLAY_X_OFFSET) / playArea->colWidth;
+    float top = (bounds.y - PLAY_Y_OFFSET) / playArea->rowHeight;
+    float bottom = (bounds.y + bounds.height - PLAY_Y_OFFSET) / playArea->rowHeight;
+
+    if (right < 0.0f || left >= CORE_COL_MAX || bottom < 0.0f || top >= CORE_ROW_MAX) return false;
+
+    *colMin = (left < 0.0f) ? 0 : (int)left;
+    *colMax = (right >= CORE_COL_MAX) ? CORE_COL_MAX - 1 : (int)right;
+    *rowMin = (top < 0.0f) ? 0 : (int)top;
+    *rowMax = (bottom >= CORE_ROW_MAX) ? CORE_ROW_MAX - 1 : (int)bottom;
+
+    return true;
+}
+
+
+bool CoreIsBlockActive(const CoreGame *game, int row, int col) {
+    if (!inBounds(row, col)) return false; //bounds check
+    return (game->grid.active[row] >> col) & 1u;
+}
+
+
+char CoreBlockTypeAt(const CoreGame *game, int row, int col) {
+    if (!inBounds(row, col)) return '.';
+    return game->grid.type[row][col];
+}
+
+
+int CoreBlocksRemaining(const CoreGame *game) {
+    int count = 0;
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        count += CoreBitCount(game->grid.active[row] & ~game->grid.solid[row]);
+    }
+    return count;
+}
+
+
+void CoreActivateBlock(CoreGame *game, int ball, int row, int col) {
+
+    CoreBlockGrid *grid = &game->grid;
+    const CoreBlockType *info = CoreGetBlockType(grid->type[row][col]);
+
+    if (info->sound != SND_NONE) CorePushBlockEvent(game, info->sound, row, col);
+
+    // solid blocks only bounce the ball
+    if (info->hitPoints == 0) return;
+
+    if (grid->hits[row][col] > 1) {
+        grid->hits[row][col]--;
+        return;
+    }
+
+    CoreDeactivateBlock(game, row, col);
+    if (info->effect) info->effect(game, ball, row, col);
+
+    if (CoreBlocksRemaining(game) == 0 && game->mode != MODE_WIN) {
+        CorePushEvent(game, CORE_EVENT_LEVEL_CLEARED, SND_APPLAUSE);
+        game->mode = MODE_WIN;
+    }
+
+}
+
+
+CoreVec2 CorePlayCorner(const CorePlayArea *playArea, CORNERS corner) {
+
+    switch (corner) {
+
+        case UPPER_LEFT:
+            return (CoreVec2){PLAY_X_OFFSET - 1, PLAY_Y_OFFSET - 1};
+
+        case UPPER_RIGHT:
+            return (CoreVec2){PLAY_X_OFFSET + playArea->playWidth, PLAY_Y_OFFSET - 1};
+
+        case LOWER_LEFT:
+            return (CoreVec2){PLAY_X_OFFSET - 1, PLAY_Y_OFFSET + playArea->playHeight};
+
+        case LOWER_RIGHT:
+            return (CoreVec2){playArea->playWidth + 1, PLAY_Y_OFFSET + playArea->playHeight};
+    }
+
+    // never should return this
+    return (CoreVec2){0};
+
+}
+
+
+CoreRect CorePlayWall(const CorePlayArea *playArea, WALLS wall) {
+
+    const float screenWidth = playArea->screenWidth;
+    const float screenHeight = playArea->screenHeight;
+
+    switch(wall) {
+        case WALL_LEFT:
+            return (CoreRect){0, 0, CorePlayCorner(playArea, LOWER_LEFT).x, screenHeight};
+
+        case WALL_RIGHT:
+            return (CoreRect){CorePlayCorner(playArea, UPPER_RIGHT).x, 0, screenWidth - CorePlayCorner(playArea, UPPER_RIGHT).x, screenHeight};
+
+        case WALL_TOP:
+            return (CoreRect){0, 0, screenWidth, CorePlayCorner(playArea, UPPER_RIGHT).y};
+
+        case WALL_BOTTOM:
+            return (CoreRect){0, CorePlayCorner(playArea, LOWER_LEFT).y + CorePlayCorner(playArea, UPPER_LEFT).y, screenWidth, screenHeight - CorePlayCorner(playArea, LOWER_RIGHT).y};
+    }
+
+    // never should return this
+    return (CoreRect){0};
+
+}
+
+
+void CoreDeactivateBlock(CoreGame *game, int row, int col) {
+    if (!inBounds(row, col)) return;
+
+    // solid blocks stay put
+    game->grid.active[row] &= ~(1u << col) | game->grid.solid[row];
+}
+
+
+// Cells are wider and taller than the ball, so one open cell is room enough to pass
+void CoreReachableCells(const CoreBlockGrid *grid, uint16_t reached[CORE_ROW_MAX]) {
+
+    uint16_t open[CORE_ROW_MAX];
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        open[row] = CORE_ROW_MASK & ~(grid->active[row] & grid->solid[row]);
+        reached[row] = 0;
+    }
+    reached[CORE_ROW_MAX - 1] = open[CORE_ROW_MAX - 1];
+
+    // spread sideways along each row and up and down between rows until nothing changes
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int row = CORE_ROW_MAX - 1; row >= 0; row--) {
+            uint16_t cells = reached[row];
+            if (row > 0) cells |= reached[row - 1];
+            if (row < CORE_ROW_MAX - 1) cells |= reached[row + 1];
+            cells &= open[row];
+
+            for (uint16_t last = 0; cells != last;) {
+                last = cells;
+                cells |= ((cells << 1) | (cells >> 1)) & open[row];
+            }
+
+            if (cells != reached[row]) {
+                reached[row] = cells;
+                changed = true;
+            }
+        }
+    }
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "core/core_game.h"
+
+static void EffectSticky(CoreGame *game, int ball, int row, int col);
+static void EffectReverse(CoreGame *game, int ball, int row, int col);
+static void EffectSpeedUp(CoreGame *game, int ball, int row, int col);
+static void EffectShrinkPaddle(CoreGame *game, int ball, int row, int col);
+static void EffectGrowPaddle(CoreGame *game, int ball, int row, int col);
+static void EffectBomb(CoreGame *game, int ball, int row, int col);
+static void EffectMultiball(CoreGame *game, int ball, int row, int col);
+
+#define PLAIN(tex)            { true, tex, false, 40, 20, 1, SND_TOUCH, NULL }
+#define SIZED(tex, w, h)      { true, tex, false, w, h, 1, SND_TOUCH, NULL }
+#define COUNTER(hits)         { true, BLOCK_TEX_COUNTER, true, 40, 20, hits, SND_TOUCH, NULL }
+
+static CoreBlockType blockTypes[256] = {
+    ['H'] = SIZED(BLOCK_TEX_HYPERSPACE, 31, 31),    /* hyperspace block - walls are now gone */
+    ['B'] = { true, BLOCK_TEX_BULLET, false, 40, 20, 1, SND_BOING, EffectSpeedUp },  /* bullet block - ball speed up */
+    ['c'] = PLAIN(BLOCK_TEX_MAXAMMO),               /* maximum ammo bullet block */
+    ['r'] = PLAIN(BLOCK_TEX_RED),                   /* A red block */
+    ['g'] = PLAIN(BLOCK_TEX_GREEN),                 /* A green block */
+    ['b'] = PLAIN(BLOCK_TEX_BLUE),                  /* A blue block */
+    ['t'] = PLAIN(BLOCK_TEX_TAN),                   /* A tan block */
+    ['p'] = PLAIN(BLOCK_TEX_PURPLE),                /* A purple block */
+    ['y'] = PLAIN(BLOCK_TEX_YELLOW),                /* A yellow block */
+    ['w'] = { true, BLOCK_TEX_BLACK, false, 50, 30, 0, SND_NONE, NULL },  /* A solid wall block */
+    ['0'] = COUNTER(1),                             /* A counter block - no number */
+    ['1'] = COUNTER(2),                             /* counter blocks count down to '0' */
+    ['2'] = COUNTER(3),
+    ['3'] = COUNTER(4),
+    ['4'] = COUNTER(5),
+    ['5'] = COUNTER(6),
+    ['+'] = SIZED(BLOCK_TEX_ROAMER, 25, 27),        /* A roamer block */
+    ['X'] = { true, BLOCK_TEX_BOMB, false, 30, 30, 1, SND_BOMB, EffectBomb },  /* A bomb */
+    ['D'] = SIZED(BLOCK_TEX_DEATH, 30, 30),         /* A death block */
+    ['L'] = SIZED(BLOCK_TEX_EXTRABALL, 30, 19),     /* An extra ball block */
+    ['M'] = SIZED(BLOCK_TEX_MGUN, 35, 15),          /* A machine gun block */
+    ['W'] = SIZED(BLOCK_TEX_WALLOFF, 27, 23),       /* A wall off block */
+    ['?'] = PLAIN(BLOCK_TEX_RANDOM),                /* A random changing block */
+    ['d'] = PLAIN(BLOCK_TEX_DROP),                  /* A dropping block */
+    ['T'] = SIZED(BLOCK_TEX_TIMER, 21, 21),         /* A extra time block */
+    ['m'] = { true, BLOCK_TEX_MULTIBALL, false, 40, 20, 1, SND_TOUCH, EffectMultiball },  /* A multiple ball block */
+    ['s'] = { true, BLOCK_TEX_STICKY, false, 32, 27, 1, SND_STICKY, EffectSticky },        /* A sticky block */
+    ['R'] = { true, BLOCK_TEX_REVERSE, false, 33, 16, 1, SND_WARP, EffectReverse },        /* reverse block - switch paddle control */
+    ['<'] = { true, BLOCK_TEX_PAD_SHRINK, false, 40, 15, 1, SND_WZZZ2, EffectShrinkPaddle }, /* shrink paddle block */
+    ['>'] = { true, BLOCK_TEX_PAD_EXPAND, false, 40, 15, 1, SND_WZZZ, EffectGrowPaddle },   /* expand paddle block */
+};
+
+static const struct {
+    const char *name;
+    CoreBlockEffect effect;
+} effectNames[] = {
+    { "none", NULL },
+    { "sticky", EffectSticky },
+    { "reverse", EffectReverse },
+    { "speed", EffectSpeedUp },
+    { "shrink", EffectShrinkPaddle },
+    { "grow", EffectGrowPaddle },
+    { "bomb", EffectBomb },
+    { "multiball", EffectMultiball },
+};
+
+
+const CoreBlockType *CoreGetBlockType(char ch) {
+    return &blockTypes[(unsigned char)ch];
+}
+
+
+bool CoreLoadBlockTypes(const char *filename) {
+
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    bool success = true;
+    char line[256];
+    int lineNumber = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNumber++;
+
+        char ch, like;
+        int width, height, hits;
+        char effect[32] = "";
+
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+        int fields = sscanf(line, " %c %c %d %d %d %31s", &ch, &like, &width, &height, &hits, effect);
+        if (fields < 2 || !blockTypes[(unsigned char)like].defined || (fields > 2 && fields < 5)) {
+            fprintf(stderr, "%s:%d: bad block type\n", filename, lineNumber);
+            success = false;
+            continue;
+        }
+
+        CoreBlockType type = blockTypes[(unsigned char)like];
+
+        if (fields >= 5) {
+            if (width <= 0 || width > 255 || height <= 0 || height > 255 || hits < 0 || hits > 255) {
+                fprintf(stderr, "%s:%d: block size or hits out of range\n", filename, lineNumber);
+                success = false;
+                continue;
+            }
+            type.width = width;
+            type.height = height;
+            type.hitPoints = hits;
+        }
+
+        if (fields == 6) {
+            size_t i;
+            for (i = 0; i < sizeof(effectNames) / sizeof(effectNames[0]); i++) {
+                if (strcmp(effect, effectNames[i].name) == 0) break;
+            }
+            if (i == sizeof(effectNames) / sizeof(effectNames[0])) {
+                fprintf(stderr, "%s:%d: unknown effect '%s'\n", filename, lineNumber, effect);
+                success = false;
+                continue;
+            }
+            type.effect = effectNames[i].effect;
+        }
+
+        blockTypes[(unsigned char)ch] = type;
+    }
+
+    fclose(fp);
+    return success;
+}
+
+
+bool CoreLoadOptionalBlockTypes(const char *filename) {
+
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) return true;
+    fclose(fp);
+
+    return CoreLoadBlockTypes(filename);
+}
+
+
+static void EffectSticky(CoreGame *game, int ball, int row, int col) {
+    CoreSetBallSticky(game);
+}
+
+
+static void EffectReverse(CoreGame *game, int ball, int row, int col) {
+    CoreToggleReverse(game);
+}
+
+
+static void EffectSpeedUp(CoreGame *game, int ball, int row, int col) {
+    CoreIncreaseBallSpeed(game, ball);
+}
+
+
+static void EffectShrinkPaddle(CoreGame *game, int ball, int row, int col) {
+    CoreChangePaddleSize(game, SIZE_DOWN);
+}
+
+
+static void EffectGrowPaddle(CoreGame *game, int ball, int row, int col) {
+    CoreChangePaddleSize(game, SIZE_UP);
+}
+
+
+// destroy the surrounding 8 blocks without triggering them
+static void EffectBomb(CoreGame *game, int ball, int row, int col) {
+
+    CoreBlockGrid *grid = &game->grid;
+
+    // columns col-1..col+1, clipped to the grid
+    uint16_t blast = (uint16_t)(((col > 0) ? 7u << (col - 1) : 3u) & CORE_ROW_MASK);
+
+    for (int rowOffset = row - 1; rowOffset <= row + 1; rowOffset++) {
+        if (rowOffset < 0 || rowOffset >= CORE_ROW_MAX) continue;
+        grid->active[rowOffset] &= ~(blast & ~grid->solid[rowOffset]);
+    }
+}
+
+
+// the ball that hit it splits in two
+static void EffectMultiball(CoreGame *game, int ball, int row, int col) {
+    CoreSplitBall(game, ball);
+}
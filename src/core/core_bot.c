@@ -0,0 +1,191 @@
+#include <stdbool.h>
+#include <float.h>
+
+#include "core/core_bot.h"
+
+// closer than this and the paddle would overshoot in one tick
+#define BOT_DEADZONE 3.0f
+
+// the lowest balls traced each tick; with hundreds in play the rest can wait
+#define BOT_CANDIDATES 8
+
+
+/*
+ * The first active block the box runs into along the motion, found the way
+ * the ball step finds them: cells the sweep covers, then the row kernel,
+ * then the ball step's own swept test.
+ */
+static bool FirstBlock(const CoreGame *game, CoreRect box, float motionX, float motionY, float *toi, bool *xAxis) {
+
+    const float margin = 1.0f / 64.0f;
+    CoreRect swept = {
+        (motionX < 0.0f ? box.x + motionX : box.x) - margin,
+        (motionY < 0.0f ? box.y + motionY : box.y) - margin,
+        box.width + (motionX < 0.0f ? -motionX : motionX) + 2 * margin,
+        box.height + (motionY < 0.0f ? -motionY : motionY) + 2 * margin
+    };
+
+    int rowMin, rowMax, colMin, colMax;
+    if (!CoreBlockCellRange(game, swept, &rowMin, &rowMax, &colMin, &colMax)) return false;
+
+    const uint32_t colMask = ((2u << colMax) - 1) & ~((1u << colMin) - 1);
+    bool found = false;
+
+    for (int row = rowMin; row <= rowMax; row++) {
+        if (!(game->grid.active[row] & colMask)) continue;
+
+        for (uint32_t bits = CoreBlockRowOverlap(game, row, swept) & colMask; bits; bits &= bits - 1) {
+            int col = CoreLowestBit(bits);
+
+            float blockToi;
+            bool blockXAxis;
+            if (CoreBallSweep(box, motionX, motionY, game->grid.hitbox[row][col], &blockToi, &blockXAxis) &&
+                (!found || blockToi < *toi)) {
+                *toi = blockToi;
+                *xAxis = blockXAxis;
+                found = true;
+            }
+        }
+    }
+
+    return found;
+}
+
+
+bool CoreBotPredict(const CoreGame *game, int ball, float *landingX, float *seconds) {
+
+    if (ball < 0 || ball >= game->balls.count || game->balls.state[ball] != BALL_ACTIVE) return false;
+
+    const CorePlayArea *playArea = &game->playArea;
+    CoreRect box = CoreBallCollisionRec(game, ball);
+
+    // screen space, y down
+    float velocityX = RealToFloat(game->balls.vx[ball]);
+    float velocityY = -RealToFloat(game->balls.vy[ball]);
+
+    const float minX = CorePlayWall(playArea, WALL_LEFT).width;
+    const float maxX = CorePlayWall(playArea, WALL_RIGHT).x - box.width;
+    const float minY = CorePlayWall(playArea, WALL_TOP).height;
+    const float landY = CorePaddlePositionY(game) - box.height;
+
+    float time = 0.0f;
+
+    for (int bounce = 0; bounce <= CORE_BOT_BOUNCES; bounce++) {
+
+        // how long until the box meets a wall or comes down to the paddle
+        float untilX = FLT_MAX;
+        if (velocityX > 0.0f) untilX = (maxX - box.x) / velocityX;
+        else if (velocityX < 0.0f) untilX = (minX - box.x) / velocityX;
+
+        float untilY = FLT_MAX;
+        if (velocityY > 0.0f) untilY = (landY - box.y) / velocityY;
+        else if (velocityY < 0.0f) untilY = (minY - box.y) / velocityY;
+
+        if (untilX < 0.0f) untilX = 0.0f;
+        if (untilY < 0.0f) untilY = 0.0f;
+
+        float until = untilX < untilY ? untilX : untilY;
+        if (until == FLT_MAX) return false;
+
+        float toi = 1.0f;
+        bool xAxis;
+        if (FirstBlock(game, box, velocityX * until, velocityY * until, &toi, &xAxis)) {
+            box.x += velocityX * until * toi;
+            box.y += velocityY * until * toi;
+            time += until * toi;
+            if (xAxis) velocityX = -velocityX;
+            else velocityY = -velocityY;
+            continue;
+        }
+
+        box.x += velocityX * until;
+        box.y += velocityY * until;
+        time += until;
+
+        if (untilY <= untilX && velocityY > 0.0f) {
+            *landingX = box.x;
+            *seconds = time;
+            return true;
+        }
+
+        if (untilY <= untilX) velocityY = -velocityY;
+        if (untilX <= untilY) velocityX = -velocityX;
+    }
+
+    return false;
+}
+
+
+// Adds ball to the lowest BOT_CANDIDATES, kept in order from lowest up
+static int KeepLowest(const CoreGame *game, int *lowest, int count, int ball) {
+
+    const CoreReal *y = game->balls.y;
+
+    int i = count < BOT_CANDIDATES ? count++ : BOT_CANDIDATES;
+    while (i > 0 && y[lowest[i - 1]] < y[ball]) {
+        if (i < BOT_CANDIDATES) lowest[i] = lowest[i - 1];
+        i--;
+    }
+    if (i < BOT_CANDIDATES) lowest[i] = ball;
+
+    return count;
+}
+
+
+/*
+ * Where the paddle's center should go: under the traced ball that comes
+ * down first, or under the lowest ball if none could be traced. Falling
+ * balls are traced before rising ones.
+ */
+static bool TargetX(const CoreGame *game, float *target) {
+
+    const CoreBallPool *balls = &game->balls;
+    int falling[BOT_CANDIDATES], rising[BOT_CANDIDATES];
+    int fallingCount = 0, risingCount = 0;
+
+    for (int i = 0; i < balls->count; i++) {
+        if (balls->state[i] != BALL_ACTIVE) continue;
+
+        if (balls->vy[i] < 0) fallingCount = KeepLowest(game, falling, fallingCount, i);
+        else risingCount = KeepLowest(game, rising, risingCount, i);
+    }
+
+    const int *candidates = fallingCount > 0 ? falling : rising;
+    int count = fallingCount > 0 ? fallingCount : risingCount;
+    if (count == 0) return false;
+
+    float soonest = FLT_MAX;
+    for (int i = 0; i < count; i++) {
+        float landingX, seconds;
+        if (CoreBotPredict(game, candidates[i], &landingX, &seconds) && seconds < soonest) {
+            soonest = seconds;
+            *target = landingX + CoreBallCollisionRec(game, candidates[i]).width / 2.0f;
+        }
+    }
+
+    if (soonest == FLT_MAX) *target = RealToFloat(balls->x[candidates[0]]) + CORE_BALL_WIDTH / 2.0f;
+    return true;
+}
+
+
+void CoreBotInput(void *context, const CoreGame *game, CoreInput *input) {
+
+    (void)context;
+
+    if (CoreBallWaiting(game)) input->releaseBall = true;
+
+    float target = 0.0f;
+    if (!TargetX(game, &target)) return;
+
+    float center = game->paddle.position + CorePaddleSize(game) / 2.0f;
+
+    int direction = PADDLE_NONE;
+    if (target < center - BOT_DEADZONE) direction = PADDLE_LEFT;
+    else if (target > center + BOT_DEADZONE) direction = PADDLE_RIGHT;
+
+    // reverse swaps what the controls do, so swap them back
+    if (game->paddle.reverse && direction != PADDLE_NONE)
+        direction = direction == PADDLE_LEFT ? PADDLE_RIGHT : PADDLE_LEFT;
+
+    input->paddleMove = direction;
+}
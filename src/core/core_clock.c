@@ -0,0 +1,28 @@
+#include "core/core_clock.h"
+
+
+void CoreClockReset(CoreClock *clock) {
+    clock->accumulator = 0.0;
+}
+
+
+int CoreClockAdvance(CoreClock *clock, double frameTime) {
+
+    if (frameTime < 0.0) frameTime = 0.0;
+    if (frameTime > CORE_MAX_FRAME_TIME) frameTime = CORE_MAX_FRAME_TIME;
+
+    clock->accumulator += frameTime;
+
+    int ticks = 0;
+    while (clock->accumulator >= CORE_TICK_DT) {
+        clock->accumulator -= CORE_TICK_DT;
+        ticks++;
+    }
+
+    return ticks;
+}
+
+
+float CoreClockAlpha(const CoreClock *clock) {
+    return (float)(clock->accumulator / CORE_TICK_DT);
+}
@@ -0,0 +1,431 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_dataset.h"
+#include "core/core_thread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+_Static_assert(sizeof(CoreDatasetHeader) == 64, "shard header is 64 bytes");
+_Static_assert(sizeof(CoreDatasetRecord) == 96, "dataset records are 96 bytes");
+
+static const char DATASET_MAGIC[4] = { 'X', 'B', 'D', 'S' };
+#define DATASET_NAME_MAX  1024
+#define DATASET_IDLE      0.005   // seconds the writer thread sleeps when the ring is empty
+#define DATASET_FLUSH     1.0     // seconds between flushes of the shard being written
+
+#define RING_MASK (CORE_DATASET_RING_RECORDS - 1)
+_Static_assert((CORE_DATASET_RING_RECORDS & RING_MASK) == 0, "the ring is a power of two");
+
+
+// A file mapped for writing, sized up front
+typedef struct MappedFile {
+    unsigned char *view;
+    size_t size;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int file;
+#endif
+} MappedFile;
+
+
+#if defined(_WIN32)
+
+static bool SetFileSize(HANDLE file, size_t size) {
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)size;
+    return SetFilePointerEx(file, end, NULL, FILE_BEGIN) && SetEndOfFile(file);
+}
+
+static bool MapNew(MappedFile *mapped, const char *filename, size_t size) {
+
+    mapped->file = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mapped->file == INVALID_HANDLE_VALUE) return false;
+
+    mapped->mapping = NULL;
+    mapped->view = NULL;
+    if (SetFileSize(mapped->file, size)) {
+        mapped->mapping = CreateFileMappingA(mapped->file, NULL, PAGE_READWRITE,
+                                             (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+    }
+    if (mapped->mapping != NULL) mapped->view = MapViewOfFile(mapped->mapping, FILE_MAP_WRITE, 0, 0, size);
+
+    if (mapped->view == NULL) {
+        if (mapped->mapping != NULL) CloseHandle(mapped->mapping);
+        CloseHandle(mapped->file);
+        DeleteFileA(filename);
+        return false;
+    }
+
+    mapped->size = size;
+    return true;
+}
+
+static void FlushMapped(MappedFile *mapped) {
+    FlushViewOfFile(mapped->view, 0);
+}
+
+// Unmaps and cuts the file down to keep bytes
+static bool CloseMapped(MappedFile *mapped, size_t keep) {
+    bool success = FlushViewOfFile(mapped->view, 0) != 0;
+    UnmapViewOfFile(mapped->view);
+    CloseHandle(mapped->mapping);
+    if (!SetFileSize(mapped->file, keep)) success = false;
+    if (!CloseHandle(mapped->file)) success = false;
+    return success;
+}
+
+#else
+
+static bool MapNew(MappedFile *mapped, const char *filename, size_t size) {
+
+    mapped->file = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mapped->file < 0) return false;
+
+    void *view = MAP_FAILED;
+    if (ftruncate(mapped->file, (off_t)size) == 0) {
+        view = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped->file, 0);
+    }
+
+    if (view == MAP_FAILED) {
+        close(mapped->file);
+        unlink(filename);
+        return false;
+    }
+
+    mapped->view = view;
+    mapped->size = size;
+    return true;
+}
+
+static void FlushMapped(MappedFile *mapped) {
+    msync(mapped->view, mapped->size, MS_ASYNC);
+}
+
+// Unmaps and cuts the file down to keep bytes
+static bool CloseMapped(MappedFile *mapped, size_t keep) {
+    bool success = msync(mapped->view, mapped->size, MS_SYNC) == 0;
+    munmap(mapped->view, mapped->size);
+    if (ftruncate(mapped->file, (off_t)keep) != 0) success = false;
+    if (close(mapped->file) != 0) success = false;
+    return success;
+}
+
+#endif
+
+
+struct CoreDatasetWriter {
+    char prefix[DATASET_NAME_MAX];
+    size_t shardRecords;
+    CoreThread thread;
+    volatile int quit;
+
+    // the capturing thread owns head, the writer thread tail; both only grow, wrapping
+    CoreDatasetRecord *ring;
+    volatile int head;
+    volatile int tail;
+    unsigned long long dropped;     // by the capturing thread
+
+    // the writer thread's own
+    MappedFile shard;
+    bool shardOpen;
+    int shardNumber;
+    size_t shardCount;
+    double lastFlush;
+    bool failed;
+};
+
+
+static CoreDatasetHeader *ShardHeader(CoreDatasetWriter *writer) {
+    return (CoreDatasetHeader *)writer->shard.view;
+}
+
+static CoreDatasetRecord *ShardRecords(CoreDatasetWriter *writer) {
+    return (CoreDatasetRecord *)(writer->shard.view + sizeof(CoreDatasetHeader));
+}
+
+
+static bool OpenShard(CoreDatasetWriter *writer) {
+
+    char filename[DATASET_NAME_MAX + 16];
+    snprintf(filename, sizeof(filename), "%s-%05d.xbds", writer->prefix, writer->shardNumber++);
+
+    size_t size = sizeof(CoreDatasetHeader) + writer->shardRecords * sizeof(CoreDatasetRecord);
+    if (!MapNew(&writer->shard, filename, size)) {
+        fprintf(stderr, "%s: shard could not be created\n", filename);
+        return false;
+    }
+
+    CoreDatasetHeader *header = ShardHeader(writer);
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+    header->version = CORE_DATASET_VERSION;
+    header->recordSize = sizeof(CoreDatasetRecord);
+    header->byteOrder = CORE_DATASET_BYTE_ORDER;
+
+    writer->shardOpen = true;
+    writer->shardCount = 0;
+    writer->lastFlush = CoreTimeNow();
+    return true;
+}
+
+
+// Sets the count, trims the unused records and closes the shard
+static void CloseShard(CoreDatasetWriter *writer) {
+
+    if (!writer->shardOpen) return;
+
+    ShardHeader(writer)->count = writer->shardCount;
+    size_t keep = sizeof(CoreDatasetHeader) + writer->shardCount * sizeof(CoreDatasetRecord);
+    if (!CloseMapped(&writer->shard, keep)) writer->failed = true;
+    writer->shardOpen = false;
+}
+
+
+// Moves everything in the ring into shards, starting new ones as they fill
+static void Drain(CoreDatasetWriter *writer) {
+
+    unsigned tail = (unsigned)writer->tail;
+    unsigned head = (unsigned)CoreAtomicLoad(&writer->head);
+
+    while (tail != head && !writer->failed) {
+
+        if (writer->shardOpen && writer->shardCount == writer->shardRecords) CloseShard(writer);
+        if (!writer->shardOpen && !OpenShard(writer)) {
+            writer->failed = true;
+            break;
+        }
+
+        // as far as the ring wraps, the shard fills or the records run out
+        size_t count = head - tail;
+        size_t untilWrap = CORE_DATASET_RING_RECORDS - (tail & RING_MASK);
+        size_t room = writer->shardRecords - writer->shardCount;
+        if (count > untilWrap) count = untilWrap;
+        if (count > room) count = room;
+
+        memcpy(ShardRecords(writer) + writer->shardCount, writer->ring + (tail & RING_MASK),
+               count * sizeof(CoreDatasetRecord));
+        writer->shardCount += count;
+        ShardHeader(writer)->count = writer->shardCount;
+
+        tail += (unsigned)count;
+        CoreAtomicStore(&writer->tail, (int)tail);
+    }
+
+    // a failed writer keeps taking records so the capturer never sees a full ring
+    if (writer->failed) CoreAtomicStore(&writer->tail, (int)head);
+}
+
+
+static void WriterMain(void *arg) {
+
+    CoreDatasetWriter *writer = arg;
+
+    while (!CoreAtomicLoad(&writer->quit)) {
+        Drain(writer);
+
+        if (writer->shardOpen && CoreTimeNow() - writer->lastFlush >= DATASET_FLUSH) {
+            FlushMapped(&writer->shard);
+            writer->lastFlush = CoreTimeNow();
+        }
+
+        CoreSleep(DATASET_IDLE);
+    }
+
+    Drain(writer);
+    CloseShard(writer);
+}
+
+
+CoreDatasetWriter *CoreDatasetStart(const char *prefix, size_t shardRecords) {
+
+    if (strlen(prefix) >= DATASET_NAME_MAX) return NULL;
+
+    CoreDatasetWriter *writer = calloc(1, sizeof(*writer));
+    if (writer == NULL) return NULL;
+
+    writer->ring = malloc(CORE_DATASET_RING_RECORDS * sizeof(CoreDatasetRecord));
+    if (writer->ring == NULL) {
+        free(writer);
+        return NULL;
+    }
+
+    strcpy(writer->prefix, prefix);
+    writer->shardRecords = shardRecords ? shardRecords : CORE_DATASET_SHARD_RECORDS;
+
+    if (!CoreThreadStart(&writer->thread, WriterMain, writer)) {
+        free(writer->ring);
+        free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+
+// The ball the record describes: the lowest one flying, else the first
+static int RecordedBall(const CoreBallPool *balls) {
+
+    int chosen = -1;
+    for (int i = 0; i < balls->count; i++) {
+        if (balls->state[i] != BALL_ACTIVE) continue;
+        if (chosen < 0 || balls->y[i] > balls->y[chosen]) chosen = i;
+    }
+
+    return chosen >= 0 ? chosen : (balls->count > 0 ? 0 : -1);
+}
+
+
+void CoreDatasetCapture(CoreDatasetWriter *writer, const CoreGame *game, const CoreInput *input,
+                        uint32_t events, uint32_t session) {
+
+    unsigned head = (unsigned)writer->head;
+    if (head - (unsigned)CoreAtomicLoad(&writer->tail) >= CORE_DATASET_RING_RECORDS) {
+        writer->dropped++;
+        return;
+    }
+
+    CoreDatasetRecord *record = &writer->ring[head & RING_MASK];
+    memset(record, 0, sizeof(*record));
+
+    record->tick = game->tick;
+    record->session = session;
+    record->events = events;
+
+    const CoreBallPool *balls = &game->balls;
+    int ball = RecordedBall(balls);
+    if (ball >= 0) {
+        record->ballX = RealToFloat(balls->x[ball]);
+        record->ballY = RealToFloat(balls->y[ball]);
+        record->ballVX = RealToFloat(balls->vx[ball]);
+        record->ballVY = RealToFloat(balls->vy[ball]);
+    }
+    record->ballCount = balls->count;
+
+    record->paddlePosition = game->paddle.position;
+    record->paddleIndex = game->paddle.index;
+    record->reverse = game->paddle.reverse;
+    record->blocksRemaining = CoreBlocksRemaining(game);
+    record->timeRemaining = game->timeRemaining;
+    record->livesRemaining = game->livesRemaining;
+    record->mode = game->mode;
+    memcpy(record->active, game->grid.active, sizeof(record->active));
+
+    record->inputMove = input->paddleMove;
+    record->inputPaddleX = input->paddleX;
+    record->inputFlags = (input->paddleAbsolute ? DATASET_INPUT_ABSOLUTE : 0)
+                       | (input->releaseBall ? DATASET_INPUT_RELEASE : 0)
+                       | (input->toggleReverse ? DATASET_INPUT_REVERSE : 0)
+                       | (input->paddleSizeChange == SIZE_UP ? DATASET_INPUT_GROW : 0)
+                       | (input->paddleSizeChange == SIZE_DOWN ? DATASET_INPUT_SHRINK : 0);
+
+    CoreAtomicStore(&writer->head, (int)(head + 1));
+}
+
+
+bool CoreDatasetStop(CoreDatasetWriter *writer) {
+
+    if (writer == NULL) return true;
+
+    CoreAtomicStore(&writer->quit, 1);
+    CoreThreadJoin(writer->thread);
+
+    bool success = !writer->failed;
+    free(writer->ring);
+    free(writer);
+    return success;
+}
+
+
+unsigned long long CoreDatasetDropped(const CoreDatasetWriter *writer) {
+    return writer->dropped;
+}
+
+
+bool CoreDatasetOpen(CoreDatasetShard *shard, const char *filename) {
+
+    memset(shard, 0, sizeof(*shard));
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart >= (LONGLONG)sizeof(CoreDatasetHeader)) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    CloseHandle(file);
+    if (mapping == NULL) return false;
+
+    shard->view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (shard->view == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+    shard->size = (size_t)size.QuadPart;
+    shard->handle = mapping;
+#else
+    int file = open(filename, O_RDONLY);
+    if (file < 0) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    struct stat info;
+    void *view = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size >= (off_t)sizeof(CoreDatasetHeader)) {
+        view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    }
+    close(file);
+    if (view == MAP_FAILED) return false;
+
+    shard->view = view;
+    shard->size = (size_t)info.st_size;
+#endif
+
+    const CoreDatasetHeader *header = shard->view;
+    size_t room = (shard->size - sizeof(CoreDatasetHeader)) / sizeof(CoreDatasetRecord);
+
+    if (memcmp(header->magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0 || header->version != CORE_DATASET_VERSION
+        || header->recordSize != sizeof(CoreDatasetRecord) || header->byteOrder != CORE_DATASET_BYTE_ORDER
+        || header->count > room) {
+        fprintf(stderr, "%s: not a dataset shard this build can read\n", filename);
+        CoreDatasetClose(shard);
+        return false;
+    }
+
+    shard->records = (const CoreDatasetRecord *)((const unsigned char *)shard->view + sizeof(CoreDatasetHeader));
+    shard->count = (size_t)header->count;
+    return true;
+}
+
+
+void CoreDatasetClose(CoreDatasetShard *shard) {
+
+    if (shard->view == NULL) return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(shard->view);
+    CloseHandle(shard->handle);
+#else
+    munmap(shard->view, shard->size);
+#endif
+
+    memset(shard, 0, sizeof(*shard));
+}
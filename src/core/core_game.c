@@ -0,0 +1,192 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/core_game.h"
+
+
+void CoreGameInit(CoreGame *game, int screenWidth, int screenHeight) {
+
+    memset(game, 0, sizeof(*game));
+    CoreInitPlayArea(&game->playArea, screenWidth, screenHeight);
+    CoreRngSeed(&game->rng, CORE_DEFAULT_SEED);
+    game->mode = MODE_INITGAME;
+
+    CoreResetPaddle(game);
+    CoreResetBalls(game);
+
+}
+
+
+void CoreGameSeed(CoreGame *game, uint64_t seed) {
+    CoreRngSeed(&game->rng, seed);
+}
+
+
+void CoreGameSetWorkers(CoreGame *game, CoreWorkers *workers) {
+    game->workers = workers;
+}
+
+
+bool CoreGameNewLevel(CoreGame *game, const char *filename) {
+
+    game->livesRemaining = CORE_INITIAL_LIVES;
+    game->timerElapsed = 0.0f;
+    return CoreLoadBlocks(game, filename);
+
+}
+
+
+void CoreGameSetLevel(CoreGame *game, const char *name, int timeRemaining,
+                      const char blocks[CORE_ROW_MAX][CORE_COL_MAX]) {
+
+    game->livesRemaining = CORE_INITIAL_LIVES;
+    game->timerElapsed = 0.0f;
+
+    snprintf(game->levelName, sizeof(game->levelName), "%s\n", name);  // as read from a level file
+    game->timeRemaining = timeRemaining;
+
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (int col = 0; col < CORE_COL_MAX; col++) {
+            CoreAddBlock(game, row, col, blocks[row][col]);
+        }
+    }
+
+}
+
+
+static void SaveRenderPrev(CoreGame *game) {
+    CoreBallPool *balls = &game->balls;
+    memcpy(balls->prevX, balls->x, balls->count * sizeof(balls->x[0]));
+    memcpy(balls->prevY, balls->y, balls->count * sizeof(balls->y[0]));
+    game->prev.paddlePosition = game->paddle.position;
+}
+
+
+void CoreGameStartLife(CoreGame *game) {
+
+    game->livesRemaining--;
+
+    CoreResetPaddle(game);
+    CoreResetBalls(game);
+    SaveRenderPrev(game);  // no blending in from the last life
+
+    // ensure countdown timer does not start until ball released
+    game->timerActive = false;
+
+    game->mode = MODE_PLAY;
+
+}
+
+
+void CoreGameStep(CoreGame *game, const CoreInput *input, float dt) {
+
+    game->tick++;
+    SaveRenderPrev(game);
+
+    // paddle controls work on every screen
+    if (input->toggleReverse)
+        CoreToggleReverse(game);
+    if (input->paddleSizeChange != 0)
+        CoreChangePaddleSize(game, input->paddleSizeChange);
+
+    if (input->paddleAbsolute)
+        CoreSetPaddlePosition(game, input->paddleX);
+    else if (input->paddleMove != PADDLE_NONE)
+        CoreMovePaddle(game, input->paddleMove, dt);
+
+    if (game->mode != MODE_PLAY) return;
+
+    if (input->releaseBall)
+        CoreReleaseBalls(game);
+
+    if (CoreBallWaiting(game))
+        CoreRotateGuide(game, dt);
+
+    CoreMoveBalls(game, dt);
+    CoreTimeDecrement(game, dt);
+
+}
+
+
+// decrement time remaining by 1 second if timer is active
+void CoreTimeDecrement(CoreGame *game, float dt) {
+    if (!game->timerActive) return;
+
+    game->timerElapsed += dt;
+
+    if (game->timerElapsed > 1.0f) {
+        game->timerElapsed -= 1.0f;
+        game->timeRemaining--;
+    }
+}
+
+
+CoreVec2 CoreLerpBallPosition(const CoreGame *game, int ball, float alpha) {
+    CoreVec2 from = { RealToFloat(game->balls.prevX[ball]), RealToFloat(game->balls.prevY[ball]) };
+    CoreVec2 to = CoreBallPosition(game, ball);
+    return (CoreVec2){ from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha };
+}
+
+
+float CoreLerpPaddlePosition(const CoreGame *game, float alpha) {
+    float from = game->prev.paddlePosition;
+    return from + (game->paddle.position - from) * alpha;
+}
+
+
+void CoreInputMerge(CoreInput *pending, const CoreInput *frame) {
+
+    pending->paddleMove = frame->paddleMove;
+    pending->paddleAbsolute = frame->paddleAbsolute;
+    pending->paddleX = frame->paddleX;
+
+    pending->releaseBall |= frame->releaseBall;
+    pending->toggleReverse ^= frame->toggleReverse;
+    if (frame->paddleSizeChange != 0)
+        pending->paddleSizeChange = frame->paddleSizeChange;
+
+}
+
+
+void CoreInputClearPresses(CoreInput *input) {
+    input->releaseBall = false;
+    input->toggleReverse = false;
+    input->paddleSizeChange = 0;
+}
+
+
+void CorePushEvent(CoreGame *game, CoreEventType type, SoundID sound) {
+
+    // the frontend drains events every step; drop any overflow
+    if (game->eventCount >= CORE_MAX_EVENTS) return;
+
+    game->events[game->eventCount++] = (CoreEvent){ type, sound, -1, -1, 0 };
+
+}
+
+
+void CorePushBlockEvent(CoreGame *game, SoundID sound, int row, int col) {
+
+    if (game->eventCount >= CORE_MAX_EVENTS) return;
+
+    game->events[game->eventCount++] = (CoreEvent){
+        CORE_EVENT_BLOCK_HIT, sound, row, col, game->grid.type[row][col]
+    };
+
+}
+
+
+void CoreClearEvents(CoreGame *game) {
+    game->eventCount = 0;
+}
+
+
+uint32_t CoreEventMask(const CoreGame *game, int from) {
+
+    uint32_t mask = 0;
+    for (int i = from < 0 ? 0 : from; i < game->eventCount; i++) {
+        mask |= 1u << game->events[i].type;
+    }
+    return mask;
+}
@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "core/core_hash.h"
+
+#define HASH_SEED  0x9E3779B97F4A7C15ull
+#define HASH_PRIME 0xC2B2AE3D27D4EB4Full
+
+static const char *partNames[HASH_PART_COUNT] = { "balls", "paddle", "blocks", "rules" };
+
+
+static uint64_t HashWord(uint64_t hash, uint64_t word) {
+    hash ^= word * HASH_PRIME;
+    hash = (hash << 31) | (hash >> 33);
+    return hash * HASH_SEED;
+}
+
+// Eight bytes a step; the tail is padded with zeros
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+
+    const unsigned char *bytes = data;
+    uint64_t word;
+
+    for (; size >= 8; bytes += 8, size -= 8) {
+        memcpy(&word, bytes, 8);
+        hash = HashWord(hash, word);
+    }
+
+    if (size > 0) {
+        word = 0;
+        memcpy(&word, bytes, size);
+        hash = HashWord(hash, word);
+    }
+
+    return HashWord(hash, size);
+}
+
+#define HASH_FIELD(hash, field) HashBytes(hash, &(field), sizeof(field))
+
+// splitmix64's finish, so nearby states land far apart
+static uint64_t Finish(uint64_t hash) {
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBull;
+    return hash ^ (hash >> 31);
+}
+
+
+static uint64_t HashBalls(const CoreGame *game) {
+
+    const CoreBallPool *balls = &game->balls;
+    size_t count = balls->count;
+    uint64_t hash = HashWord(HASH_SEED, count);
+
+    // balls past count are leftovers of removed ones
+    hash = HashBytes(hash, balls->x, count * sizeof(balls->x[0]));
+    hash = HashBytes(hash, balls->y, count * sizeof(balls->y[0]));
+    hash = HashBytes(hash, balls->vx, count * sizeof(balls->vx[0]));
+    hash = HashBytes(hash, balls->vy, count * sizeof(balls->vy[0]));
+    hash = HashBytes(hash, balls->speed, count * sizeof(balls->speed[0]));
+    hash = HashBytes(hash, balls->state, count * sizeof(balls->state[0]));
+    hash = HashBytes(hash, balls->order, count * sizeof(balls->order[0]));
+    hash = HashBytes(hash, balls->anchorX, count * sizeof(balls->anchorX[0]));
+    hash = HashBytes(hash, balls->anchorY, count * sizeof(balls->anchorY[0]));
+
+    hash = HashWord(hash, balls->sticky);
+    hash = HashWord(hash, (uint32_t)balls->releaseAngle);
+    return HashWord(hash, (uint32_t)balls->guideDirection);
+}
+
+
+static uint64_t HashPaddle(const CoreGame *game) {
+
+    uint64_t hash = HASH_FIELD(HASH_SEED, game->paddle.position);
+    hash = HashWord(hash, (uint32_t)game->paddle.index);
+    return HashWord(hash, game->paddle.reverse);
+}
+
+
+static uint64_t HashBlocks(const CoreGame *game) {
+
+    const CoreBlockGrid *grid = &game->grid;
+
+    uint64_t hash = HASH_FIELD(HASH_SEED, grid->active);
+    hash = HASH_FIELD(hash, grid->solid);
+    hash = HASH_FIELD(hash, grid->type);
+    return HASH_FIELD(hash, grid->hits);
+}
+
+
+static uint64_t HashRules(const CoreGame *game) {
+
+    uint64_t hash = HashWord(HASH_SEED, game->tick);
+    hash = HashWord(hash, game->rng.state);
+    hash = HashWord(hash, (uint32_t)game->timeRemaining);
+    hash = HashWord(hash, game->timerActive);
+    hash = HASH_FIELD(hash, game->timerElapsed);
+    hash = HashWord(hash, (uint32_t)game->livesRemaining);
+    return HashWord(hash, game->mode);
+}
+
+
+uint64_t CoreHashPart(const CoreGame *game, HASH_PARTS part) {
+
+    switch (part) {
+    case HASH_BALLS:  return Finish(HashBalls(game));
+    case HASH_PADDLE: return Finish(HashPaddle(game));
+    case HASH_BLOCKS: return Finish(HashBlocks(game));
+    case HASH_RULES:  return Finish(HashRules(game));
+    default:          return 0;
+    }
+}
+
+
+const char *CoreHashPartName(HASH_PARTS part) {
+    return (part >= 0 && part < HASH_PART_COUNT) ? partNames[part] : "unknown";
+}
+
+
+uint64_t CoreGameHash(const CoreGame *game) {
+
+    uint64_t hash = HASH_SEED;
+    for (int part = 0; part < HASH_PART_COUNT; part++) {
+        hash = HashWord(hash, CoreHashPart(game, part));
+    }
+    return Finish(hash);
+}
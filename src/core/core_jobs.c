@@ -0,0 +1,351 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "core/core_thread.h"
+#include "core/core_jobs.h"
+
+// one job waiting on another, kept on the list of the job it waits for
+typedef struct Edge {
+    int job;
+    struct Edge *next;
+} Edge;
+
+typedef struct {
+    CoreJobFn fn;
+    void *data;
+    unsigned flags;
+    int pending;            // unfinished jobs it waits for, plus one until added
+    Edge *successors;       // jobs waiting on this one
+    Edge *edges;            // this job's own entries on other lists, freed when it finishes
+    volatile int generation;  // bumped when the job finishes, so old ids read as done
+    int nextFree;
+} Slot;
+
+// ring of ready jobs, oldest first; CORE_MAX_JOBS entries always fit
+typedef struct {
+    CoreMutex lock;
+    unsigned head;      // oldest, taken next
+    unsigned tail;      // where the next one goes
+    int items[CORE_MAX_JOBS];
+} Queue;
+
+struct CoreJobs {
+    int threadCount;        // including the main thread
+    int started;            // threads running, the main thread counted
+    CoreThread *threads;
+    Queue ready;            // jobs any thread may run
+    Queue mainQueue;        // CORE_JOB_MAIN jobs
+
+    CoreMutex graph;        // slots, their pending counts and lists, the free list
+    Slot slots[CORE_MAX_JOBS];
+    int freeSlot;           // head of the free list, -1 when every slot is taken
+
+    CoreMutex sleepLock;
+    CoreCond wake;          // work was queued or a job finished
+    bool quit;
+
+    volatile int queued;    // jobs in the ready queue
+    volatile int mainQueued;
+    volatile int live;      // slots in use
+};
+
+// set on the thread that created the jobs, the only one that runs CORE_JOB_MAIN
+static CORE_THREAD_LOCAL CoreJobs *currentJobs;
+
+#define JOB_INDEX(job) ((int)((job) & 0xFFFFu) - 1)
+#define JOB_GENERATION(job) ((job) >> 16)
+
+
+static void QueuePush(Queue *queue, int index) {
+    CoreMutexLock(&queue->lock);
+    queue->items[queue->tail++ % CORE_MAX_JOBS] = index;
+    CoreMutexUnlock(&queue->lock);
+}
+
+
+static int QueueTake(Queue *queue) {
+    int index = -1;
+    CoreMutexLock(&queue->lock);
+    if (queue->tail != queue->head) index = queue->items[queue->head++ % CORE_MAX_JOBS];
+    CoreMutexUnlock(&queue->lock);
+    return index;
+}
+
+
+static bool IsMainThread(const CoreJobs *jobs) {
+    return currentJobs == jobs;
+}
+
+
+static bool WorkQueued(CoreJobs *jobs, bool main) {
+    return CoreAtomicLoad(&jobs->queued) > 0 || (main && CoreAtomicLoad(&jobs->mainQueued) > 0);
+}
+
+
+static void Wake(CoreJobs *jobs) {
+    CoreMutexLock(&jobs->sleepLock);
+    CoreCondBroadcast(&jobs->wake);
+    CoreMutexUnlock(&jobs->sleepLock);
+}
+
+
+// Queues a job whose dependencies are done; called with the graph lock held
+static void MakeReady(CoreJobs *jobs, int index) {
+
+    if (jobs->slots[index].flags & CORE_JOB_MAIN) {
+        QueuePush(&jobs->mainQueue, index);
+        CoreAtomicAdd(&jobs->mainQueued, 1);
+    } else {
+        QueuePush(&jobs->ready, index);
+        CoreAtomicAdd(&jobs->queued, 1);
+    }
+
+    Wake(jobs);
+}
+
+
+static void Finish(CoreJobs *jobs, int index) {
+
+    Slot *slot = &jobs->slots[index];
+
+    CoreMutexLock(&jobs->graph);
+
+    CoreAtomicAdd(&slot->generation, 1);
+
+    for (Edge *edge = slot->successors; edge != NULL; edge = edge->next) {
+        if (--jobs->slots[edge->job].pending == 0) MakeReady(jobs, edge->job);
+    }
+
+    // every job this one waited on is finished, so no list points into these
+    free(slot->edges);
+    slot->edges = NULL;
+    slot->successors = NULL;
+
+    slot->nextFree = jobs->freeSlot;
+    jobs->freeSlot = index;
+    CoreAtomicAdd(&jobs->live, -1);
+
+    CoreMutexUnlock(&jobs->graph);
+
+    Wake(jobs);
+}
+
+
+/*
+ * Runs one job this thread is allowed to: on the main thread the oldest
+ * main-only job first, then the oldest ready job. Returns false if there
+ * was nothing to run.
+ */
+static bool RunOne(CoreJobs *jobs) {
+
+    int index = -1;
+
+    if (IsMainThread(jobs) && CoreAtomicLoad(&jobs->mainQueued) > 0) {
+        index = QueueTake(&jobs->mainQueue);
+        if (index >= 0) CoreAtomicAdd(&jobs->mainQueued, -1);
+    }
+
+    if (index < 0 && CoreAtomicLoad(&jobs->queued) > 0) {
+        index = QueueTake(&jobs->ready);
+        if (index >= 0) CoreAtomicAdd(&jobs->queued, -1);
+    }
+
+    if (index < 0) return false;
+
+    Slot *slot = &jobs->slots[index];
+    if (slot->fn != NULL) slot->fn(slot->data);
+    Finish(jobs, index);
+
+    return true;
+}
+
+
+static void WorkerMain(void *arg) {
+
+    CoreJobs *jobs = arg;
+
+    for (;;) {
+        if (RunOne(jobs)) continue;
+
+        CoreMutexLock(&jobs->sleepLock);
+        while (!jobs->quit && !WorkQueued(jobs, false))
+            CoreCondWait(&jobs->wake, &jobs->sleepLock);
+        bool quit = jobs->quit;
+        CoreMutexUnlock(&jobs->sleepLock);
+
+        if (quit) return;
+    }
+}
+
+
+CoreJobs *CoreJobsCreate(int threadCount) {
+
+    if (threadCount <= 0) threadCount = CoreCpuCount();
+
+    CoreJobs *jobs = calloc(1, sizeof(*jobs));
+    if (jobs == NULL) return NULL;
+
+    jobs->threads = calloc(threadCount, sizeof(*jobs->threads));
+    if (jobs->threads == NULL) {
+        free(jobs);
+        return NULL;
+    }
+
+    CoreMutexInit(&jobs->ready.lock);
+    CoreMutexInit(&jobs->mainQueue.lock);
+    CoreMutexInit(&jobs->graph);
+    CoreMutexInit(&jobs->sleepLock);
+    CoreCondInit(&jobs->wake);
+
+    for (int i = 0; i < CORE_MAX_JOBS; i++) {
+        jobs->slots[i].generation = 1;
+        jobs->slots[i].nextFree = (i + 1 < CORE_MAX_JOBS) ? i + 1 : -1;
+    }
+    jobs->freeSlot = 0;
+
+    currentJobs = jobs;
+
+    jobs->threadCount = threadCount;
+    jobs->started = 1;
+    for (int i = 1; i < threadCount; i++) {
+        if (!CoreThreadStart(&jobs->threads[i], WorkerMain, jobs)) {
+            CoreJobsDestroy(jobs);
+            return NULL;
+        }
+        jobs->started++;
+    }
+
+    return jobs;
+}
+
+
+void CoreJobsDestroy(CoreJobs *jobs) {
+
+    if (jobs == NULL) return;
+
+    CoreMutexLock(&jobs->sleepLock);
+    jobs->quit = true;
+    CoreCondBroadcast(&jobs->wake);
+    CoreMutexUnlock(&jobs->sleepLock);
+
+    for (int i = 1; i < jobs->started; i++) CoreThreadJoin(jobs->threads[i]);
+
+    for (int i = 0; i < CORE_MAX_JOBS; i++) free(jobs->slots[i].edges);
+
+    if (currentJobs == jobs) currentJobs = NULL;
+
+    CoreCondDestroy(&jobs->wake);
+    CoreMutexDestroy(&jobs->sleepLock);
+    CoreMutexDestroy(&jobs->graph);
+    CoreMutexDestroy(&jobs->mainQueue.lock);
+    CoreMutexDestroy(&jobs->ready.lock);
+
+    free(jobs->threads);
+    free(jobs);
+}
+
+
+int CoreJobsThreadCount(const CoreJobs *jobs) {
+    return jobs->threadCount;
+}
+
+
+bool CoreJobsDone(const CoreJobs *jobs, CoreJob job) {
+
+    int index = JOB_INDEX(job);
+    if (job == 0 || index >= CORE_MAX_JOBS) return true;
+
+    int generation = CoreAtomicLoad((volatile int *)&jobs->slots[index].generation);
+    return (uint32_t)(generation & 0xFFFF) != JOB_GENERATION(job);
+}
+
+
+CoreJob CoreJobsAdd(CoreJobs *jobs, CoreJobFn fn, void *data, const CoreJob *after, int afterCount, unsigned flags) {
+
+    Edge *edges = NULL;
+    if (afterCount > 0) {
+        edges = malloc(afterCount * sizeof(*edges));
+        if (edges == NULL) return 0;
+    }
+
+    CoreMutexLock(&jobs->graph);
+
+    // out of slots: help finish what is queued until one comes free
+    while (jobs->freeSlot < 0) {
+        CoreMutexUnlock(&jobs->graph);
+
+        if (!RunOne(jobs)) {
+            const bool main = IsMainThread(jobs);
+            CoreMutexLock(&jobs->sleepLock);
+            while (CoreAtomicLoad(&jobs->live) >= CORE_MAX_JOBS && !WorkQueued(jobs, main))
+                CoreCondWait(&jobs->wake, &jobs->sleepLock);
+            CoreMutexUnlock(&jobs->sleepLock);
+        }
+
+        CoreMutexLock(&jobs->graph);
+    }
+
+    const int index = jobs->freeSlot;
+    Slot *slot = &jobs->slots[index];
+    jobs->freeSlot = slot->nextFree;
+    CoreAtomicAdd(&jobs->live, 1);
+
+    slot->fn = fn;
+    slot->data = data;
+    slot->flags = flags;
+    slot->pending = 1;
+    slot->successors = NULL;
+    slot->edges = edges;
+
+    const CoreJob job = ((uint32_t)(slot->generation & 0xFFFF) << 16) | (uint32_t)(index + 1);
+
+    for (int i = 0; i < afterCount; i++) {
+        if (CoreJobsDone(jobs, after[i])) continue;
+
+        Slot *before = &jobs->slots[JOB_INDEX(after[i])];
+        edges[i] = (Edge){ index, before->successors };
+        before->successors = &edges[i];
+        slot->pending++;
+    }
+
+    if (--slot->pending == 0) MakeReady(jobs, index);
+
+    CoreMutexUnlock(&jobs->graph);
+
+    return job;
+}
+
+
+void CoreJobsWait(CoreJobs *jobs, CoreJob job) {
+
+    const bool main = IsMainThread(jobs);
+
+    while (!CoreJobsDone(jobs, job)) {
+        if (RunOne(jobs)) continue;
+
+        CoreMutexLock(&jobs->sleepLock);
+        while (!CoreJobsDone(jobs, job) && !WorkQueued(jobs, main))
+            CoreCondWait(&jobs->wake, &jobs->sleepLock);
+        CoreMutexUnlock(&jobs->sleepLock);
+    }
+}
+
+
+int CoreJobsRunMain(CoreJobs *jobs) {
+
+    if (!IsMainThread(jobs)) return 0;
+
+    int count = 0;
+    while (CoreAtomicLoad(&jobs->mainQueued) > 0) {
+        int index = QueueTake(&jobs->mainQueue);
+        if (index < 0) break;
+        CoreAtomicAdd(&jobs->mainQueued, -1);
+
+        Slot *slot = &jobs->slots[index];
+        if (slot->fn != NULL) slot->fn(slot->data);
+        Finish(jobs, index);
+        count++;
+    }
+
+    return count;
+}
@@ -0,0 +1,125 @@
+#include <stdbool.h>
+
+#include "core/core_game.h"
+
+static const int PADDLE_INITIAL_INDEX = 1;
+static const int PADDLE_VEL = 600; // pixels per second
+
+// sizes must be ordered from smallest to largest
+static const int paddleSizes[CORE_PADDLE_COUNT] = { 40, 50, 70 };
+static const char *paddleDescriptions[CORE_PADDLE_COUNT] = { "Small", "Medium", "Huge" };
+
+
+int CorePaddlePositionY(const CoreGame *game)
+{
+	return CorePlayWall(&game->playArea, WALL_BOTTOM).y - DIST_BASE;
+}
+
+void CoreToggleReverse(CoreGame *game)
+{
+	game->paddle.reverse = !game->paddle.reverse;
+}
+
+void CoreMovePaddle(CoreGame *game, int direction, float dt)
+{
+	CorePaddle *paddle = &game->paddle;
+
+	// calculate the movement distance, adjusted for reverse flag
+	float distance = PADDLE_VEL * (paddle->reverse ? -1 : 1) * dt;
+
+	// apply the move based on direction
+	switch (direction)
+	{
+	case PADDLE_LEFT:
+		paddle->position -= distance;
+		break;
+	case PADDLE_RIGHT:
+		paddle->position += distance;
+		break;
+	}
+
+	// keep position within window boundries
+	float x = CorePlayWall(&game->playArea, WALL_LEFT).width;
+	if (paddle->position < x)
+		paddle->position = x;
+
+	float maxHPosition = CorePlayWall(&game->playArea, WALL_RIGHT).x - paddleSizes[paddle->index];
+	if (paddle->position > maxHPosition)
+		paddle->position = maxHPosition;
+}
+
+void CoreSetPaddlePosition(CoreGame *game, float x)
+{
+	// Clamp x to play area bounds
+	float minX = CorePlayWall(&game->playArea, WALL_LEFT).width;
+	float maxX = CorePlayWall(&game->playArea, WALL_RIGHT).x - paddleSizes[game->paddle.index];
+
+	if (x < minX)
+		x = minX;
+	if (x > maxX)
+		x = maxX;
+
+	game->paddle.position = x;
+}
+
+int CorePaddleSize(const CoreGame *game)
+{
+	return paddleSizes[game->paddle.index];
+}
+
+const char *CorePaddleDescription(const CoreGame *game)
+{
+	return paddleDescriptions[game->paddle.index];
+}
+
+CoreRect CorePaddleCollisionRec(const CoreGame *game)
+{
+	return (CoreRect){
+		game->paddle.position,
+		CorePaddlePositionY(game),
+		paddleSizes[game->paddle.index],
+		CORE_PADDLE_HEIGHT};
+}
+
+void CoreResetPaddle(CoreGame *game)
+{
+	// set size and center paddle
+	game->paddle.index = PADDLE_INITIAL_INDEX;
+	game->paddle.position = (game->playArea.screenWidth - paddleSizes[game->paddle.index]) / 2;
+	game->paddle.reverse = false;
+}
+
+void CoreChangePaddleSize(CoreGame *game, int changeDirection)
+{
+	CorePaddle *paddle = &game->paddle;
+
+	// capture the old pixel size
+	int oldSize = paddleSizes[paddle->index];
+
+	// adjust paddle index based on change in size
+	switch (changeDirection)
+	{
+	case SIZE_UP:
+		if (paddle->index < CORE_PADDLE_COUNT - 1)
+			paddle->index++;
+		break;
+
+	case SIZE_DOWN:
+		if (paddle->index > 0)
+			paddle->index--;
+		break;
+	}
+
+	// adjust position to center the change in size
+	paddle->position -= (paddleSizes[paddle->index] - oldSize) / 2;
+
+	// move to ensure resize remains inside window
+	CoreMovePaddle(game, PADDLE_NONE, 0.0f);
+}
+
+CoreVec2 CoreBallSpawnPointOnPaddle(const CoreGame *game)
+{
+	return (CoreVec2){
+		game->paddle.position + paddleSizes[game->paddle.index] / 2,
+		CorePaddlePositionY(game)};
+}
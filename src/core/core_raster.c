@@ -0,0 +1,110 @@
+#include <math.h>
+#include <string.h>
+
+#include "core/core_raster.h"
+
+const uint8_t CoreRasterGray[RASTER_KIND_COUNT] = {
+    [RASTER_EMPTY] = 0,
+    [RASTER_WALL] = 64,
+    [RASTER_BLOCK] = 128,
+    [RASTER_BLOCK_HARD] = 160,
+    [RASTER_BLOCK_SPECIAL] = 192,
+    [RASTER_BLOCK_SOLID] = 96,
+    [RASTER_PADDLE] = 224,
+    [RASTER_BALL] = 255
+};
+
+// the buffer and how screen coordinates map onto it
+typedef struct Raster {
+    uint8_t *pixels;
+    int width;
+    int height;
+    float scaleX;
+    float scaleY;
+} Raster;
+
+
+// Fills every pixel the screen rectangle touches
+static void FillRect(const Raster *raster, float x, float y, float width, float height, uint8_t value) {
+
+    int left = (int)floorf(x * raster->scaleX);
+    int top = (int)floorf(y * raster->scaleY);
+    int right = (int)ceilf((x + width) * raster->scaleX);
+    int bottom = (int)ceilf((y + height) * raster->scaleY);
+
+    if (left < 0) left = 0;
+    if (top < 0) top = 0;
+    if (right > raster->width) right = raster->width;
+    if (bottom > raster->height) bottom = raster->height;
+    if (left >= right) return;
+
+    for (int row = top; row < bottom; row++) {
+        memset(raster->pixels + (size_t)row * raster->width + left, value, right - left);
+    }
+}
+
+
+static RASTER_KINDS BlockKind(const CoreBlockGrid *grid, int row, int col) {
+
+    const CoreBlockType *info = CoreGetBlockType(grid->type[row][col]);
+
+    if (info->hitPoints == 0) return RASTER_BLOCK_SOLID;
+    if (info->effect != NULL) return RASTER_BLOCK_SPECIAL;
+    return grid->hits[row][col] > 1 ? RASTER_BLOCK_HARD : RASTER_BLOCK;
+}
+
+
+void CoreRasterize(const CoreGame *game, uint8_t *pixels, int width, int height, const uint8_t *palette) {
+
+    static const uint8_t kinds[RASTER_KIND_COUNT] = {
+        RASTER_EMPTY, RASTER_WALL, RASTER_BLOCK, RASTER_BLOCK_HARD,
+        RASTER_BLOCK_SPECIAL, RASTER_BLOCK_SOLID, RASTER_PADDLE, RASTER_BALL
+    };
+    if (palette == NULL) palette = kinds;
+
+    const CorePlayArea *playArea = &game->playArea;
+    if (width <= 0 || height <= 0 || playArea->screenWidth <= 0 || playArea->screenHeight <= 0) return;
+
+    const Raster raster = {
+        pixels, width, height,
+        (float)width / playArea->screenWidth,
+        (float)height / playArea->screenHeight
+    };
+
+    // walls all round, then the open play area inside them
+    memset(pixels, palette[RASTER_WALL], (size_t)width * height);
+
+    const float left = CorePlayWall(playArea, WALL_LEFT).width;
+    const float top = CorePlayWall(playArea, WALL_TOP).height;
+    const float right = CorePlayWall(playArea, WALL_RIGHT).x;
+    const float bottom = CorePlayWall(playArea, WALL_BOTTOM).y;
+
+    // inner edges rounded inward, so the open area never spills over a wall
+    int openLeft = (int)ceilf(left * raster.scaleX);
+    int openTop = (int)ceilf(top * raster.scaleY);
+    int openRight = (int)floorf(right * raster.scaleX);
+    int openBottom = (int)floorf(bottom * raster.scaleY);
+    if (openRight > width) openRight = width;
+    if (openBottom > height) openBottom = height;
+    for (int row = openTop; row < openBottom && openLeft < openRight; row++) {
+        memset(pixels + (size_t)row * width + openLeft, palette[RASTER_EMPTY], openRight - openLeft);
+    }
+
+    const CoreBlockGrid *grid = &game->grid;
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (uint32_t bits = grid->active[row]; bits; bits &= bits - 1) {
+            int col = CoreLowestBit(bits);
+            CoreRect hitbox = grid->hitbox[row][col];
+            FillRect(&raster, hitbox.x, hitbox.y, hitbox.width, hitbox.height, palette[BlockKind(grid, row, col)]);
+        }
+    }
+
+    CoreRect paddle = CorePaddleCollisionRec(game);
+    FillRect(&raster, paddle.x, paddle.y, paddle.width, paddle.height, palette[RASTER_PADDLE]);
+
+    const CoreBallPool *balls = &game->balls;
+    for (int i = 0; i < balls->count; i++) {
+        FillRect(&raster, RealToFloat(balls->x[i]), RealToFloat(balls->y[i]),
+                 CORE_BALL_WIDTH, CORE_BALL_HEIGHT, palette[RASTER_BALL]);
+    }
+}
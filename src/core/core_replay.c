@@ -0,0 +1,356 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_replay.h"
+#include "core/core_bytes.h"
+
+static const char REPLAY_MAGIC[4] = { 'X', 'B', 'R', 'P' };
+#define REPLAY_HEADER_SIZE 22
+#define REPLAY_FIXED_POINT 1    // header flag
+#define REPLAY_NAME_MAX    1024  // level file names, with the terminator
+
+// entry tags; a tick is REPLAY_TICK plus its control bits
+#define REPLAY_LEVEL 0x01       // u16 length, name
+#define REPLAY_LIFE  0x02
+#define REPLAY_QUIT  0x03
+#define REPLAY_TICK  0x80       // varint repeat count, then f32 x if absolute
+
+#define TICK_MOVE     0x03      // paddleMove
+#define TICK_ABSOLUTE 0x04
+#define TICK_RELEASE  0x08
+#define TICK_REVERSE  0x10
+#define TICK_SIZE     0x60      // paddleSizeChange
+#define TICK_SIZE_SHIFT 5
+
+
+// Only the parts of an input a tick can act on, so equal controls compare equal
+static CoreInput TickInput(const CoreInput *input) {
+    CoreInput tick = {0};
+    tick.paddleMove = input->paddleMove & TICK_MOVE;
+    tick.paddleAbsolute = input->paddleAbsolute;
+    tick.paddleX = input->paddleAbsolute ? input->paddleX : 0.0f;
+    tick.releaseBall = input->releaseBall;
+    tick.toggleReverse = input->toggleReverse;
+    tick.paddleSizeChange = input->paddleSizeChange & (TICK_SIZE >> TICK_SIZE_SHIFT);
+    return tick;
+}
+
+static bool SameInput(const CoreInput *a, const CoreInput *b) {
+    return a->paddleMove == b->paddleMove && a->paddleAbsolute == b->paddleAbsolute
+        && memcmp(&a->paddleX, &b->paddleX, sizeof(a->paddleX)) == 0
+        && a->releaseBall == b->releaseBall && a->toggleReverse == b->toggleReverse
+        && a->paddleSizeChange == b->paddleSizeChange;
+}
+
+
+static void Write(CoreRecorder *recorder, const unsigned char *bytes, size_t count) {
+    if (!recorder->failed && fwrite(bytes, 1, count, recorder->file) != count)
+        recorder->failed = true;
+}
+
+static void FlushRun(CoreRecorder *recorder) {
+
+    if (recorder->runLength == 0) return;
+
+    const CoreInput *input = &recorder->run;
+    unsigned char entry[16];
+    size_t size = 0;
+
+    entry[size++] = REPLAY_TICK | input->paddleMove
+        | (input->paddleAbsolute ? TICK_ABSOLUTE : 0)
+        | (input->releaseBall ? TICK_RELEASE : 0)
+        | (input->toggleReverse ? TICK_REVERSE : 0)
+        | (input->paddleSizeChange << TICK_SIZE_SHIFT);
+
+    for (uint32_t count = recorder->runLength; ; count >>= 7) {
+        if (count < 0x80) {
+            entry[size++] = count;
+            break;
+        }
+        entry[size++] = (count & 0x7f) | 0x80;
+    }
+
+    if (input->paddleAbsolute) {
+        CorePutF32(entry + size, input->paddleX);
+        size += 4;
+    }
+
+    Write(recorder, entry, size);
+    recorder->runLength = 0;
+}
+
+
+bool CoreRecorderOpen(CoreRecorder *recorder, const char *filename, const CoreGame *game) {
+
+    memset(recorder, 0, sizeof(*recorder));
+
+    recorder->file = fopen(filename, "wb");
+    if (recorder->file == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    unsigned char header[REPLAY_HEADER_SIZE] = {0};
+    memcpy(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    CorePutU16(header + 4, CORE_REPLAY_VERSION);
+    CorePutU16(header + 6, CORE_TICK_RATE);
+#ifdef CORE_FIXED_POINT
+    header[8] = REPLAY_FIXED_POINT;
+#endif
+    CorePutU16(header + 10, game->playArea.screenWidth);
+    CorePutU16(header + 12, game->playArea.screenHeight);
+    CorePutU64(header + 14, game->rng.state);
+
+    Write(recorder, header, sizeof(header));
+    return !recorder->failed;
+}
+
+
+void CoreRecorderLevel(CoreRecorder *recorder, const char *filename) {
+
+    size_t length = strlen(filename);
+    if (length >= REPLAY_NAME_MAX) {
+        recorder->failed = true;
+        return;
+    }
+
+    FlushRun(recorder);
+
+    unsigned char entry[3] = { REPLAY_LEVEL };
+    CorePutU16(entry + 1, length);
+    Write(recorder, entry, sizeof(entry));
+    Write(recorder, (const unsigned char *)filename, length);
+}
+
+
+void CoreRecorderLife(CoreRecorder *recorder) {
+    unsigned char entry = REPLAY_LIFE;
+    FlushRun(recorder);
+    Write(recorder, &entry, 1);
+}
+
+
+void CoreRecorderQuit(CoreRecorder *recorder) {
+    unsigned char entry = REPLAY_QUIT;
+    FlushRun(recorder);
+    Write(recorder, &entry, 1);
+}
+
+
+void CoreRecorderTick(CoreRecorder *recorder, const CoreInput *input) {
+
+    CoreInput tick = TickInput(input);
+
+    if (recorder->runLength > 0 && recorder->runLength < UINT32_MAX && SameInput(&tick, &recorder->run)) {
+        recorder->runLength++;
+        return;
+    }
+
+    FlushRun(recorder);
+    recorder->run = tick;
+    recorder->runLength = 1;
+}
+
+
+bool CoreRecorderClose(CoreRecorder *recorder) {
+
+    if (recorder->file == NULL) return false;
+
+    FlushRun(recorder);
+    if (fclose(recorder->file) != 0) recorder->failed = true;
+    recorder->file = NULL;
+
+    return !recorder->failed;
+}
+
+
+/*
+ * Reads the entry at *position. Returns its size, 0 if the data ends partway
+ * through it, or -1 if it is not an entry at all.
+ */
+static long ReadEntry(const unsigned char *data, size_t size, size_t position, CoreInput *input, uint32_t *repeat) {
+
+    const unsigned char *entry = data + position;
+    size_t left = size - position;
+    if (left == 0) return 0;
+
+    unsigned char tag = entry[0];
+
+    if (tag == REPLAY_LIFE || tag == REPLAY_QUIT) return 1;
+
+    if (tag == REPLAY_LEVEL) {
+        if (left < 3) return 0;
+        size_t length = CoreGetU16(entry + 1);
+        if (length >= REPLAY_NAME_MAX) return -1;
+        return left < 3 + length ? 0 : (long)(3 + length);
+    }
+
+    if (!(tag & REPLAY_TICK)) return -1;
+
+    size_t used = 1;
+    uint32_t count = 0;
+    for (int shift = 0; ; shift += 7) {
+        if (used == left) return 0;
+        if (shift > 28) return -1;
+        unsigned char byte = entry[used++];
+        count |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    if (count == 0) return -1;
+
+    CoreInput tick = {0};
+    tick.paddleMove = tag & TICK_MOVE;
+    tick.paddleAbsolute = (tag & TICK_ABSOLUTE) != 0;
+    tick.releaseBall = (tag & TICK_RELEASE) != 0;
+    tick.toggleReverse = (tag & TICK_REVERSE) != 0;
+    tick.paddleSizeChange = (tag & TICK_SIZE) >> TICK_SIZE_SHIFT;
+
+    if (tick.paddleAbsolute) {
+        if (left - used < 4) return 0;
+        tick.paddleX = CoreGetF32(entry + used);
+        used += 4;
+    }
+
+    if (input != NULL) *input = tick;
+    if (repeat != NULL) *repeat = count;
+    return used;
+}
+
+
+bool CoreReplayLoad(CoreReplay *replay, const char *filename) {
+
+    memset(replay, 0, sizeof(*replay));
+
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    unsigned char header[REPLAY_HEADER_SIZE];
+    bool valid = fread(header, 1, sizeof(header), fp) == sizeof(header)
+        && memcmp(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) == 0;
+
+    if (!valid || CoreGetU16(header + 4) != CORE_REPLAY_VERSION || CoreGetU16(header + 6) != CORE_TICK_RATE) {
+        fprintf(stderr, "%s: not a replay this build can play\n", filename);
+        fclose(fp);
+        return false;
+    }
+
+    replay->fixedPoint = (header[8] & REPLAY_FIXED_POINT) != 0;
+    replay->screenWidth = CoreGetU16(header + 10);
+    replay->screenHeight = CoreGetU16(header + 12);
+    replay->rngState = CoreGetU64(header + 14);
+
+    size_t capacity = 0;
+    for (;;) {
+        if (replay->size == capacity) {
+            capacity = capacity ? capacity * 2 : 4096;
+            unsigned char *data = realloc(replay->data, capacity);
+            if (data == NULL) {
+                CoreReplayFree(replay);
+                fclose(fp);
+                return false;
+            }
+            replay->data = data;
+        }
+        size_t count = fread(replay->data + replay->size, 1, capacity - replay->size, fp);
+        if (count == 0) break;
+        replay->size += count;
+    }
+    fclose(fp);
+
+    // check every entry now, so playing never meets a bad one
+    size_t position = 0;
+    for (;;) {
+        uint32_t repeat = 0;
+        long used = ReadEntry(replay->data, replay->size, position, NULL, &repeat);
+        if (used < 0) {
+            fprintf(stderr, "%s: bad entry at byte %zu\n", filename, REPLAY_HEADER_SIZE + position);
+            CoreReplayFree(replay);
+            return false;
+        }
+        if (used == 0) break;
+
+        position += used;
+        replay->ticks += repeat;
+    }
+    replay->size = position;
+
+#ifdef CORE_FIXED_POINT
+    bool fixedPoint = true;
+#else
+    bool fixedPoint = false;
+#endif
+    if (replay->fixedPoint != fixedPoint)
+        fprintf(stderr, "%s: recorded with %s physics, playing with %s; it will not play out the same\n",
+                filename, replay->fixedPoint ? "fixed-point" : "float", fixedPoint ? "fixed-point" : "float");
+
+    return true;
+}
+
+
+void CoreReplayFree(CoreReplay *replay) {
+    free(replay->data);
+    memset(replay, 0, sizeof(*replay));
+}
+
+
+// Plays entries until the next tick; false if a level failed to load
+static bool PlayControls(CoreReplay *replay, CoreGame *game) {
+
+    while (replay->repeat == 0 && replay->position < replay->size) {
+
+        const unsigned char *entry = replay->data + replay->position;
+        long used = ReadEntry(replay->data, replay->size, replay->position, &replay->input, &replay->repeat);
+        replay->position += used;
+
+        switch (entry[0]) {
+
+        case REPLAY_LEVEL: {
+            char filename[REPLAY_NAME_MAX];
+            size_t length = CoreGetU16(entry + 1);
+            memcpy(filename, entry + 3, length);
+            filename[length] = '\0';
+            if (!CoreGameNewLevel(game, filename)) return false;
+            break;
+        }
+
+        case REPLAY_LIFE:
+            CoreGameStartLife(game);
+            break;
+
+        case REPLAY_QUIT:
+            game->livesRemaining = 0;
+            game->mode = MODE_CANCEL;
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+bool CoreReplayStart(CoreReplay *replay, CoreGame *game) {
+
+    CoreGameInit(game, replay->screenWidth, replay->screenHeight);
+    game->rng.state = replay->rngState;
+
+    replay->position = 0;
+    replay->repeat = 0;
+    return PlayControls(replay, game);
+}
+
+
+bool CoreReplayStep(CoreReplay *replay, CoreGame *game) {
+
+    if (replay->repeat == 0) return false;
+
+    CoreGameStep(game, &replay->input, CORE_TICK_DT);
+    replay->repeat--;
+
+    PlayControls(replay, game);
+    return true;
+}
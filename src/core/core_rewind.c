@@ -0,0 +1,421 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_rewind.h"
+
+#define REWIND_KEYS 1024    // keyframes indexed at once; more and the oldest is dropped
+#define REWIND_ALIGN 8
+
+// A field that is copied whole whenever it changes, by where it sits in a CoreGame or CoreBallPool
+typedef struct RewindField {
+    size_t offset;
+    size_t size;
+} RewindField;
+
+#define GAME_FIELD(member) { offsetof(CoreGame, member), sizeof(((CoreGame *)0)->member) }
+#define BALL_FIELD(member) { offsetof(CoreBallPool, member), sizeof(((CoreBallPool *)0)->member[0]) }
+
+// everything outside the ball arrays and the block grid that changes during a level
+static const RewindField scalarFields[] = {
+    GAME_FIELD(rng.state),
+    GAME_FIELD(timeRemaining),
+    GAME_FIELD(timerActive),
+    GAME_FIELD(timerElapsed),
+    GAME_FIELD(livesRemaining),
+    GAME_FIELD(mode),
+    GAME_FIELD(paddle.position),
+    GAME_FIELD(paddle.index),
+    GAME_FIELD(paddle.reverse),
+    GAME_FIELD(balls.count),
+    GAME_FIELD(balls.sticky),
+    GAME_FIELD(balls.releaseAngle),
+    GAME_FIELD(balls.guideDirection),
+};
+
+static const RewindField ballFields[] = {
+    BALL_FIELD(x),
+    BALL_FIELD(y),
+    BALL_FIELD(vx),
+    BALL_FIELD(vy),
+    BALL_FIELD(speed),
+    BALL_FIELD(state),
+    BALL_FIELD(order),
+    BALL_FIELD(anchorX),
+    BALL_FIELD(anchorY),
+};
+
+#define SCALAR_COUNT (int)(sizeof(scalarFields) / sizeof(scalarFields[0]))
+#define BALL_FIELD_COUNT (int)(sizeof(ballFields) / sizeof(ballFields[0]))
+
+/*
+ * One captured tick. The payload follows in this order: the scalar fields
+ * in scalarMask, then ballCount entries of (u16 ball, u16 field mask,
+ * fields), then rowCount of (u8 row, u16 active), then hitCount of
+ * (u8 row, u8 col, u8 hits). A keyframe has every field of every ball.
+ */
+typedef struct RewindRecord {
+    unsigned long long tick;
+    uint32_t size;          // header and payload, to the next record
+    uint16_t scalarMask;
+    uint16_t ballCount;
+    uint8_t rowCount;
+    uint8_t hitCount;
+    bool key;
+} RewindRecord;
+
+typedef struct RewindKey {
+    size_t offset;
+    unsigned long long tick;
+} RewindKey;
+
+/*
+ * Records run from head to tail. When one does not fit before the end of
+ * the ring the rest go from the start, and wrapEnd marks where the first
+ * run stopped. Keyframes are dropped from the front, with their deltas, to
+ * make room.
+ */
+struct CoreRewind {
+    unsigned char *ring;
+    size_t capacity;
+    size_t maxRecord;       // a keyframe with every ball in play
+
+    size_t head;
+    size_t tail;
+    size_t wrapEnd;
+    bool wrapped;
+
+    RewindKey keys[REWIND_KEYS];
+    int firstKey;
+    int keyCount;
+
+    size_t groupBytes;      // since the newest keyframe
+    unsigned long long newest;
+
+    CoreGame last;          // what the newest record decodes to
+};
+
+
+static size_t AlignUp(size_t size) {
+    return (size + REWIND_ALIGN - 1) & ~(size_t)(REWIND_ALIGN - 1);
+}
+
+static const RewindKey *Key(const CoreRewind *rewind, int index) {
+    return &rewind->keys[(rewind->firstKey + index) % REWIND_KEYS];
+}
+
+
+CoreRewind *CoreRewindCreate(size_t bytes) {
+
+    size_t scalarBytes = 0;
+    for (int i = 0; i < SCALAR_COUNT; i++) scalarBytes += scalarFields[i].size;
+    size_t ballBytes = 4;
+    for (int i = 0; i < BALL_FIELD_COUNT; i++) ballBytes += ballFields[i].size;
+
+    size_t maxRecord = AlignUp(sizeof(RewindRecord) + scalarBytes + CORE_MAX_BALLS * ballBytes
+                               + CORE_ROW_MAX * 3 + CORE_ROW_MAX * CORE_COL_MAX * 3);
+
+    // room for several keyframe groups however many balls are in play
+    if (bytes == 0) bytes = CORE_REWIND_BYTES;
+    if (bytes < 8 * maxRecord) bytes = 8 * maxRecord;
+
+    CoreRewind *rewind = malloc(sizeof(*rewind));
+    if (rewind == NULL) return NULL;
+
+    rewind->ring = malloc(bytes);
+    if (rewind->ring == NULL) {
+        free(rewind);
+        return NULL;
+    }
+
+    rewind->capacity = bytes;
+    rewind->maxRecord = maxRecord;
+    CoreRewindClear(rewind);
+    return rewind;
+}
+
+
+void CoreRewindDestroy(CoreRewind *rewind) {
+    if (rewind == NULL) return;
+    free(rewind->ring);
+    free(rewind);
+}
+
+
+void CoreRewindClear(CoreRewind *rewind) {
+    rewind->head = 0;
+    rewind->tail = 0;
+    rewind->wrapEnd = 0;
+    rewind->wrapped = false;
+    rewind->firstKey = 0;
+    rewind->keyCount = 0;
+    rewind->groupBytes = 0;
+    rewind->newest = 0;
+}
+
+
+// Drops the oldest keyframe and its deltas; never the group still being written
+static bool DropOldest(CoreRewind *rewind) {
+
+    if (rewind->keyCount <= 1) return false;
+
+    rewind->firstKey = (rewind->firstKey + 1) % REWIND_KEYS;
+    rewind->keyCount--;
+
+    size_t head = Key(rewind, 0)->offset;
+    if (rewind->wrapped && head < rewind->head) rewind->wrapped = false;
+    rewind->head = head;
+    return true;
+}
+
+
+// Where a record of up to need bytes can go, making room if it must; SIZE_MAX if it cannot
+static size_t Reserve(CoreRewind *rewind, size_t need) {
+
+    for (;;) {
+        if (rewind->keyCount == 0) {
+            CoreRewindClear(rewind);
+            return 0;
+        }
+
+        if (!rewind->wrapped) {
+            if (rewind->capacity - rewind->tail >= need) return rewind->tail;
+            if (rewind->head > need) {
+                rewind->wrapEnd = rewind->tail;
+                rewind->wrapped = true;
+                return 0;
+            }
+        } else if (rewind->head - rewind->tail > need) {
+            return rewind->tail;
+        }
+
+        if (!DropOldest(rewind)) return SIZE_MAX;
+    }
+}
+
+
+// Writes what differs from rewind->last, or everything for a keyframe, and brings last up to date
+static size_t Encode(CoreRewind *rewind, const CoreGame *game, unsigned char *out, bool key) {
+
+    CoreGame *last = &rewind->last;
+    RewindRecord record = { .tick = game->tick, .key = key };
+    unsigned char *p = out + sizeof(record);
+
+    // balls past the old count hold leftovers, so new ones are written whole
+    int oldCount = key ? 0 : last->balls.count;
+
+    for (int i = 0; i < SCALAR_COUNT; i++) {
+        const unsigned char *now = (const unsigned char *)game + scalarFields[i].offset;
+        unsigned char *was = (unsigned char *)last + scalarFields[i].offset;
+        size_t size = scalarFields[i].size;
+
+        if (key || memcmp(now, was, size) != 0) {
+            record.scalarMask |= 1u << i;
+            memcpy(p, now, size);
+            memcpy(was, now, size);
+            p += size;
+        }
+    }
+
+    for (int ball = 0; ball < game->balls.count; ball++) {
+        unsigned char *entry = p;
+        uint16_t mask = 0;
+        p += 4;
+
+        for (int i = 0; i < BALL_FIELD_COUNT; i++) {
+            size_t size = ballFields[i].size;
+            size_t offset = ballFields[i].offset + ball * size;
+            const unsigned char *now = (const unsigned char *)&game->balls + offset;
+            unsigned char *was = (unsigned char *)&last->balls + offset;
+
+            if (ball >= oldCount || memcmp(now, was, size) != 0) {
+                mask |= 1u << i;
+                memcpy(p, now, size);
+                memcpy(was, now, size);
+                p += size;
+            }
+        }
+
+        if (mask == 0) {
+            p = entry;
+            continue;
+        }
+        uint16_t index = ball;
+        memcpy(entry, &index, 2);
+        memcpy(entry + 2, &mask, 2);
+        record.ballCount++;
+    }
+
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        if (key || game->grid.active[row] != last->grid.active[row]) {
+            p[0] = row;
+            memcpy(p + 1, &game->grid.active[row], 2);
+            last->grid.active[row] = game->grid.active[row];
+            p += 3;
+            record.rowCount++;
+        }
+    }
+
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (int col = 0; col < CORE_COL_MAX; col++) {
+            if (key || game->grid.hits[row][col] != last->grid.hits[row][col]) {
+                p[0] = row;
+                p[1] = col;
+                p[2] = game->grid.hits[row][col];
+                last->grid.hits[row][col] = game->grid.hits[row][col];
+                p += 3;
+                record.hitCount++;
+            }
+        }
+    }
+
+    last->tick = game->tick;
+
+    record.size = AlignUp(p - out);
+    memcpy(out, &record, sizeof(record));
+    return record.size;
+}
+
+
+// Applies a record to game; returns its header
+static RewindRecord Decode(const unsigned char *in, CoreGame *game) {
+
+    RewindRecord record;
+    memcpy(&record, in, sizeof(record));
+    const unsigned char *p = in + sizeof(record);
+
+    for (int i = 0; i < SCALAR_COUNT; i++) {
+        if (!(record.scalarMask & (1u << i))) continue;
+        memcpy((unsigned char *)game + scalarFields[i].offset, p, scalarFields[i].size);
+        p += scalarFields[i].size;
+    }
+
+    for (int entry = 0; entry < record.ballCount; entry++) {
+        uint16_t ball, mask;
+        memcpy(&ball, p, 2);
+        memcpy(&mask, p + 2, 2);
+        p += 4;
+
+        for (int i = 0; i < BALL_FIELD_COUNT; i++) {
+            if (!(mask & (1u << i))) continue;
+            size_t size = ballFields[i].size;
+            memcpy((unsigned char *)&game->balls + ballFields[i].offset + ball * size, p, size);
+            p += size;
+        }
+    }
+
+    for (int i = 0; i < record.rowCount; i++, p += 3) {
+        memcpy(&game->grid.active[p[0]], p + 1, 2);
+    }
+
+    for (int i = 0; i < record.hitCount; i++, p += 3) {
+        game->grid.hits[p[0]][p[1]] = p[2];
+    }
+
+    game->tick = record.tick;
+    return record;
+}
+
+
+void CoreRewindCapture(CoreRewind *rewind, const CoreGame *game) {
+
+    if (rewind->keyCount > 0 && game->tick <= rewind->newest) CoreRewindClear(rewind);
+
+    bool key = rewind->keyCount == 0
+        || game->tick - Key(rewind, rewind->keyCount - 1)->tick >= CORE_REWIND_KEY_TICKS
+        || rewind->groupBytes >= rewind->capacity / 4;
+
+    if (key && rewind->keyCount == REWIND_KEYS) DropOldest(rewind);
+
+    size_t at = Reserve(rewind, rewind->maxRecord);
+    if (at == SIZE_MAX) {
+        // only happens when one group fills the ring; start again from here
+        CoreRewindClear(rewind);
+        at = 0;
+        key = true;
+    }
+
+    size_t size = Encode(rewind, game, rewind->ring + at, key);
+
+    if (key) {
+        RewindKey *slot = &rewind->keys[(rewind->firstKey + rewind->keyCount) % REWIND_KEYS];
+        slot->offset = at;
+        slot->tick = game->tick;
+        rewind->keyCount++;
+        rewind->groupBytes = 0;
+    }
+
+    rewind->tail = at + size;
+    rewind->groupBytes += size;
+    rewind->newest = game->tick;
+}
+
+
+// The record after the one at offset, or SIZE_MAX at the newest
+static size_t NextRecord(const CoreRewind *rewind, size_t offset, size_t size) {
+    size_t next = offset + size;
+    if (next == rewind->tail) return SIZE_MAX;
+    if (rewind->wrapped && next == rewind->wrapEnd) return 0;
+    return next;
+}
+
+
+bool CoreRewindTo(CoreRewind *rewind, CoreGame *game, unsigned long long tick) {
+
+    if (rewind->keyCount == 0) return false;
+
+    // the newest keyframe not after tick, else the oldest there is
+    int key = rewind->keyCount - 1;
+    while (key > 0 && Key(rewind, key)->tick > tick) key--;
+
+    size_t offset = Key(rewind, key)->offset;
+    RewindRecord record = Decode(rewind->ring + offset, game);
+    rewind->groupBytes = record.size;
+
+    for (;;) {
+        size_t next = NextRecord(rewind, offset, record.size);
+        if (next == SIZE_MAX) break;
+
+        RewindRecord header;
+        memcpy(&header, rewind->ring + next, sizeof(header));
+        if (header.tick > tick) break;
+
+        offset = next;
+        record = Decode(rewind->ring + offset, game);
+        rewind->groupBytes += record.size;
+    }
+
+    // play carries on from here, so what came after is gone
+    if (rewind->wrapped && offset >= rewind->head) rewind->wrapped = false;
+    rewind->tail = offset + record.size;
+    rewind->keyCount = key + 1;
+    rewind->newest = record.tick;
+
+    // nothing to blend from, and no events belong to the restored tick
+    memcpy(game->balls.prevX, game->balls.x, game->balls.count * sizeof(game->balls.x[0]));
+    memcpy(game->balls.prevY, game->balls.y, game->balls.count * sizeof(game->balls.y[0]));
+    game->prev.paddlePosition = game->paddle.position;
+    CoreClearEvents(game);
+
+    rewind->last = *game;
+    return true;
+}
+
+
+unsigned long long CoreRewindOldest(const CoreRewind *rewind) {
+    return rewind->keyCount ? Key(rewind, 0)->tick : 0;
+}
+
+
+unsigned long long CoreRewindNewest(const CoreRewind *rewind) {
+    return rewind->newest;
+}
+
+
+size_t CoreRewindBytesUsed(const CoreRewind *rewind) {
+    if (rewind->keyCount == 0) return 0;
+    if (!rewind->wrapped) return rewind->tail - rewind->head;
+    return rewind->wrapEnd - rewind->head + rewind->tail;
+}
@@ -0,0 +1,39 @@
+#include <stdint.h>
+
+#include "core/core_rng.h"
+
+
+void CoreRngSeed(CoreRng *rng, uint64_t seed) {
+    rng->state = seed;
+}
+
+
+static uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+
+// splitmix64: any seed, including 0, gives a full period stream
+uint32_t CoreRngNext(CoreRng *rng) {
+    return (uint32_t)(Mix(rng->state += 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+
+uint64_t CoreRngNext64(CoreRng *rng) {
+    uint64_t high = CoreRngNext(rng);
+    uint64_t low = CoreRngNext(rng);
+    return high << 32 | low;
+}
+
+
+int CoreRngRange(CoreRng *rng, int count) {
+    return (int)(((uint64_t)CoreRngNext(rng) * (uint64_t)count) >> 32);
+}
+
+
+// hashing the stream number keeps neighbouring streams from sharing a sequence
+void CoreRngStream(CoreRng *rng, uint64_t seed, uint32_t stream) {
+    rng->state = seed ^ Mix(stream + 0xD1B54A32D192ED03ull);
+}
@@ -0,0 +1,89 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "core/core_run.h"
+
+
+static void BeginRun(CoreGame *game, CoreRunStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    CoreGameStartLife(game);
+    CoreClearEvents(game);
+}
+
+
+bool CoreRunStart(CoreGame *game, const char *levelFile, CoreRunStats *stats) {
+
+    if (!CoreGameNewLevel(game, levelFile)) {
+        memset(stats, 0, sizeof(*stats));
+        return false;
+    }
+
+    BeginRun(game, stats);
+    return true;
+}
+
+
+bool CoreRunStep(CoreGame *game, CoreInputFn input, void *context, CoreRunStats *stats) {
+
+    if (game->mode != MODE_PLAY) return false;
+
+    CoreInput controls = {0};
+    if (input != NULL) input(context, game, &controls);
+
+    CoreGameStep(game, &controls, CORE_TICK_DT);
+    stats->ticks++;
+
+    stats->tickEvents = CoreEventMask(game, 0);
+    CoreRunCountEvents(game, stats);
+    CoreClearEvents(game);
+
+    switch (game->mode) {
+
+    case MODE_WIN:
+        stats->cleared = true;
+        return false;
+
+    case MODE_LOSE:
+        stats->livesLost++;
+        if (game->livesRemaining <= 0) return false;
+        CoreGameStartLife(game);
+        return true;
+
+    case MODE_PLAY:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+
+void CoreRunGame(CoreGame *game, uint64_t seed, uint32_t stream, unsigned long long maxTicks,
+                 CoreInputFn input, void *context, CoreRunStats *stats) {
+
+    CoreRng rng;
+    CoreRngStream(&rng, seed, stream);
+    CoreGameSeed(game, CoreRngNext64(&rng));
+
+    BeginRun(game, stats);
+    while (stats->ticks < maxTicks && CoreRunStep(game, input, context, stats)) {
+    }
+}
+
+
+void CoreRunCountEvents(const CoreGame *game, CoreRunStats *stats) {
+
+    for (int i = 0; i < game->eventCount; i++) {
+        const CoreEvent *event = &game->events[i];
+        switch (event->type) {
+        case CORE_EVENT_BLOCK_HIT:
+            stats->blockHits++;
+            if (event->row >= 0 && event->row < CORE_ROW_MAX && event->col >= 0 && event->col < CORE_COL_MAX)
+                stats->blocksHit[event->row] |= 1u << event->col;
+            break;
+        case CORE_EVENT_PADDLE_HIT: stats->paddleHits++; break;
+        default: break;
+        }
+    }
+}
@@ -0,0 +1,523 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_save.h"
+#include "core/core_bytes.h"
+#include "core/core_thread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+static const char SAVE_MAGIC[4] = { 'X', 'B', 'S', 'V' };
+#define SAVE_HEADER_SIZE 24
+#define SAVE_FIXED_POINT 1      // header flag: CoreReal fields are Q16 in 8 bytes, not floats
+
+/*
+ * Header: magic, u16 version, u8 flags, u8 unused, u32 payload size,
+ * u64 checksum of everything else, u16 screen width, u16 screen height.
+ *
+ * Payload: level file and level name (u16 length, bytes); u64 tick and
+ * random state; timer, lives, mode; paddle; each row's active mask, then
+ * each cell's type and hits; ball count, sticky, guide; then per ball
+ * x, y, vx, vy, speed, state, order, anchorX, anchorY.
+ */
+
+#ifdef CORE_FIXED_POINT
+#define SAVE_REAL_FLAGS SAVE_FIXED_POINT
+#else
+#define SAVE_REAL_FLAGS 0
+#endif
+
+
+typedef struct SaveWriter {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    bool overflow;
+} SaveWriter;
+
+// Room for count bytes, at most 8; past the end, somewhere to write them that is thrown away
+static unsigned char *Put(SaveWriter *writer, size_t count) {
+    static unsigned char discard[8];
+    if (writer->size + count > writer->capacity) {
+        writer->overflow = true;
+        return discard;
+    }
+    unsigned char *at = writer->data + writer->size;
+    writer->size += count;
+    return at;
+}
+
+static void PutU8(SaveWriter *writer, unsigned value) { *Put(writer, 1) = value & 0xff; }
+static void PutU16(SaveWriter *writer, unsigned value) { CorePutU16(Put(writer, 2), value); }
+static void PutU32(SaveWriter *writer, uint32_t value) { CorePutU32(Put(writer, 4), value); }
+static void PutU64(SaveWriter *writer, uint64_t value) { CorePutU64(Put(writer, 8), value); }
+static void PutF32(SaveWriter *writer, float value) { CorePutF32(Put(writer, 4), value); }
+
+static void PutReal(SaveWriter *writer, CoreReal value) {
+#ifdef CORE_FIXED_POINT
+    PutU64(writer, (uint64_t)value);
+#else
+    PutF32(writer, value);
+#endif
+}
+
+static void PutString(SaveWriter *writer, const char *text) {
+    size_t length = strlen(text);
+    PutU16(writer, length);
+    if (writer->size + length > writer->capacity) {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(writer->data + writer->size, text, length);
+    writer->size += length;
+}
+
+
+typedef struct SaveReader {
+    const unsigned char *data;
+    size_t size;
+    size_t position;
+    bool fixedPoint;    // how the save's CoreReal fields are stored
+    bool bad;
+} SaveReader;
+
+static const unsigned char *Get(SaveReader *reader, size_t count) {
+    static const unsigned char zeros[8];
+    if (reader->size - reader->position < count) {
+        reader->bad = true;
+        return zeros;
+    }
+    const unsigned char *at = reader->data + reader->position;
+    reader->position += count;
+    return at;
+}
+
+static unsigned GetU8(SaveReader *reader) { return *Get(reader, 1); }
+static unsigned GetU16(SaveReader *reader) { return CoreGetU16(Get(reader, 2)); }
+static uint32_t GetU32(SaveReader *reader) { return CoreGetU32(Get(reader, 4)); }
+static uint64_t GetU64(SaveReader *reader) { return CoreGetU64(Get(reader, 8)); }
+static float GetF32(SaveReader *reader) { return CoreGetF32(Get(reader, 4)); }
+
+// in this build's CoreReal, whichever kind the save holds
+static CoreReal GetReal(SaveReader *reader) {
+    if (reader->fixedPoint) {
+        int64_t q16 = (int64_t)GetU64(reader);
+#ifdef CORE_FIXED_POINT
+        return q16;
+#else
+        return (float)(q16 / 65536.0);
+#endif
+    }
+    return RealFromFloat(GetF32(reader));
+}
+
+// copies into text when not NULL; a name too long for it is bad
+static void GetString(SaveReader *reader, char *text, size_t size) {
+    size_t length = GetU16(reader);
+    const unsigned char *bytes = Get(reader, length);
+    if (length >= size) {
+        reader->bad = true;
+        return;
+    }
+    if (text != NULL && !reader->bad) {
+        memcpy(text, bytes, length);
+        text[length] = '\0';
+    }
+}
+
+
+// FNV-1a over the whole save but the checksum itself, enough to tell a damaged file from a good one
+static uint64_t Checksum(const unsigned char *data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        if (i >= 12 && i < 20) continue;
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+
+bool CoreSaveCapture(CoreSave *save, const CoreGame *game, const char *levelFile) {
+
+    if (strlen(levelFile) >= CORE_SAVE_NAME_MAX) return false;
+
+    SaveWriter writer = { save->data, SAVE_HEADER_SIZE, sizeof(save->data), false };
+
+    PutString(&writer, levelFile);
+    PutString(&writer, game->levelName);
+
+    PutU64(&writer, game->tick);
+    PutU64(&writer, game->rng.state);
+    PutU32(&writer, (uint32_t)game->timeRemaining);
+    PutU8(&writer, game->timerActive);
+    PutF32(&writer, game->timerElapsed);
+    PutU32(&writer, (uint32_t)game->livesRemaining);
+    PutU8(&writer, game->mode);
+
+    PutF32(&writer, game->paddle.position);
+    PutU8(&writer, game->paddle.index);
+    PutU8(&writer, game->paddle.reverse);
+
+    const CoreBlockGrid *grid = &game->grid;
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        PutU16(&writer, grid->active[row]);
+    }
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (int col = 0; col < CORE_COL_MAX; col++) {
+            PutU8(&writer, (unsigned char)grid->type[row][col]);
+            PutU8(&writer, grid->hits[row][col]);
+        }
+    }
+
+    const CoreBallPool *balls = &game->balls;
+    PutU16(&writer, balls->count);
+    PutU8(&writer, balls->sticky);
+    PutU32(&writer, (uint32_t)balls->releaseAngle);
+    PutU8(&writer, balls->guideDirection < 0);
+
+    for (int i = 0; i < balls->count; i++) {
+        PutReal(&writer, balls->x[i]);
+        PutReal(&writer, balls->y[i]);
+        PutReal(&writer, balls->vx[i]);
+        PutReal(&writer, balls->vy[i]);
+        PutU32(&writer, (uint32_t)balls->speed[i]);
+        PutU8(&writer, balls->state[i]);
+        PutU16(&writer, balls->order[i]);
+        PutReal(&writer, balls->anchorX[i]);
+        PutReal(&writer, balls->anchorY[i]);
+    }
+
+    if (writer.overflow) return false;
+
+    size_t payload = writer.size - SAVE_HEADER_SIZE;
+    unsigned char *header = save->data;
+    memcpy(header, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+    CorePutU16(header + 4, CORE_SAVE_VERSION);
+    header[6] = SAVE_REAL_FLAGS;
+    header[7] = 0;
+    CorePutU32(header + 8, payload);
+    CorePutU16(header + 20, game->playArea.screenWidth);
+    CorePutU16(header + 22, game->playArea.screenHeight);
+    CorePutU64(header + 12, Checksum(save->data, writer.size));
+
+    save->size = writer.size;
+    return true;
+}
+
+
+bool CoreSaveWrite(const CoreSave *save, const char *filename) {
+
+    char temporary[CORE_SAVE_NAME_MAX + 8];
+    if (snprintf(temporary, sizeof(temporary), "%s.tmp", filename) >= (int)sizeof(temporary)) return false;
+
+    FILE *fp = fopen(temporary, "wb");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", temporary);
+        return false;
+    }
+
+    bool success = fwrite(save->data, 1, save->size, fp) == save->size;
+    if (fclose(fp) != 0) success = false;
+
+    if (success) {
+#if defined(_WIN32)
+        success = MoveFileExA(temporary, filename, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        success = rename(temporary, filename) == 0;
+#endif
+    }
+
+    if (!success) remove(temporary);
+    return success;
+}
+
+
+// Checks the header and returns a reader over the payload
+static bool OpenSave(const CoreSave *save, SaveReader *reader) {
+
+    const unsigned char *header = save->data;
+    if (save->size < SAVE_HEADER_SIZE || memcmp(header, SAVE_MAGIC, sizeof(SAVE_MAGIC)) != 0) return false;
+    if (CoreGetU16(header + 4) != CORE_SAVE_VERSION) return false;
+
+    size_t payload = CoreGetU32(header + 8);
+    if (payload != save->size - SAVE_HEADER_SIZE) return false;
+    if (CoreGetU64(header + 12) != Checksum(save->data, save->size)) return false;
+
+    *reader = (SaveReader){ save->data + SAVE_HEADER_SIZE, payload, 0, (header[6] & SAVE_FIXED_POINT) != 0, false };
+    return true;
+}
+
+
+bool CoreSaveRead(CoreSave *save, const char *filename) {
+
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    save->size = fread(save->data, 1, sizeof(save->data), fp);
+    bool whole = feof(fp) && !ferror(fp);
+    fclose(fp);
+
+    SaveReader reader;
+    if (!whole || !OpenSave(save, &reader)) {
+        fprintf(stderr, "%s: not a save this build can load\n", filename);
+        save->size = 0;
+        return false;
+    }
+    return true;
+}
+
+
+/*
+ * Reads the payload into game, or only checks it when game is NULL. Every
+ * value that indexes something is checked, so a save that passes can be
+ * restored without further tests.
+ */
+static bool ReadGame(SaveReader *reader, CoreGame *game, char *levelFile, size_t levelFileSize) {
+
+    CoreGame *out = game;
+    char levelName[sizeof(out->levelName)];
+
+    GetString(reader, levelFile, levelFile != NULL ? levelFileSize : CORE_SAVE_NAME_MAX);
+    GetString(reader, levelName, sizeof(levelName));
+
+    unsigned long long tick = GetU64(reader);
+    uint64_t rng = GetU64(reader);
+    int timeRemaining = (int32_t)GetU32(reader);
+    bool timerActive = GetU8(reader) != 0;
+    float timerElapsed = GetF32(reader);
+    int livesRemaining = (int32_t)GetU32(reader);
+    unsigned mode = GetU8(reader);
+
+    float paddlePosition = GetF32(reader);
+    unsigned paddleIndex = GetU8(reader);
+    bool reverse = GetU8(reader) != 0;
+
+    if (mode > MODE_EXIT || paddleIndex >= CORE_PADDLE_COUNT) return false;
+
+    if (out != NULL) {
+        CoreWorkers *workers = out->workers;
+        CoreGameInit(out, out->playArea.screenWidth, out->playArea.screenHeight);
+        CoreGameSetWorkers(out, workers);
+
+        memcpy(out->levelName, levelName, sizeof(levelName));
+        out->tick = tick;
+        out->rng.state = rng;
+        out->timeRemaining = timeRemaining;
+        out->timerActive = timerActive;
+        out->timerElapsed = timerElapsed;
+        out->livesRemaining = livesRemaining;
+        out->mode = mode;
+        out->paddle.position = paddlePosition;
+        out->paddle.index = paddleIndex;
+        out->paddle.reverse = reverse;
+        out->prev.paddlePosition = paddlePosition;
+    }
+
+    uint16_t active[CORE_ROW_MAX];
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        active[row] = GetU16(reader);
+        if (active[row] & ~CORE_ROW_MASK) return false;
+    }
+
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (int col = 0; col < CORE_COL_MAX; col++) {
+            char type = (char)GetU8(reader);
+            uint8_t hits = GetU8(reader);
+            if (out == NULL) continue;
+
+            // lays out the hitbox as loading the level did
+            CoreAddBlock(out, row, col, type);
+            out->grid.hits[row][col] = hits;
+        }
+    }
+
+    if (out != NULL) {
+        for (int row = 0; row < CORE_ROW_MAX; row++) {
+            out->grid.active[row] = active[row];
+        }
+    }
+
+    int count = GetU16(reader);
+    bool sticky = GetU8(reader) != 0;
+    CoreAngle releaseAngle = (int32_t)GetU32(reader);
+    int guideDirection = GetU8(reader) ? -1 : 1;
+
+    if (count > CORE_MAX_BALLS) return false;
+
+    CoreBallPool *balls = out != NULL ? &out->balls : NULL;
+    if (balls != NULL) {
+        balls->count = count;
+        balls->sticky = sticky;
+        balls->releaseAngle = releaseAngle;
+        balls->guideDirection = guideDirection;
+    }
+
+    for (int i = 0; i < count; i++) {
+        CoreReal x = GetReal(reader);
+        CoreReal y = GetReal(reader);
+        CoreReal vx = GetReal(reader);
+        CoreReal vy = GetReal(reader);
+        int speed = (int32_t)GetU32(reader);
+        unsigned state = GetU8(reader);
+        unsigned order = GetU16(reader);
+        CoreReal anchorX = GetReal(reader);
+        CoreReal anchorY = GetReal(reader);
+
+        if (state > BALL_LOST || (int)order >= count) return false;
+        if (balls == NULL) continue;
+
+        balls->x[i] = balls->prevX[i] = x;
+        balls->y[i] = balls->prevY[i] = y;
+        balls->vx[i] = vx;
+        balls->vy[i] = vy;
+        balls->speed[i] = speed;
+        balls->state[i] = state;
+        balls->order[i] = order;
+        balls->anchorX[i] = anchorX;
+        balls->anchorY[i] = anchorY;
+    }
+
+    return !reader->bad && reader->position == reader->size;
+}
+
+
+bool CoreSaveRestore(const CoreSave *save, CoreGame *game, char *levelFile, size_t levelFileSize) {
+
+    SaveReader reader;
+    if (!OpenSave(save, &reader)) return false;
+
+    // check everything before the game is touched
+    SaveReader check = reader;
+    if (!ReadGame(&check, NULL, NULL, 0)) return false;
+
+    if (levelFile != NULL && levelFileSize > 0) {
+        SaveReader name = reader;
+        size_t length = GetU16(&name);
+        if (length >= levelFileSize) return false;
+    }
+
+    int screenWidth = CoreGetU16(save->data + 20);
+    int screenHeight = CoreGetU16(save->data + 22);
+    if (screenWidth == 0 || screenHeight == 0) return false;
+
+    game->playArea.screenWidth = screenWidth;
+    game->playArea.screenHeight = screenHeight;
+    return ReadGame(&reader, game, levelFile, levelFileSize);
+}
+
+
+struct CoreAutosave {
+    char filename[CORE_SAVE_NAME_MAX];
+    CoreThread thread;
+    CoreMutex lock;
+    CoreCond wake;
+
+    // the submitter fills staging and swaps it with pending; the thread swaps pending with writing
+    CoreSave *staging;
+    CoreSave *pending;
+    CoreSave *writing;
+    bool hasPending;
+    bool quit;
+    bool failed;
+
+    CoreSave saves[3];
+};
+
+
+static void AutosaveMain(void *arg) {
+
+    CoreAutosave *autosave = arg;
+
+    CoreMutexLock(&autosave->lock);
+    for (;;) {
+        while (!autosave->hasPending && !autosave->quit) {
+            CoreCondWait(&autosave->wake, &autosave->lock);
+        }
+        if (!autosave->hasPending) break;
+
+        CoreSave *save = autosave->pending;
+        autosave->pending = autosave->writing;
+        autosave->writing = save;
+        autosave->hasPending = false;
+
+        CoreMutexUnlock(&autosave->lock);
+        bool written = CoreSaveWrite(save, autosave->filename);
+        CoreMutexLock(&autosave->lock);
+
+        if (!written) autosave->failed = true;
+    }
+    CoreMutexUnlock(&autosave->lock);
+}
+
+
+CoreAutosave *CoreAutosaveStart(const char *filename) {
+
+    if (strlen(filename) >= CORE_SAVE_NAME_MAX) return NULL;
+
+    CoreAutosave *autosave = calloc(1, sizeof(*autosave));
+    if (autosave == NULL) return NULL;
+
+    strcpy(autosave->filename, filename);
+    autosave->staging = &autosave->saves[0];
+    autosave->pending = &autosave->saves[1];
+    autosave->writing = &autosave->saves[2];
+
+    CoreMutexInit(&autosave->lock);
+    CoreCondInit(&autosave->wake);
+
+    if (!CoreThreadStart(&autosave->thread, AutosaveMain, autosave)) {
+        CoreCondDestroy(&autosave->wake);
+        CoreMutexDestroy(&autosave->lock);
+        free(autosave);
+        return NULL;
+    }
+
+    return autosave;
+}
+
+
+void CoreAutosaveSubmit(CoreAutosave *autosave, const CoreGame *game, const char *levelFile) {
+
+    // encoded outside the lock; only the hand over waits on the thread
+    if (!CoreSaveCapture(autosave->staging, game, levelFile)) {
+        CoreMutexLock(&autosave->lock);
+        autosave->failed = true;
+        CoreMutexUnlock(&autosave->lock);
+        return;
+    }
+
+    CoreMutexLock(&autosave->lock);
+    CoreSave *save = autosave->pending;
+    autosave->pending = autosave->staging;
+    autosave->staging = save;
+    autosave->hasPending = true;
+    CoreCondSignal(&autosave->wake);
+    CoreMutexUnlock(&autosave->lock);
+}
+
+
+bool CoreAutosaveStop(CoreAutosave *autosave) {
+
+    if (autosave == NULL) return true;
+
+    CoreMutexLock(&autosave->lock);
+    autosave->quit = true;
+    CoreCondSignal(&autosave->wake);
+    CoreMutexUnlock(&autosave->lock);
+
+    CoreThreadJoin(autosave->thread);
+
+    bool success = !autosave->failed;
+    CoreCondDestroy(&autosave->wake);
+    CoreMutexDestroy(&autosave->lock);
+    free(autosave);
+    return success;
+}
@@ -0,0 +1,132 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_script.h"
+
+typedef enum {
+    SCRIPT_RELEASE,
+    SCRIPT_LEFT,
+    SCRIPT_RIGHT,
+    SCRIPT_STOP,
+    SCRIPT_MOVETO,
+    SCRIPT_REVERSE,
+    SCRIPT_GROW,
+    SCRIPT_SHRINK
+} SCRIPT_ACTIONS;
+
+static const char *actionNames[] = {
+    [SCRIPT_RELEASE] = "release",
+    [SCRIPT_LEFT] = "left",
+    [SCRIPT_RIGHT] = "right",
+    [SCRIPT_STOP] = "stop",
+    [SCRIPT_MOVETO] = "moveto",
+    [SCRIPT_REVERSE] = "reverse",
+    [SCRIPT_GROW] = "grow",
+    [SCRIPT_SHRINK] = "shrink",
+};
+
+
+bool CoreScriptLoad(CoreScript *script, const char *filename) {
+
+    memset(script, 0, sizeof(*script));
+
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    bool success = true;
+    char line[256];
+    int lineNumber = 0;
+    int capacity = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNumber++;
+
+        unsigned long long tick;
+        char name[32];
+        float x = 0;
+
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+        int fields = sscanf(line, " %llu %31s %f", &tick, name, &x);
+        if (fields < 2) {
+            fprintf(stderr, "%s:%d: bad script line\n", filename, lineNumber);
+            success = false;
+            continue;
+        }
+
+        int action;
+        int actionCount = sizeof(actionNames) / sizeof(actionNames[0]);
+        for (action = 0; action < actionCount; action++) {
+            if (strcmp(name, actionNames[action]) == 0) break;
+        }
+        if (action == actionCount) {
+            fprintf(stderr, "%s:%d: unknown action '%s'\n", filename, lineNumber, name);
+            success = false;
+            continue;
+        }
+        if (action == SCRIPT_MOVETO && fields < 3) {
+            fprintf(stderr, "%s:%d: moveto needs an x position\n", filename, lineNumber);
+            success = false;
+            continue;
+        }
+        if (script->count > 0 && tick < script->lines[script->count - 1].tick) {
+            fprintf(stderr, "%s:%d: tick goes backwards\n", filename, lineNumber);
+            success = false;
+            continue;
+        }
+
+        if (script->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            CoreScriptLine *lines = realloc(script->lines, capacity * sizeof(*lines));
+            if (lines == NULL) {
+                success = false;
+                break;
+            }
+            script->lines = lines;
+        }
+        script->lines[script->count++] = (CoreScriptLine){ tick, action, x };
+    }
+
+    fclose(fp);
+
+    if (!success) CoreScriptFree(script);
+    return success;
+}
+
+
+void CoreScriptFree(CoreScript *script) {
+    free(script->lines);
+    memset(script, 0, sizeof(*script));
+}
+
+
+void CoreScriptInput(void *context, const CoreGame *game, CoreInput *input) {
+
+    CoreScript *script = context;
+
+    // lines whose tick has passed are played now rather than lost
+    while (script->next < script->count && script->lines[script->next].tick <= game->tick) {
+        const CoreScriptLine *line = &script->lines[script->next++];
+
+        switch (line->action) {
+        case SCRIPT_RELEASE: input->releaseBall = true; break;
+        case SCRIPT_LEFT:    script->paddleMove = PADDLE_LEFT; break;
+        case SCRIPT_RIGHT:   script->paddleMove = PADDLE_RIGHT; break;
+        case SCRIPT_STOP:    script->paddleMove = PADDLE_NONE; break;
+        case SCRIPT_REVERSE: input->toggleReverse = true; break;
+        case SCRIPT_GROW:    input->paddleSizeChange = SIZE_UP; break;
+        case SCRIPT_SHRINK:  input->paddleSizeChange = SIZE_DOWN; break;
+        case SCRIPT_MOVETO:
+            input->paddleAbsolute = true;
+            input->paddleX = line->x;
+            break;
+        }
+    }
+
+    input->paddleMove = script->paddleMove;
+}
@@ -0,0 +1,184 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/core_simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CORE_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define CORE_SIMD_X86 0
+#endif
+
+// GCC and clang only emit vector instructions in functions marked for them
+#if CORE_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+typedef uint32_t (*OverlapRowFn)(CoreRect box, const float *left, const float *top, const float *right, const float *bottom);
+
+static uint32_t OverlapRowResolve(CoreRect box, const float *left, const float *top, const float *right, const float *bottom);
+
+static volatile OverlapRowFn overlapRow = OverlapRowResolve;
+
+// Games on several threads may resolve the kernel at once. They all store
+// the same pointer, but the stores and loads must still be atomic.
+#if defined(_MSC_VER)
+// aligned pointer-sized volatile accesses are atomic there
+#define KERNEL_LOAD(kernel)         (kernel)
+#define KERNEL_STORE(kernel, value) ((kernel) = (value))
+#else
+#define KERNEL_LOAD(kernel)         __atomic_load_n(&kernel, __ATOMIC_RELAXED)
+#define KERNEL_STORE(kernel, value) __atomic_store_n(&kernel, value, __ATOMIC_RELAXED)
+#endif
+
+
+static uint32_t OverlapRowScalar(CoreRect box, const float *left, const float *top, const float *right, const float *bottom) {
+
+    const float boxRight = box.x + box.width;
+    const float boxBottom = box.y + box.height;
+    uint32_t mask = 0;
+
+    for (int i = 0; i < CORE_SIMD_ROW; i++) {
+        if (box.x <= right[i] && boxRight >= left[i] && box.y <= bottom[i] && boxBottom >= top[i])
+            mask |= 1u << i;
+    }
+
+    return mask;
+}
+
+
+#if CORE_SIMD_X86
+
+TARGET_SSE2 static uint32_t OverlapRowSSE2(CoreRect box, const float *left, const float *top, const float *right, const float *bottom) {
+
+    const __m128 boxLeft = _mm_set1_ps(box.x);
+    const __m128 boxTop = _mm_set1_ps(box.y);
+    const __m128 boxRight = _mm_set1_ps(box.x + box.width);
+    const __m128 boxBottom = _mm_set1_ps(box.y + box.height);
+    uint32_t mask = 0;
+
+    for (int i = 0; i < CORE_SIMD_ROW; i += 4) {
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(boxLeft, _mm_loadu_ps(right + i)),
+                                _mm_cmpge_ps(boxRight, _mm_loadu_ps(left + i)));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(boxTop, _mm_loadu_ps(bottom + i)));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(boxBottom, _mm_loadu_ps(top + i)));
+        mask |= (uint32_t)_mm_movemask_ps(hit) << i;
+    }
+
+    return mask;
+}
+
+
+TARGET_AVX2 static uint32_t OverlapRowAVX2(CoreRect box, const float *left, const float *top, const float *right, const float *bottom) {
+
+    const __m256 boxLeft = _mm256_set1_ps(box.x);
+    const __m256 boxTop = _mm256_set1_ps(box.y);
+    const __m256 boxRight = _mm256_set1_ps(box.x + box.width);
+    const __m256 boxBottom = _mm256_set1_ps(box.y + box.height);
+    uint32_t mask = 0;
+
+    for (int i = 0; i < CORE_SIMD_ROW; i += 8) {
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(boxLeft, _mm256_loadu_ps(right + i), _CMP_LE_OQ),
+                                   _mm256_cmp_ps(boxRight, _mm256_loadu_ps(left + i), _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(boxTop, _mm256_loadu_ps(bottom + i), _CMP_LE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(boxBottom, _mm256_loadu_ps(top + i), _CMP_GE_OQ));
+        mask |= (uint32_t)_mm256_movemask_ps(hit) << i;
+    }
+
+    return mask;
+}
+
+
+static bool CpuHasSSE2(void) {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;    // part of the x86-64 baseline
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+
+static bool CpuHasAVX2(void) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // CORE_SIMD_X86
+
+
+CoreSimdLevel CoreSimdBest(void) {
+#if CORE_SIMD_X86
+    if (CpuHasAVX2()) return CORE_SIMD_AVX2;
+    if (CpuHasSSE2()) return CORE_SIMD_SSE2;
+#endif
+    return CORE_SIMD_SCALAR;
+}
+
+
+bool CoreSimdUse(CoreSimdLevel level) {
+
+    switch (level) {
+
+    case CORE_SIMD_SCALAR:
+        KERNEL_STORE(overlapRow, OverlapRowScalar);
+        return true;
+
+#if CORE_SIMD_X86
+    case CORE_SIMD_SSE2:
+        if (!CpuHasSSE2()) return false;
+        KERNEL_STORE(overlapRow, OverlapRowSSE2);
+        return true;
+
+    case CORE_SIMD_AVX2:
+        if (!CpuHasAVX2()) return false;
+        KERNEL_STORE(overlapRow, OverlapRowAVX2);
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+
+const char *CoreSimdName(CoreSimdLevel level) {
+    switch (level) {
+        case CORE_SIMD_SSE2: return "sse2";
+        case CORE_SIMD_AVX2: return "avx2";
+        default:             return "scalar";
+    }
+}
+
+
+// the first call picks the implementation
+static uint32_t OverlapRowResolve(CoreRect box, const float *left, const float *top, const float *right, const float *bottom) {
+    CoreSimdUse(CoreSimdBest());
+    return KERNEL_LOAD(overlapRow)(box, left, top, right, bottom);
+}
+
+
+uint32_t CoreOverlapRow(CoreRect box, const float *left, const float *top, const float *right, const float *bottom) {
+    return KERNEL_LOAD(overlapRow)(box, left, top, right, bottom);
+}
+
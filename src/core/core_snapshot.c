@@ -0,0 +1,118 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "core/core_thread.h"
+#include "core/core_snapshot.h"
+
+#define SNAPSHOT_SLOT  3
+#define SNAPSHOT_FRESH 4
+
+// queue positions count to twice the size, so full and empty differ
+#define QUEUE_WRAP (2 * CORE_EVENT_QUEUE_SIZE - 1)
+
+
+void CoreSnapshotCapture(CoreSnapshot *snapshot, const CoreGame *game) {
+
+    const CoreBlockGrid *grid = &game->grid;
+    const CoreBallPool *balls = &game->balls;
+
+    snapshot->tick = game->tick;
+    snapshot->mode = game->mode;
+    snapshot->playArea = game->playArea;
+
+    memcpy(snapshot->active, grid->active, sizeof(snapshot->active));
+    memcpy(snapshot->type, grid->type, sizeof(snapshot->type));
+    memcpy(snapshot->hits, grid->hits, sizeof(snapshot->hits));
+    memcpy(snapshot->hitbox, grid->hitbox, sizeof(snapshot->hitbox));
+    snapshot->blocksRemaining = CoreBlocksRemaining(game);
+
+    snapshot->ballCount = balls->count;
+    for (int i = 0; i < balls->count; i++) {
+        snapshot->ballPosition[i] = (CoreVec2){ RealToFloat(balls->x[i]), RealToFloat(balls->y[i]) };
+        snapshot->ballPrevious[i] = (CoreVec2){ RealToFloat(balls->prevX[i]), RealToFloat(balls->prevY[i]) };
+    }
+    memcpy(snapshot->ballState, balls->state, balls->count * sizeof(balls->state[0]));
+    snapshot->releaseAngle = balls->releaseAngle;
+
+    snapshot->paddlePosition = game->paddle.position;
+    snapshot->paddlePrevious = game->prev.paddlePosition;
+    snapshot->paddleY = CorePaddlePositionY(game);
+    snapshot->paddleIndex = game->paddle.index;
+    snapshot->reverse = game->paddle.reverse;
+
+    snapshot->livesRemaining = game->livesRemaining;
+    snapshot->timeRemaining = game->timeRemaining;
+}
+
+
+CoreVec2 CoreSnapshotBallPosition(const CoreSnapshot *snapshot, int ball, float alpha) {
+    CoreVec2 from = snapshot->ballPrevious[ball];
+    CoreVec2 to = snapshot->ballPosition[ball];
+    return (CoreVec2){ from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha };
+}
+
+
+float CoreSnapshotPaddlePosition(const CoreSnapshot *snapshot, float alpha) {
+    return snapshot->paddlePrevious + (snapshot->paddlePosition - snapshot->paddlePrevious) * alpha;
+}
+
+
+void CoreSnapshotBufferInit(CoreSnapshotBuffer *buffer) {
+    memset(buffer->slots, 0, sizeof(buffer->slots));
+    buffer->front = 0;
+    buffer->middle = 1;
+    buffer->back = 2;
+}
+
+
+CoreSnapshot *CoreSnapshotWriteSlot(CoreSnapshotBuffer *buffer) {
+    return &buffer->slots[buffer->back];
+}
+
+
+void CoreSnapshotPublish(CoreSnapshotBuffer *buffer) {
+    buffer->back = CoreAtomicExchange(&buffer->middle, buffer->back | SNAPSHOT_FRESH) & SNAPSHOT_SLOT;
+}
+
+
+const CoreSnapshot *CoreSnapshotRead(CoreSnapshotBuffer *buffer, bool *fresh) {
+
+    bool swapped = false;
+
+    // only swap for something new, or the reader would take back its own old slot
+    if (CoreAtomicLoad(&buffer->middle) & SNAPSHOT_FRESH) {
+        buffer->front = CoreAtomicExchange(&buffer->middle, buffer->front) & SNAPSHOT_SLOT;
+        swapped = true;
+    }
+
+    if (fresh != NULL) *fresh = swapped;
+    return &buffer->slots[buffer->front];
+}
+
+
+void CoreEventQueueInit(CoreEventQueue *queue) {
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+
+bool CoreEventQueuePush(CoreEventQueue *queue, const CoreEvent *event) {
+
+    int tail = queue->tail;  // only this thread writes it
+    if (((tail - CoreAtomicLoad(&queue->head)) & QUEUE_WRAP) == CORE_EVENT_QUEUE_SIZE) return false;
+
+    queue->events[tail & (CORE_EVENT_QUEUE_SIZE - 1)] = *event;
+    CoreAtomicStore(&queue->tail, (tail + 1) & QUEUE_WRAP);
+    return true;
+}
+
+
+bool CoreEventQueuePop(CoreEventQueue *queue, CoreEvent *event) {
+
+    int head = queue->head;  // only this thread writes it
+    if (head == CoreAtomicLoad(&queue->tail)) return false;
+
+    *event = queue->events[head & (CORE_EVENT_QUEUE_SIZE - 1)];
+    CoreAtomicStore(&queue->head, (head + 1) & QUEUE_WRAP);
+    return true;
+}
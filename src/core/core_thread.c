@@ -0,0 +1,144 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "core/core_thread.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+    CoreThreadFn fn;
+    void *arg;
+} ThreadStart;
+
+
+#if defined(_WIN32)
+
+static unsigned __stdcall ThreadMain(void *param) {
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    start.fn(start.arg);
+    return 0;
+}
+
+
+bool CoreThreadStart(CoreThread *thread, CoreThreadFn fn, void *arg) {
+
+    ThreadStart *start = malloc(sizeof(*start));
+    if (start == NULL) return false;
+    *start = (ThreadStart){ fn, arg };
+
+    uintptr_t handle = _beginthreadex(NULL, 0, ThreadMain, start, 0, NULL);
+    if (handle == 0) {
+        free(start);
+        return false;
+    }
+
+    *thread = (HANDLE)handle;
+    return true;
+}
+
+
+void CoreThreadJoin(CoreThread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+
+int CoreCpuCount(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0) ? (int)info.dwNumberOfProcessors : 1;
+}
+
+
+double CoreTimeNow(void) {
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double)count.QuadPart / (double)frequency.QuadPart;
+}
+
+
+void CoreSleep(double seconds) {
+    if (seconds > 0.0) Sleep((DWORD)(seconds * 1000.0));
+}
+
+
+void CoreMutexInit(CoreMutex *mutex) { InitializeCriticalSection(mutex); }
+void CoreMutexDestroy(CoreMutex *mutex) { DeleteCriticalSection(mutex); }
+void CoreMutexLock(CoreMutex *mutex) { EnterCriticalSection(mutex); }
+void CoreMutexUnlock(CoreMutex *mutex) { LeaveCriticalSection(mutex); }
+
+void CoreCondInit(CoreCond *cond) { InitializeConditionVariable(cond); }
+void CoreCondDestroy(CoreCond *cond) { (void)cond; }
+void CoreCondWait(CoreCond *cond, CoreMutex *mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void CoreCondSignal(CoreCond *cond) { WakeConditionVariable(cond); }
+void CoreCondBroadcast(CoreCond *cond) { WakeAllConditionVariable(cond); }
+
+#else
+
+static void *ThreadMain(void *param) {
+    ThreadStart start = *(ThreadStart *)param;
+    free(param);
+    start.fn(start.arg);
+    return NULL;
+}
+
+
+bool CoreThreadStart(CoreThread *thread, CoreThreadFn fn, void *arg) {
+
+    ThreadStart *start = malloc(sizeof(*start));
+    if (start == NULL) return false;
+    *start = (ThreadStart){ fn, arg };
+
+    if (pthread_create(thread, NULL, ThreadMain, start) != 0) {
+        free(start);
+        return false;
+    }
+
+    return true;
+}
+
+
+void CoreThreadJoin(CoreThread thread) {
+    pthread_join(thread, NULL);
+}
+
+
+int CoreCpuCount(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+}
+
+
+double CoreTimeNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+
+void CoreSleep(double seconds) {
+    if (seconds <= 0.0) return;
+    struct timespec wait = { (time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9) };
+    nanosleep(&wait, NULL);
+}
+
+
+void CoreMutexInit(CoreMutex *mutex) { pthread_mutex_init(mutex, NULL); }
+void CoreMutexDestroy(CoreMutex *mutex) { pthread_mutex_destroy(mutex); }
+void CoreMutexLock(CoreMutex *mutex) { pthread_mutex_lock(mutex); }
+void CoreMutexUnlock(CoreMutex *mutex) { pthread_mutex_unlock(mutex); }
+
+void CoreCondInit(CoreCond *cond) { pthread_cond_init(cond, NULL); }
+void CoreCondDestroy(CoreCond *cond) { pthread_cond_destroy(cond); }
+void CoreCondWait(CoreCond *cond, CoreMutex *mutex) { pthread_cond_wait(cond, mutex); }
+void CoreCondSignal(CoreCond *cond) { pthread_cond_signal(cond); }
+void CoreCondBroadcast(CoreCond *cond) { pthread_cond_broadcast(cond); }
+
+#endif
@@ -0,0 +1,162 @@
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "core/core_thread.h"
+#include "core/core_workers.h"
+
+typedef struct {
+    CoreWorkers *workers;
+    int index;
+} Helper;
+
+struct CoreWorkers {
+    int count;              // threads including the caller
+    CoreThread *threads;
+    Helper *helpers;
+
+    CoreMutex lock;
+    CoreCond wake;          // a new batch of work, or quit
+    CoreCond idle;          // the last helper finished
+    unsigned generation;
+    int busy;               // helpers still on the current run
+    bool quit;
+
+    // the current run
+    CoreRangeFn fn;
+    void *context;
+    int total;
+    int grain;
+    volatile int next;      // first item not yet claimed
+};
+
+
+// claim and run batches until the range is used up
+static void Drain(CoreWorkers *workers, int worker) {
+
+    for (;;) {
+        int begin = CoreAtomicAdd(&workers->next, workers->grain);
+        if (begin >= workers->total) return;
+
+        int end = begin + workers->grain;
+        if (end > workers->total) end = workers->total;
+
+        workers->fn(workers->context, worker, begin, end);
+    }
+}
+
+
+static void HelperMain(void *arg) {
+
+    Helper *helper = arg;
+    CoreWorkers *workers = helper->workers;
+    unsigned seen = 0;
+
+    CoreMutexLock(&workers->lock);
+
+    for (;;) {
+        while (workers->generation == seen && !workers->quit)
+            CoreCondWait(&workers->wake, &workers->lock);
+
+        if (workers->quit) break;
+        seen = workers->generation;
+
+        CoreMutexUnlock(&workers->lock);
+        Drain(workers, helper->index);
+        CoreMutexLock(&workers->lock);
+
+        if (--workers->busy == 0) CoreCondSignal(&workers->idle);
+    }
+
+    CoreMutexUnlock(&workers->lock);
+}
+
+
+CoreWorkers *CoreWorkersCreate(int threadCount) {
+
+    if (threadCount <= 0) threadCount = CoreCpuCount();
+
+    CoreWorkers *workers = calloc(1, sizeof(*workers));
+    if (workers == NULL) return NULL;
+
+    workers->threads = calloc(threadCount, sizeof(*workers->threads));
+    workers->helpers = calloc(threadCount, sizeof(*workers->helpers));
+    if (workers->threads == NULL || workers->helpers == NULL) {
+        free(workers->threads);
+        free(workers->helpers);
+        free(workers);
+        return NULL;
+    }
+
+    CoreMutexInit(&workers->lock);
+    CoreCondInit(&workers->wake);
+    CoreCondInit(&workers->idle);
+
+    // the caller is worker 0; count grows as helpers start
+    workers->count = 1;
+    for (int i = 1; i < threadCount; i++) {
+        workers->helpers[i] = (Helper){ workers, i };
+        if (!CoreThreadStart(&workers->threads[i], HelperMain, &workers->helpers[i])) {
+            CoreWorkersDestroy(workers);
+            return NULL;
+        }
+        workers->count++;
+    }
+
+    return workers;
+}
+
+
+void CoreWorkersDestroy(CoreWorkers *workers) {
+
+    if (workers == NULL) return;
+
+    CoreMutexLock(&workers->lock);
+    workers->quit = true;
+    CoreCondBroadcast(&workers->wake);
+    CoreMutexUnlock(&workers->lock);
+
+    for (int i = 1; i < workers->count; i++) CoreThreadJoin(workers->threads[i]);
+
+    CoreCondDestroy(&workers->idle);
+    CoreCondDestroy(&workers->wake);
+    CoreMutexDestroy(&workers->lock);
+
+    free(workers->threads);
+    free(workers->helpers);
+    free(workers);
+}
+
+
+int CoreWorkersCount(const CoreWorkers *workers) {
+    return workers->count;
+}
+
+
+void CoreWorkersRun(CoreWorkers *workers, int count, int grain, CoreRangeFn fn, void *context) {
+
+    if (grain < 1) grain = 1;
+
+    // not worth waking anyone for a single batch
+    if (workers->count == 1 || count <= grain) {
+        if (count > 0) fn(context, 0, 0, count);
+        return;
+    }
+
+    CoreMutexLock(&workers->lock);
+    workers->fn = fn;
+    workers->context = context;
+    workers->total = count;
+    workers->grain = grain;
+    workers->next = 0;
+    workers->busy = workers->count - 1;
+    workers->generation++;
+    CoreCondBroadcast(&workers->wake);
+    CoreMutexUnlock(&workers->lock);
+
+    Drain(workers, 0);
+
+    CoreMutexLock(&workers->lock);
+    while (workers->busy > 0)
+        CoreCondWait(&workers->idle, &workers->lock);
+    CoreMutexUnlock(&workers->lock);
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <raylib.h>
+
+#include "demo_assets.h"
+
+// a file on its way from disk to the GPU or audio device
+typedef struct {
+    char fileName[256];     // copied, callers may build the name on the stack
+    Image image;
+    Wave wave;
+    Texture2D *texture;
+    Sound *sound;
+} PendingAsset;
+
+
+static void DecodeImage(void *data) {
+    PendingAsset *asset = data;
+    asset->image = LoadImage(asset->fileName);
+}
+
+
+static void UploadTexture(void *data) {
+    PendingAsset *asset = data;
+    if (asset->image.data != NULL) {
+        *asset->texture = LoadTextureFromImage(asset->image);
+        UnloadImage(asset->image);
+    }
+    free(asset);
+}
+
+
+static void DecodeWave(void *data) {
+    PendingAsset *asset = data;
+    asset->wave = LoadWave(asset->fileName);
+}
+
+
+static void UploadSound(void *data) {
+    PendingAsset *asset = data;
+    if (asset->wave.data != NULL) {
+        *asset->sound = LoadSoundFromWave(asset->wave);
+        UnloadWave(asset->wave);
+    }
+    free(asset);
+}
+
+
+// Runs decode then upload, as jobs when there are any, else right away
+static CoreJob LoadAsset(CoreJobs *jobs, PendingAsset *asset, CoreJobFn decode, CoreJobFn upload) {
+
+    if (jobs != NULL) {
+        CoreJob decoded = CoreJobsAdd(jobs, decode, asset, NULL, 0, CORE_JOB_ANY);
+        if (decoded != 0) {
+            CoreJob uploaded = CoreJobsAdd(jobs, upload, asset, &decoded, 1, CORE_JOB_MAIN);
+            if (uploaded != 0) return uploaded;
+            CoreJobsWait(jobs, decoded);
+        } else {
+            decode(asset);
+        }
+    } else {
+        decode(asset);
+    }
+
+    upload(asset);
+    return 0;
+}
+
+
+CoreJob LoadTextureJob(CoreJobs *jobs, const char *fileName, Texture2D *texture) {
+
+    *texture = (Texture2D){0};
+
+    PendingAsset *asset = calloc(1, sizeof(*asset));
+    if (asset == NULL) return 0;
+
+    snprintf(asset->fileName, sizeof(asset->fileName), "%s", fileName);
+    asset->texture = texture;
+    return LoadAsset(jobs, asset, DecodeImage, UploadTexture);
+}
+
+
+CoreJob LoadSoundJob(CoreJobs *jobs, const char *fileName, Sound *sound) {
+
+    *sound = (Sound){0};
+
+    PendingAsset *asset = calloc(1, sizeof(*asset));
+    if (asset == NULL) return 0;
+
+    snprintf(asset->fileName, sizeof(asset->fileName), "%s", fileName);
+    asset->sound = sound;
+    return LoadAsset(jobs, asset, DecodeWave, UploadSound);
+}
+
+
+void WaitForJobs(CoreJobs *jobs, const CoreJob *list, int count) {
+
+    if (jobs == NULL) return;
+
+    for (int i = 0; i < count; i++) CoreJobsWait(jobs, list[i]);
+}
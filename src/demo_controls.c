@@ -27,3 +27,13 @@ bool IsInputReleaseBall(void) {
 bool IsInputRestartAfterEnd(void) {
     return IsKeyPressed(KEY_SPACE);
 }
+
+// held to wind play back
+bool IsInputRewind(void) {
+    return IsKeyDown(KEY_BACKSPACE);
+}
+
+// on the lose screen, to pick up from a few seconds before
+bool IsInputRetry(void) {
+    return IsKeyPressed(KEY_BACKSPACE);
+}
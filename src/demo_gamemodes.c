@@ -6,42 +6,271 @@
 #include "demo_controls.h"
 #include "demo_blockloader.h"
 #include "demo_ball.h"
+#include "audio.h"
+#include "core/core_snapshot.h"
+#include "core/core_thread.h"
+#include "core/core_replay.h"
+#include "core/core_rewind.h"
+#include "core/core_save.h"
+#include "core/core_dataset.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <math.h>
-const int INITIAL_LIVES = 3;
-int livesRemaining = 0;
+// the one game the window plays; MODE_EXIT until main() finishes loading
+static CoreGame game = { .mode = MODE_EXIT };
 
-GAME_MODES gameState = MODE_EXIT;
+// fixed rate clock driving the game, and controls not yet seen by a tick
+static CoreClock gameClock = {0};
+static CoreInput pendingInput = {0};
 
 // track the current level file so we can advance to the next level after a win
 static char currentLevelFile[512] = {0};
 
+// Optional simulation thread. While it runs it steps the game and publishes
+// snapshots, this thread draws the newest one, and anything else that reads
+// or changes the game holds gameLock.
+static bool simRunning = false;
+static CoreThread simThread;
+static CoreMutex gameLock;
+static volatile int simQuit = 0;
+static CoreSnapshotBuffer snapshots;
+
+// game events waiting for their sounds, from whichever thread stepped the game
+static CoreEventQueue sounds;
+
+// what is drawn when the game steps on this thread
+static CoreSnapshot frameSnapshot;
+
+// set by main: the session being saved, or the one being played back instead of the controls
+static CoreRecorder *recorder = NULL;
+static CoreReplay *replay = NULL;
+
+// Recent play, captured every tick of MODE_PLAY. It cannot be used while a
+// session is recorded or replayed, as the replay would not match.
+static CoreRewind *rewindBuffer = NULL;
+static bool rewinding = false;  // the rewind key is held, so ticks are not stepped
+static float rewindDue = 0.0f;  // ticks to wind back, carried between frames
+static bool retryHeld = false;  // the key that retried is still down, and must not rewind as well
+#define REWIND_SPEED 2          // times faster than play
+#define RETRY_TICKS (5 * CORE_TICK_RATE)
+
+// saves the game every so often while it is played, on the autosave's own thread
+static CoreAutosave *autosave = NULL;
+static int ticksSinceSave = 0;
+#define AUTOSAVE_TICKS (10 * CORE_TICK_RATE)
+
+// every tick played, with its controls, for analysis; sessions count the lives started
+static CoreDatasetWriter *dataset = NULL;
+static uint32_t datasetSession = 0;
+
 void RenderGameScreen(void);
 void DrawStatusText(const char *displayText);
+void StepGame(const CoreInput *input);
+static void StepTicks(int ticks);
+static bool RewindGame(void);
+static bool RetryGame(void);
+static bool CanRewind(void);
+void PlayGameSounds(void);
+static void QueueGameEvents(void);
+static void LockGame(void);
+static void UnlockGame(void);
+
+CoreGame *GetGame(void)
+{
+    return &game;
+}
 
 GAME_MODES GetGameMode(void)
 {
-    return gameState;
+    LockGame();
+    GAME_MODES mode = game.mode;
+    UnlockGame();
+    return mode;
 }
 
 void SetGameMode(GAME_MODES mode)
 {
-    gameState = mode;
+    LockGame();
+    game.mode = mode;
+    UnlockGame();
+}
+
+void SetRecorder(CoreRecorder *sessionRecorder)
+{
+    recorder = sessionRecorder;
+}
+
+void SetReplay(CoreReplay *sessionReplay)
+{
+    replay = sessionReplay;
+}
+
+void SetRewind(CoreRewind *buffer)
+{
+    rewindBuffer = buffer;
+}
+
+void SetAutosave(CoreAutosave *sessionAutosave)
+{
+    autosave = sessionAutosave;
+    ticksSinceSave = 0;
+}
+
+void SaveGameNow(void)
+{
+    LockGame();
+    if (autosave != NULL && replay == NULL && game.mode == MODE_PLAY && currentLevelFile[0] != '\0')
+        CoreAutosaveSubmit(autosave, &game, currentLevelFile);
+    ticksSinceSave = 0;
+    UnlockGame();
+}
+
+void SetDataset(CoreDatasetWriter *writer)
+{
+    dataset = writer;
+}
+
+bool ResumeGame(const CoreSave *save)
+{
+    LockGame();
+
+    bool resumed = CoreSaveRestore(save, &game, currentLevelFile, sizeof(currentLevelFile));
+    if (resumed)
+    {
+        // what was kept belongs to whatever was played before
+        if (rewindBuffer != NULL)
+            CoreRewindClear(rewindBuffer);
+        CoreClockReset(&gameClock);
+        pendingInput = (CoreInput){0};
+        ticksSinceSave = 0;
+    }
+
+    UnlockGame();
+
+    return resumed;
+}
+
+float GetPaddlePosition(void)
+{
+    LockGame();
+    float position = game.paddle.position;
+    UnlockGame();
+    return position;
+}
+
+static void LockGame(void)
+{
+    if (simRunning)
+        CoreMutexLock(&gameLock);
+}
+
+static void UnlockGame(void)
+{
+    if (simRunning)
+        CoreMutexUnlock(&gameLock);
+}
+
+// step the game at the tick rate until StopSimThread(), publishing each result
+static void SimThreadMain(void *arg)
+{
+    double last = CoreTimeNow();
+
+    while (!CoreAtomicLoad(&simQuit))
+    {
+        double now = CoreTimeNow();
+
+        CoreMutexLock(&gameLock);
+
+        int ticks = CoreClockAdvance(&gameClock, now - last);
+        StepTicks(ticks);
+        QueueGameEvents();
+
+        if (ticks > 0)
+        {
+            CoreSnapshot *snapshot = CoreSnapshotWriteSlot(&snapshots);
+            CoreSnapshotCapture(snapshot, &game);
+            snapshot->time = now - gameClock.accumulator;  // when the last tick was due
+            CoreSnapshotPublish(&snapshots);
+        }
+
+        double untilNextTick = CORE_TICK_DT - gameClock.accumulator;
+
+        CoreMutexUnlock(&gameLock);
+
+        last = now;
+        CoreSleep(untilNextTick);
+    }
+}
+
+bool StartSimThread(void)
+{
+    if (simRunning)
+        return true;
+
+    CoreMutexInit(&gameLock);
+    CoreSnapshotBufferInit(&snapshots);
+
+    // something to draw before the first tick
+    CoreSnapshot *snapshot = CoreSnapshotWriteSlot(&snapshots);
+    CoreSnapshotCapture(snapshot, &game);
+    snapshot->time = CoreTimeNow();
+    CoreSnapshotPublish(&snapshots);
+
+    CoreAtomicStore(&simQuit, 0);
+    simRunning = true;
+    if (!CoreThreadStart(&simThread, SimThreadMain, NULL))
+    {
+        simRunning = false;
+        CoreMutexDestroy(&gameLock);
+        return false;
+    }
+
+    return true;
+}
+
+void StopSimThread(void)
+{
+    if (!simRunning)
+        return;
+
+    CoreAtomicStore(&simQuit, 1);
+    CoreThreadJoin(simThread);
+    simRunning = false;
+    CoreMutexDestroy(&gameLock);
 }
 
 void RunInitGameMode(const char *fileName)
 {
+    LockGame();
+
+    // the replay loads its own levels and starts its own lives
+    if (replay != NULL)
+    {
+        if (!CoreReplayStart(replay, &game))
+            game.mode = MODE_CANCEL;
+        CoreClockReset(&gameClock);
+        pendingInput = (CoreInput){0};
+
+        UnlockGame();
+
+        RenderGameScreen();
+        return;
+    }
 
     // Always load blocks when starting a new level file, or when out of lives
-    if (livesRemaining <= 0 || (fileName && currentLevelFile[0] != '\0' && strcmp(fileName, currentLevelFile) != 0) || (fileName && currentLevelFile[0] == '\0'))
+    if (game.livesRemaining <= 0 || (fileName && currentLevelFile[0] != '\0' && strcmp(fileName, currentLevelFile) != 0) || (fileName && currentLevelFile[0] == '\0'))
     {
         // strcmp(fileName, currentLevelFile) != 0 checks whether the requested
         // level filename differs from the one currently loaded. If different,
         // we must reload block data for the new level.
-        loadBlocks(fileName);
+        CoreGameNewLevel(&game, fileName);
+        if (recorder != NULL)
+            CoreRecorderLevel(recorder, fileName);
+        // what was kept belongs to the last level
+        if (rewindBuffer != NULL)
+            CoreRewindClear(rewindBuffer);
         // remember which level file was loaded
         if (fileName) {
             // Use strncpy to avoid buffer overflow when copying the filename into
@@ -50,46 +279,26 @@ void RunInitGameMode(const char *fileName)
             strncpy(currentLevelFile, fileName, sizeof(currentLevelFile) - 1);
             currentLevelFile[sizeof(currentLevelFile) - 1] = '\0';
         }
-        livesRemaining = INITIAL_LIVES;
     }
 
-    livesRemaining--;
+    // spend a life and put a fresh ball on the paddle
+    CoreGameStartLife(&game);
+    datasetSession++;
+    if (recorder != NULL)
+        CoreRecorderLife(recorder);
+    CoreClockReset(&gameClock);
+    pendingInput = (CoreInput){0};
 
-    ResetPaddleStart();
-    ResetBall();
-    // ensure countdown timer does not start until ball released
-    setTimerActive(false);
+    UnlockGame();
 
     RenderGameScreen();
-
-    SetGameMode(MODE_PLAY);
 }
 
-void RunPlayMode(void)
+void RunPlayMode(const CoreInput *input)
 {
-    // --- Keyboard controls ---
-    if (IsInputPaddleLeft())
-        MovePaddle(PADDLE_LEFT);
-    if (IsInputPaddleRight())
-        MovePaddle(PADDLE_RIGHT);
-
-    // --- Mouse controls ---
-    extern bool mouseControls; // make sure this matches your variable definition
-    if (mouseControls)
-    {
-        Vector2 mousePosition = GetMousePosition();
-        SetPaddlePosition(mousePosition.x);
-    }
-
-    // --- Ball release ---
-    if (IsInputReleaseBall())
-        ReleaseBall();
-
-    // --- Update ball ---
-    MoveBall();
-
-    // --- Update timer ---
-    timeDecrement();
+    // --- Update paddle, ball and timer, or wind them back ---
+    if (!RewindGame())
+        StepGame(input);
 
     // --- Render everything ---
     RenderGameScreen();
@@ -97,14 +306,21 @@ void RunPlayMode(void)
     // --- Quit handling ---
     if (IsInputQuitGame())
     {
-        livesRemaining = 0;
-        SetGameMode(MODE_CANCEL);
+        LockGame();
+        game.livesRemaining = 0;
+        game.mode = replay != NULL ? MODE_EXIT : MODE_CANCEL;
+        if (recorder != NULL)
+            CoreRecorderQuit(recorder);
+        UnlockGame();
     }
 }
 
-void RunEndMode(void)
+void RunEndMode(const CoreInput *input)
 {
 
+    // the paddle can still be moved on the end screens
+    StepGame(input);
+
     RenderGameScreen();
 
     // If user requested quit, exit
@@ -114,6 +330,14 @@ void RunEndMode(void)
         return;
     }
 
+    // what happens after the end screen is up to the replay
+    if (replay != NULL)
+        return;
+
+    // pick up from a few seconds before the ball was lost, instead of spending a life
+    if (GetGameMode() == MODE_LOSE && IsInputRetry() && RetryGame())
+        return;
+
     // If at WIN screen, allow advancing to the next numeric level using Enter/Space
     if (GetGameMode() == MODE_WIN)
     {
@@ -178,7 +402,9 @@ void RunEndMode(void)
                     {
                         fclose(f);
                         // force reload of blocks by resetting livesRemaining so RunInitGameMode will load
-                        livesRemaining = 0;
+                        LockGame();
+                        game.livesRemaining = 0;
+                        UnlockGame();
                         // load next level
                         RunInitGameMode(nextFile);
                         return;
@@ -207,20 +433,40 @@ void RunEndMode(void)
     }
 }
 
+// the state to draw this frame, and how far to blend it toward its last tick
+static const CoreSnapshot *CurrentSnapshot(float *alpha)
+{
+    if (!simRunning)
+    {
+        CoreSnapshotCapture(&frameSnapshot, &game);
+        *alpha = CoreClockAlpha(&gameClock);
+        return &frameSnapshot;
+    }
+
+    // a snapshot reaches its newest positions one tick after that tick was due
+    const CoreSnapshot *snapshot = CoreSnapshotRead(&snapshots, NULL);
+    float blend = (float)((CoreTimeNow() - snapshot->time) / CORE_TICK_DT);
+    *alpha = (blend < 0.0f) ? 0.0f : (blend > 1.0f) ? 1.0f : blend;
+    return snapshot;
+}
+
 void RenderGameScreen(void)
 {
+    // blend ball and paddle between the last two ticks
+    float alpha;
+    const CoreSnapshot *snapshot = CurrentSnapshot(&alpha);
 
     BeginDrawing();
 
     ClearBackground(BLACK);
 
-    drawWalls();
-    drawBlocks();
-    DrawBall();
-    DrawPaddle();
-    drawBorder();
+    drawWalls(snapshot);
+    drawBlocks(snapshot);
+    DrawBalls(snapshot, alpha);
+    DrawPaddle(snapshot, alpha);
+    drawBorder(snapshot);
 
-    switch (GetGameMode())
+    switch (snapshot->mode)
     {
 
     case MODE_WIN:
@@ -249,15 +495,20 @@ void RenderGameScreen(void)
         break;
 
     case MODE_LOSE:
-        if (livesRemaining > 0)
+        if (snapshot->livesRemaining > 0)
         {
-            const char *txt = TextFormat("Remaining attempts: %d", livesRemaining);
+            const char *txt = TextFormat("Remaining attempts: %d", snapshot->livesRemaining);
             DrawStatusText(txt);
         }
         else
         {
             DrawStatusText("You Lost! Sadface...");
         }
+        if (CanRewind())
+        {
+            const char *retry = "Press BACKSPACE to retry from 5 seconds before";
+            DrawText(retry, (GetScreenWidth() - MeasureText(retry, 20)) / 2, GetScreenHeight() / 3 + 80, 20, LIGHTGRAY);
+        }
         break;
 
     case MODE_CANCEL:
@@ -267,17 +518,17 @@ void RenderGameScreen(void)
         break;
     }
 
-    const char *lives = TextFormat("Balls Remaining: %d", livesRemaining);
+    const char *lives = TextFormat("Balls Remaining: %d", snapshot->livesRemaining);
     DrawText(lives, 10, GetScreenHeight() - 20, 20, WHITE);
 
-    const char *blocks = TextFormat("Blocks Remaining: %d", getBlockCount());
+    const char *blocks = TextFormat("Blocks Remaining: %d", snapshot->blocksRemaining);
     DrawText(blocks, GetScreenWidth() - MeasureText(blocks, 20) - 10, 10, 20, WHITE);
 
     // Display remaining time
-    const char *time = TextFormat("Time Remaining: %d", getTime());
+    const char *time = TextFormat("Time Remaining: %d", snapshot->timeRemaining);
     DrawText(time, 10, 10, 20, WHITE);
 
-    if (GetPaddleReverse())
+    if (snapshot->reverse)
     {
         const char *reversed = "REVERSED!";
         DrawText(reversed, (GetScreenWidth() - MeasureText(reversed, 25)) / 2, 35, 25, YELLOW);
@@ -300,4 +551,150 @@ void DrawStatusText(const char *displayText)
 
     DrawText(displayText, xpos - 1, ypos - 1, FONTSIZE, RED);
     DrawText(displayText, xpos, ypos, FONTSIZE, GREEN);
-}
\ No newline at end of file
+}
+
+// run as many fixed ticks as this frame's time pays for, or leave them to the sim thread
+void StepGame(const CoreInput *input)
+{
+    if (simRunning)
+    {
+        CoreMutexLock(&gameLock);
+        CoreInputMerge(&pendingInput, input);
+        CoreMutexUnlock(&gameLock);
+    }
+    else
+    {
+        CoreInputMerge(&pendingInput, input);
+
+        int ticks = CoreClockAdvance(&gameClock, GetFrameTime());
+        StepTicks(ticks);
+        QueueGameEvents();
+    }
+
+    PlayGameSounds();
+}
+
+// step with the pending controls, recording them, or with the replay's;
+// events are handed on after every tick, as a frame's ticks could fill the game's list
+static void StepTicks(int ticks)
+{
+    if (rewinding)
+        return;
+
+    QueueGameEvents();
+
+    for (int i = 0; i < ticks; i++)
+    {
+        if (replay != NULL)
+        {
+            // once it runs out the game stays as the replay left it
+            if (!CoreReplayStep(replay, &game))
+                break;
+            QueueGameEvents();
+            continue;
+        }
+
+        if (recorder != NULL)
+            CoreRecorderTick(recorder, &pendingInput);
+
+        GAME_MODES mode = game.mode;
+        CoreGameStep(&game, &pendingInput, CORE_TICK_DT);
+
+        if (dataset != NULL)
+            CoreDatasetCapture(dataset, &game, &pendingInput, CoreEventMask(&game, 0), datasetSession);
+        QueueGameEvents();
+        CoreInputClearPresses(&pendingInput);
+
+        if (mode != MODE_PLAY)
+            continue;
+
+        if (rewindBuffer != NULL)
+            CoreRewindCapture(rewindBuffer, &game);
+
+        // encoding takes microseconds; the writing is left to the autosave thread
+        if (autosave != NULL && ++ticksSinceSave >= AUTOSAVE_TICKS)
+        {
+            CoreAutosaveSubmit(autosave, &game, currentLevelFile);
+            ticksSinceSave = 0;
+        }
+    }
+}
+
+static bool CanRewind(void)
+{
+    return rewindBuffer != NULL && recorder == NULL && replay == NULL;
+}
+
+// while the rewind key is held, wind play back instead of stepping it
+static bool RewindGame(void)
+{
+    // retry and rewind share a key, so the press that retried must be let go first
+    if (retryHeld && !IsInputRewind())
+        retryHeld = false;
+
+    bool held = CanRewind() && !retryHeld && IsInputRewind();
+
+    LockGame();
+
+    rewinding = held;
+    if (held)
+    {
+        rewindDue += GetFrameTime() * CORE_TICK_RATE * REWIND_SPEED;
+        unsigned long long ticks = (unsigned long long)rewindDue;
+        rewindDue -= ticks;
+
+        CoreRewindTo(rewindBuffer, &game, game.tick > ticks ? game.tick - ticks : 0);
+        CoreClockReset(&gameClock);
+        pendingInput = (CoreInput){0};
+    }
+    else
+    {
+        rewindDue = 0.0f;
+    }
+
+    UnlockGame();
+
+    return held;
+}
+
+// back to RETRY_TICKS before the newest tick kept, with the lives of that moment
+static bool RetryGame(void)
+{
+    if (!CanRewind())
+        return false;
+
+    LockGame();
+
+    unsigned long long newest = CoreRewindNewest(rewindBuffer);
+    bool retried = CoreRewindTo(rewindBuffer, &game, newest > RETRY_TICKS ? newest - RETRY_TICKS : 0);
+    if (retried)
+    {
+        CoreClockReset(&gameClock);
+        pendingInput = (CoreInput){0};
+        retryHeld = true;
+    }
+
+    UnlockGame();
+
+    return retried;
+}
+
+// hand the events of the last step to the thread playing sounds
+static void QueueGameEvents(void)
+{
+    for (int i = 0; i < game.eventCount; i++)
+    {
+        CoreEventQueuePush(&sounds, &game.events[i]);
+    }
+    CoreClearEvents(&game);
+}
+
+// play the sounds for everything that happened since the last frame
+void PlayGameSounds(void)
+{
+    CoreEvent event;
+    while (CoreEventQueuePop(&sounds, &event))
+    {
+        startSound(event.sound);
+    }
+}
@@ -0,0 +1,323 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headless.h"
+#include "core/core_game.h"
+#include "core/core_run.h"
+#include "core/core_bot.h"
+#include "core/core_script.h"
+#include "core/core_replay.h"
+#include "core/core_hash.h"
+#include "core/core_thread.h"
+#include "core/core_dataset.h"
+
+// ten minutes of game time, enough for any level that is still being played
+#define HEADLESS_MAX_TICKS (10ull * 60 * CORE_TICK_RATE)
+#define HEADLESS_MAX_THREADS 256
+
+
+static bool ParseCount(const char *text, unsigned long long *value)
+{
+    char *end;
+    *value = strtoull(text, &end, 0);
+    return end != text && *end == '\0';
+}
+
+
+int TakeHeadlessOption(HeadlessOptions *options, int argumentCount, char *arguments[], int i)
+{
+    const char *option = arguments[i];
+    const char *value = i + 1 < argumentCount ? arguments[i + 1] : NULL;
+    unsigned long long number;
+
+    if (strcmp(option, "--headless") == 0)
+    {
+        options->enabled = true;
+        return 1;
+    }
+    if (strcmp(option, "--turbo") == 0)
+    {
+        options->turbo = true;
+        return 1;
+    }
+    if (strcmp(option, "--bot") == 0)
+    {
+        options->scriptFile = NULL;
+        return 1;
+    }
+    if (strcmp(option, "--script") == 0)
+    {
+        if (value == NULL)
+            return -1;
+        options->scriptFile = value;
+        return 2;
+    }
+    if (strcmp(option, "--seed") == 0)
+    {
+        if (value == NULL || !ParseCount(value, &number))
+            return -1;
+        options->seed = number;
+        options->seeded = true;
+        return 2;
+    }
+    if (strcmp(option, "--max-ticks") == 0)
+    {
+        if (value == NULL || !ParseCount(value, &number))
+            return -1;
+        options->maxTicks = number;
+        return 2;
+    }
+    if (strcmp(option, "--threads") == 0)
+    {
+        if (value == NULL || !ParseCount(value, &number) || number > HEADLESS_MAX_THREADS)
+            return -1;
+        options->threads = (int)number;
+        return 2;
+    }
+
+    return 0;
+}
+
+
+// the bot or script, with every tick it decides written to the replay and kept for the dataset
+typedef struct RecordedInput {
+    CoreInputFn input;
+    void *context;
+    CoreRecorder *recorder;
+    CoreInput last;
+} RecordedInput;
+
+static void RecordInput(void *context, const CoreGame *game, CoreInput *input)
+{
+    RecordedInput *recorded = context;
+    recorded->input(recorded->context, game, input);
+    if (recorded->recorder->file != NULL)
+        CoreRecorderTick(recorded->recorder, input);
+    recorded->last = *input;
+}
+
+
+// holds a loop to the tick rate as a window would
+static void PaceTick(const HeadlessOptions *options, double start, unsigned long long ticks)
+{
+    if (options->turbo)
+        return;
+
+    double due = start + (double)ticks / CORE_TICK_RATE;
+    double now = CoreTimeNow();
+    if (due > now)
+        CoreSleep(due - now);
+}
+
+
+static void PrintResult(const CoreGame *game, const CoreRunStats *stats, const char *result, double seconds)
+{
+    printf("level       %.*s\n", (int)strcspn(game->levelName, "\r\n"), game->levelName);
+    printf("result      %s\n", result);
+    printf("ticks       %llu (%.1f s of game time)\n", stats->ticks, (double)stats->ticks / CORE_TICK_RATE);
+    printf("lives lost  %d, %d left\n", stats->livesLost, game->livesRemaining);
+    printf("blocks      %d left, %d hits\n", CoreBlocksRemaining(game), stats->blockHits);
+    printf("paddle hits %d\n", stats->paddleHits);
+    printf("balls       %d in play\n", game->balls.count);
+    printf("time left   %d\n", game->timeRemaining);
+    printf("state hash  %016" PRIx64 "\n", CoreGameHash(game));
+
+    if (seconds > 0)
+        printf("speed       %.0f ticks/s (%.1fx real time)\n",
+               stats->ticks / seconds, stats->ticks / seconds / CORE_TICK_RATE);
+}
+
+
+// plays the replay through and reports it as a run
+static int RunReplay(const HeadlessOptions *options, CoreGame *game, CoreWorkers *workers)
+{
+    CoreReplay replay;
+    if (!CoreReplayLoad(&replay, options->replayFile))
+    {
+        fprintf(stderr, "Program halt on replay file\n");
+        return 1;
+    }
+
+    CoreRunStats stats = {0};
+    if (!CoreReplayStart(&replay, game))
+    {
+        fprintf(stderr, "Program halt on map validation\n");
+        CoreReplayFree(&replay);
+        return 1;
+    }
+    CoreGameSetWorkers(game, workers);
+    CoreClearEvents(game);
+
+    double start = CoreTimeNow();
+
+    GAME_MODES mode = game->mode;
+    int lives = game->livesRemaining;
+    while (CoreReplayStep(&replay, game))
+    {
+        stats.ticks++;
+        CoreRunCountEvents(game, &stats);
+        CoreClearEvents(game);
+
+        // a life lost, whether the replay sits on the end screen or starts the next life at once
+        if ((game->mode == MODE_LOSE && mode != MODE_LOSE)
+            || (game->mode == MODE_PLAY && mode == MODE_PLAY && game->livesRemaining < lives))
+            stats.livesLost++;
+        mode = game->mode;
+        lives = game->livesRemaining;
+
+        PaceTick(options, start, stats.ticks);
+    }
+
+    stats.cleared = game->mode == MODE_WIN;
+    PrintResult(game, &stats, "end of replay", CoreTimeNow() - start);
+
+    CoreReplayFree(&replay);
+    return 0;
+}
+
+
+int RunHeadless(const HeadlessOptions *options, const char *levelFile, const char *blockTypesFile)
+{
+    if (!CoreLoadOptionalBlockTypes(blockTypesFile))
+    {
+        fprintf(stderr, "Program halt on block types file\n");
+        return 1;
+    }
+
+    // too large for the stack
+    CoreGame *game = malloc(sizeof(*game));
+    if (game == NULL)
+        return 1;
+
+    CoreWorkers *workers = NULL;
+    if (options->threads > 1 && (workers = CoreWorkersCreate(options->threads)) == NULL)
+    {
+        fprintf(stderr, "Program halt on worker threads\n");
+        free(game);
+        return 1;
+    }
+
+    if (options->replayFile != NULL)
+    {
+        int rtnCode = RunReplay(options, game, workers);
+        free(game);
+        CoreWorkersDestroy(workers);
+        return rtnCode;
+    }
+
+    CoreScript script = {0};
+    CoreInputFn input = CoreBotInput;
+    void *context = NULL;
+
+    if (options->scriptFile != NULL)
+    {
+        if (!CoreScriptLoad(&script, options->scriptFile))
+        {
+            fprintf(stderr, "Program halt on script file\n");
+            free(game);
+            CoreWorkersDestroy(workers);
+            return 1;
+        }
+        input = CoreScriptInput;
+        context = &script;
+    }
+
+    CoreGameInit(game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    CoreGameSetWorkers(game, workers);
+    if (options->seeded)
+        CoreGameSeed(game, options->seed);
+
+    CoreRecorder recorder = {0};
+    RecordedInput recorded = { input, context, &recorder, {0} };
+    if (options->recordFile != NULL && !CoreRecorderOpen(&recorder, options->recordFile, game))
+    {
+        fprintf(stderr, "Program halt on replay file\n");
+        free(game);
+        CoreWorkersDestroy(workers);
+        CoreScriptFree(&script);
+        return 1;
+    }
+
+    CoreDatasetWriter *dataset = NULL;
+    if (options->datasetPrefix != NULL && (dataset = CoreDatasetStart(options->datasetPrefix, 0)) == NULL)
+    {
+        fprintf(stderr, "Program halt on dataset\n");
+        CoreRecorderClose(&recorder);
+        free(game);
+        CoreWorkersDestroy(workers);
+        CoreScriptFree(&script);
+        return 1;
+    }
+
+    if (recorder.file != NULL || dataset != NULL)
+    {
+        input = RecordInput;
+        context = &recorded;
+    }
+
+    int rtnCode = 0;
+    CoreRunStats stats;
+    if (!CoreRunStart(game, levelFile, &stats))
+    {
+        fprintf(stderr, "Program halt on map validation\n");
+        rtnCode = 1;
+    }
+    else
+    {
+        if (recorder.file != NULL)
+        {
+            CoreRecorderLevel(&recorder, levelFile);
+            CoreRecorderLife(&recorder);
+        }
+
+        unsigned long long maxTicks = options->maxTicks ? options->maxTicks : HEADLESS_MAX_TICKS;
+        double start = CoreTimeNow();
+
+        int livesLost = 0;
+        while (stats.ticks < maxTicks)
+        {
+            bool playing = CoreRunStep(game, input, context, &stats);
+            if (dataset != NULL)
+                CoreDatasetCapture(dataset, game, &recorded.last, stats.tickEvents, 0);
+            if (!playing)
+                break;
+
+            // CoreRunStep() started the next life itself
+            if (stats.livesLost != livesLost && recorder.file != NULL)
+                CoreRecorderLife(&recorder);
+            livesLost = stats.livesLost;
+
+            PaceTick(options, start, stats.ticks);
+        }
+
+        const char *result = stats.cleared ? "cleared"
+                           : stats.ticks >= maxTicks ? "tick limit"
+                           : "out of lives";
+        PrintResult(game, &stats, result, CoreTimeNow() - start);
+    }
+
+    if (recorder.file != NULL && !CoreRecorderClose(&recorder))
+    {
+        fprintf(stderr, "Replay file '%s' is incomplete\n", options->recordFile);
+        rtnCode = 1;
+    }
+
+    if (dataset != NULL)
+    {
+        if (CoreDatasetDropped(dataset) > 0)
+            fprintf(stderr, "%llu ticks were dropped from the dataset\n", CoreDatasetDropped(dataset));
+        if (!CoreDatasetStop(dataset))
+        {
+            fprintf(stderr, "Dataset '%s' is incomplete\n", options->datasetPrefix);
+            rtnCode = 1;
+        }
+    }
+
+    free(game);
+    CoreWorkersDestroy(workers);
+    CoreScriptFree(&script);
+    return rtnCode;
+}
@@ -2,6 +2,7 @@
 #include <raylib.h>
 #include <stdbool.h>
 #include "intro.h"
+#include "core/core_game.h"
 #define INTRO_TEXTURES "resource/textures/presents/"
 //TODO: Add star animation frames
 #define STAR_TEXTURES "resource/textures/stars/"
@@ -21,8 +22,8 @@ Texture2D introPlanet,
           intro_G;
           //TODO: add "background_Space" and the star animation frames
 
-static const int SCREEN_WIDTH = 575;
-static const int SCREEN_HEIGHT = 720;
+static const int SCREEN_WIDTH = CORE_SCREEN_WIDTH;
+static const int SCREEN_HEIGHT = CORE_SCREEN_HEIGHT;
 
 bool loadIntroTextures(void) {
     introPlanet = LoadTexture(INTRO_TEXTURES "earth.png");
@@ -51,44 +51,26 @@
 #include <stdbool.h>
 #include <raylib.h>
 #include "paddle.h"
-#include "demo_blockloader.h"
-#include <stdio.h>
-
-#define PADDLE_COUNT 3
+#include "demo_assets.h"
 
 #define PADDLE_TEXTURES "resource/textures/paddle/"
 
-const int PADDLE_INITIAL_INDEX = 1;
-const int PADDLE_VEL = 600; // pixels per second
-
+// Textures only; size, position and reverse live in the simulation core
 typedef struct
 {
 	Texture2D img;
-	char *description;
-	int size;
 	char *filepath;
 } Paddle;
 
-Paddle paddles[PADDLE_COUNT];
-
-int reverseOn;
-int paddleIndex;
-int paddlePosition;
-
-int GetPaddlePositionY(void);
+Paddle paddles[CORE_PADDLE_COUNT];
 
-void DrawPaddle(void)
+void DrawPaddle(const CoreSnapshot *snapshot, float alpha)
 {
-	DrawTexture(paddles[paddleIndex].img, paddlePosition, GetPaddlePositionY(), WHITE);
+	Vector2 position = { CoreSnapshotPaddlePosition(snapshot, alpha), snapshot->paddleY };
+	DrawTextureV(paddles[snapshot->paddleIndex].img, position, WHITE);
 }
 
-int GetPaddlePositionY(void)
-{
-	// return GetScreenHeight() - DIST_BASE;
-	return getPlayWall(WALL_BOTTOM).y - DIST_BASE;
-}
-
-bool InitialisePaddle(void)
+bool InitialisePaddle(CoreJobs *jobs)
 {
 
 	// do not load images if program is closing
@@ -98,173 +80,40 @@ bool InitialisePaddle(void)
 	Texture2D emptyTexture = {0};
 
 	// textures must be loaded from smallest to largest
-	paddles[0] = (Paddle){emptyTexture, "Small", 40, PADDLE_TEXTURES "padsml.png"};
-	paddles[1] = (Paddle){emptyTexture, "Medium", 50, PADDLE_TEXTURES "padmed.png"};
-	paddles[2] = (Paddle){emptyTexture, "Huge", 70, PADDLE_TEXTURES "padhuge.png"};
+	paddles[0] = (Paddle){emptyTexture, PADDLE_TEXTURES "padsml.png"};
+	paddles[1] = (Paddle){emptyTexture, PADDLE_TEXTURES "padmed.png"};
+	paddles[2] = (Paddle){emptyTexture, PADDLE_TEXTURES "padhuge.png"};
 
 	// initialize variables before loop
 	bool errorFlag = false;
+	CoreJob loads[CORE_PADDLE_COUNT];
 
 	// create textures for each paddle size
-	for (int i = 0; i < PADDLE_COUNT; i++)
+	for (int i = 0; i < CORE_PADDLE_COUNT; i++)
 	{
+		loads[i] = LoadTextureJob(jobs, paddles[i].filepath, &paddles[i].img);
+	}
 
-		// load paddle texture
-		Image img = LoadImage(paddles[i].filepath);
-		paddles[i].img = LoadTextureFromImage(img);
+	WaitForJobs(jobs, loads, CORE_PADDLE_COUNT);
 
+	for (int i = 0; i < CORE_PADDLE_COUNT; i++)
+	{
 		// check if texture loaded successfully
 		if (paddles[i].img.id == 0)
 		{
 			fprintf(stderr, "Error: failed to load texture InitialisePaddle() file: %s.\n", paddles[i].filepath);
 			errorFlag = true;
 		}
-
-		UnloadImage(img);
 	}
 
 	// stop program if textures failed to load
 	return !errorFlag;
 }
 
-void SetReverseOff(void)
-{
-	reverseOn = false;
-}
-
-void ToggleReverse(void)
-{
-
-	reverseOn = (reverseOn == true) ? false : true;
-
-	// TODO: add display text when implemented
-	// DrawSpecials(display);
-}
-
 void FreePaddle(void)
 {
-	for (int i = 0; i < PADDLE_COUNT; i++)
+	for (int i = 0; i < CORE_PADDLE_COUNT; i++)
 	{
 		UnloadTexture(paddles[i].img);
 	}
 }
-
-void MovePaddle(int direction)
-{
-
-	// calculate the movement distance, adjusted for reverse flag
-	int distance = PADDLE_VEL * (reverseOn == true ? -1 : 1) * GetFrameTime();
-
-	// apply the move based on direction
-	switch (direction)
-	{
-	case PADDLE_LEFT:
-		paddlePosition -= distance;
-		break;
-	case PADDLE_RIGHT:
-		paddlePosition += distance;
-		break;
-	}
-
-	// keep position within window boundries
-	int x = getPlayWall(WALL_LEFT).width;
-	if (paddlePosition < x)
-		paddlePosition = x;
-
-	int maxHPosition = getPlayWall(WALL_RIGHT).x - paddles[paddleIndex].size;
-	if (paddlePosition > maxHPosition)
-		paddlePosition = maxHPosition;
-}
-
-int GetPaddleSize(void)
-{
-	return paddles[paddleIndex].size;
-}
-
-int GetPaddlePositionX(void)
-{
-	return paddlePosition;
-}
-
-Rectangle GetPaddleCollisionRec(void)
-{
-	return (Rectangle){
-		paddlePosition,
-		GetPaddlePositionY(),
-		paddles[paddleIndex].img.width,
-		paddles[paddleIndex].img.height};
-}
-
-int GetPaddleReverse(void)
-{
-	return reverseOn;
-}
-
-char *GetPaddleDescription(void)
-{
-	return paddles[paddleIndex].description;
-}
-
-void ResetPaddleStart(void)
-{
-
-	// set size and center paddle
-	paddleIndex = PADDLE_INITIAL_INDEX;
-	paddlePosition = (GetScreenWidth() - paddles[paddleIndex].size) / 2;
-	reverseOn = false;
-}
-
-void ChangePaddleSize(int changeDirection)
-{
-
-	// capture the old pixel size
-	int oldSize = paddles[paddleIndex].size;
-
-	// adjust paddle index based on change in size
-	switch (changeDirection)
-	{
-	case SIZE_UP:
-		if (paddleIndex < PADDLE_COUNT - 1)
-			paddleIndex++;
-		break;
-
-	case SIZE_DOWN:
-		if (paddleIndex > 0)
-			paddleIndex--;
-		break;
-	}
-
-	// adjust position to center the change in size
-	paddlePosition -= (paddles[paddleIndex].size - oldSize) / 2;
-
-	// move to ensure resize remains inside window
-	MovePaddle(PADDLE_NONE);
-}
-
-Vector2 GetBallSpawnPointOnPaddle()
-{
-	return (Vector2){
-		paddlePosition + paddles[paddleIndex].size / 2,
-		GetPaddlePositionY()};
-}
-
-Rectangle paddleRect = {200, 550, 100, 20}; // example starting position
-
-void SetPaddlePosition(float x)
-{
-	// Clamp x to play area bounds
-	int minX = getPlayWall(WALL_LEFT).width;
-	int maxX = getPlayWall(WALL_RIGHT).x - paddles[paddleIndex].size;
-
-	if (x < minX)
-		x = minX;
-	if (x > maxX)
-		x = maxX;
-
-	paddlePosition = (int)x;
-}
-
-float GetPaddleWidth(void)
-{
-	return paddleRect.width;
-}
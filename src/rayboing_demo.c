@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include <raylib.h>
 #include <stdbool.h>
 
@@ -6,23 +7,78 @@
 #include "demo_blockloader.h"
 #include "demo_ball.h"
 #include "paddle.h"
+#include "demo_controls.h"
 #include "audio.h"
 #include "intro.h"
+#include "headless.h"
+#include "core/core_jobs.h"
 
-const int SCREEN_WIDTH = 575;
-const int SCREEN_HEIGHT = 720;
+const int SCREEN_WIDTH = CORE_SCREEN_WIDTH;
+const int SCREEN_HEIGHT = CORE_SCREEN_HEIGHT;
 
 bool mouseControls = true;
 
+// --sim-thread: step the game on its own thread instead of once per frame
+#define SIM_THREAD_OPTION "--sim-thread"
+static bool useSimThread = false;
+
+// --record <file> saves the session, --replay <file> plays one back instead of the controls
+#define RECORD_OPTION "--record"
+#define REPLAY_OPTION "--replay"
+static const char *recordFile = NULL;
+static const char *replayFile = NULL;
+static CoreRecorder recorder;
+static CoreReplay replay;
+
+// the last stretch of play, for rewinding
+static CoreRewind *rewindBuffer = NULL;
+
+// play is saved to AUTOSAVE_FILE as it goes; --resume <file> carries on from a save
+#define RESUME_OPTION "--resume"
+#define AUTOSAVE_FILE "autosave.sav"
+static const char *resumeFile = NULL;
+static CoreSave resumeSave;
+static CoreAutosave *autosave = NULL;
+
+// --dataset <prefix> writes every tick played to dataset shards, windowed or headless
+#define DATASET_OPTION "--dataset"
+static const char *datasetPrefix = NULL;
+static CoreDatasetWriter *dataset = NULL;
+
+// --headless and friends: play a level with no window, see headless.h
+static HeadlessOptions headless = {0};
+
+// background work for the whole program; NULL runs everything inline
+static CoreJobs *jobs = NULL;
+
 bool ValidateParamFilename(int argumentCount, char *arguments[]);
+int TakeOptions(int argumentCount, char *arguments[]);
+void PrintUsage(const char *program);
 void ReleaseResources(void);
-void UpdatePaddleInput(void);
+void UpdatePaddleInput(CoreInput *input);
 
 int main(int argumentCount, char *arguments[])
 {
 
     SetTraceLogLevel(LOG_NONE);
 
+    argumentCount = TakeOptions(argumentCount, arguments);
+    if (argumentCount < 0)
+        return 1;
+
+    // If no filename was provided, supply the default level path
+    const char *defaultLevel = "resource/levels/level01.data";
+
+    if (headless.enabled)
+    {
+        if (!ValidateParamFilename(argumentCount, arguments))
+            return 1;
+        headless.recordFile = recordFile;
+        headless.replayFile = replayFile;
+        headless.datasetPrefix = datasetPrefix;
+        return RunHeadless(&headless, argumentCount == 2 ? arguments[1] : defaultLevel, CORE_BLOCK_TYPES_FILE);
+    }
+
     int rtnCode = 1;
     bool windowInitialized = false;
 
@@ -31,6 +87,9 @@ int main(int argumentCount, char *arguments[])
     SetTargetFPS(60);
     windowInitialized = true;
 
+    // workers for loading; the GPU uploads they queue run on this thread
+    jobs = CoreJobsCreate(0);
+
     // If no filename was provided on the command line, show the intro/start menu
     // and wait for the player to press Enter/Space. After the intro returns,
     // continue with normal initialization (textures/audio/etc.).
@@ -48,45 +107,105 @@ int main(int argumentCount, char *arguments[])
         }
     }
 
-    if (!ValidateParamFilename(argumentCount, arguments))
+    // optional extra block types; the built-in table is used when the file is absent
+    if (!CoreLoadOptionalBlockTypes(CORE_BLOCK_TYPES_FILE))
+    {
+        fprintf(stderr, "Program halt on block types file");
+    }
+    else if (!ValidateParamFilename(argumentCount, arguments))
     {
         // Validation only fails for incorrect command-line usage or bad file
         // when an argument was supplied. If it fails here, halt.
         fprintf(stderr, "Program halt on map validation");
     }
-    else if (!loadBlockTextures())
+    else if (!loadBlockTextures(jobs))
     {
         fprintf(stderr, "Program halt on iniitalize block texture");
     }
-    else if (!InitialisePaddle())
+    else if (!InitialisePaddle(jobs))
     {
         fprintf(stderr, "Program halt on initialize paddle");
     }
-    else if (!InitializeBall())
+    else if (!InitializeBall(jobs))
     {
         fprintf(stderr, "Program halt on initialize ball");
     }
-    else if (!initAudioFiles())
+    else if (!initAudioFiles(jobs))
     {
         fprintf(stderr, "Program halt on initialize sounds");
     }
     else
     {
 
-        initializePlayArea();
+        CoreGameInit(GetGame(), SCREEN_WIDTH, SCREEN_HEIGHT);
         SetGameMode(MODE_INITGAME);
         rtnCode = 0;
-    }
 
-    // If no filename was provided, supply the default level path
-    const char *defaultLevel = "resource/levels/level01.data";
+        if (replayFile != NULL && CoreReplayLoad(&replay, replayFile))
+        {
+            SetReplay(&replay);
+        }
+        else if (replayFile != NULL)
+        {
+            fprintf(stderr, "Program halt on replay file");
+            SetGameMode(MODE_EXIT);
+            rtnCode = 1;
+        }
+
+        rewindBuffer = CoreRewindCreate(0);
+        SetRewind(rewindBuffer);
+
+        if (resumeFile != NULL && CoreSaveRead(&resumeSave, resumeFile) && ResumeGame(&resumeSave))
+        {
+            fprintf(stdout, "Resuming the game saved in '%s'\n", resumeFile);
+        }
+        else if (resumeFile != NULL)
+        {
+            fprintf(stderr, "Save '%s' could not be resumed, starting the level\n", resumeFile);
+        }
+
+        // a replay's game is not the player's to save
+        if (replayFile == NULL)
+        {
+            autosave = CoreAutosaveStart(AUTOSAVE_FILE);
+            if (autosave == NULL)
+                fprintf(stderr, "Autosave failed to start, playing without it\n");
+            SetAutosave(autosave);
+        }
+
+        if (datasetPrefix != NULL && replayFile == NULL)
+        {
+            dataset = CoreDatasetStart(datasetPrefix, 0);
+            if (dataset == NULL)
+                fprintf(stderr, "Dataset failed to start, playing without it\n");
+            SetDataset(dataset);
+        }
+
+        if (recordFile != NULL && CoreRecorderOpen(&recorder, recordFile, GetGame()))
+        {
+            SetRecorder(&recorder);
+        }
+        else if (recordFile != NULL)
+        {
+            fprintf(stderr, "Recording to '%s' failed, playing without it\n", recordFile);
+        }
+
+        if (useSimThread && !StartSimThread())
+        {
+            fprintf(stderr, "Simulation thread failed to start, stepping per frame\n");
+        }
+    }
 
-    // main game loop
     // main game loop
     GAME_MODES currentMode = GetGameMode();
     while (currentMode != MODE_EXIT)
     {
-        UpdatePaddleInput();
+        // finish off anything loaded in the background since the last frame
+        if (jobs != NULL)
+            CoreJobsRunMain(jobs);
+
+        CoreInput input;
+        UpdatePaddleInput(&input);
 
         // Handle game modes
         switch (currentMode)
@@ -104,13 +223,13 @@ int main(int argumentCount, char *arguments[])
             break;
 
         case MODE_PLAY:
-            RunPlayMode();
+            RunPlayMode(&input);
             break;
 
         case MODE_WIN:
         case MODE_LOSE:
         case MODE_CANCEL:
-            RunEndMode();
+            RunEndMode(&input);
             break;
 
         default:
@@ -118,11 +237,49 @@ int main(int argumentCount, char *arguments[])
             break;
         }
 
+        // keep the cursor over the paddle after the step clamps it
+        if (mouseControls)
+        {
+            // clamp Y to window, if needed
+            int mouseY = GetMouseY();
+            if (mouseY < 0)
+                mouseY = 0;
+            if (mouseY > SCREEN_HEIGHT)
+                mouseY = SCREEN_HEIGHT;
+
+            SetMousePosition(GetPaddlePosition(), mouseY);
+        }
+
         if (WindowShouldClose())
             SetGameMode(MODE_EXIT);
         currentMode = GetGameMode();
     }
 
+    StopSimThread();
+
+    // a game left mid-level can be resumed next time
+    SaveGameNow();
+    SetAutosave(NULL);
+    if (!CoreAutosaveStop(autosave))
+        fprintf(stderr, "Autosave to '%s' failed\n", AUTOSAVE_FILE);
+    autosave = NULL;
+
+    SetDataset(NULL);
+    if (!CoreDatasetStop(dataset))
+        fprintf(stderr, "Dataset '%s' is incomplete\n", datasetPrefix);
+    dataset = NULL;
+
+    if (recordFile != NULL && recorder.file != NULL)
+    {
+        SetRecorder(NULL);
+        if (!CoreRecorderClose(&recorder))
+            fprintf(stderr, "Replay file '%s' is incomplete\n", recordFile);
+    }
+    SetReplay(NULL);
+    CoreReplayFree(&replay);
+    SetRewind(NULL);
+    CoreRewindDestroy(rewindBuffer);
+
     if (windowInitialized)
         CloseWindow();
     ReleaseResources();
@@ -157,20 +314,85 @@ bool ValidateParamFilename(int argumentCount, char *arguments[])
     }
 
     // Any other argument usage is invalid.
-    fprintf(stderr, "Usage: %s <filename>\n", arguments[0]);
+    PrintUsage(arguments[0]);
     return false;
 }
 
+void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [" SIM_THREAD_OPTION "] [" RECORD_OPTION " <file> | " REPLAY_OPTION " <file> | " RESUME_OPTION " <file>]\n"
+                    "           [" DATASET_OPTION " <prefix>] <filename>\n", program);
+    fprintf(stderr, "       %s --headless [--turbo] [--bot | --script <file>] [--seed <n>] [--max-ticks <n>]\n"
+                    "           [--threads <n>] [" RECORD_OPTION " <file> | " REPLAY_OPTION " <file>] [" DATASET_OPTION " <prefix>] <filename>\n", program);
+}
+
+// Removes the options this program understands, returning the arguments left or -1 on a bad option
+int TakeOptions(int argumentCount, char *arguments[])
+{
+    int kept = 1;
+
+    for (int i = 1; i < argumentCount; i++)
+    {
+        int used = TakeHeadlessOption(&headless, argumentCount, arguments, i);
+        bool takesValue = strcmp(arguments[i], RECORD_OPTION) == 0 || strcmp(arguments[i], REPLAY_OPTION) == 0
+            || strcmp(arguments[i], RESUME_OPTION) == 0 || strcmp(arguments[i], DATASET_OPTION) == 0;
+        if (used < 0 || (takesValue && i + 1 >= argumentCount))
+        {
+            fprintf(stderr, "Bad or missing value for option '%s'\n", arguments[i]);
+            PrintUsage(arguments[0]);
+            return -1;
+        }
+
+        if (used > 0)
+            i += used - 1;
+        else if (strcmp(arguments[i], SIM_THREAD_OPTION) == 0)
+            useSimThread = true;
+        else if (strcmp(arguments[i], RECORD_OPTION) == 0)
+            recordFile = arguments[++i];
+        else if (strcmp(arguments[i], REPLAY_OPTION) == 0)
+            replayFile = arguments[++i];
+        else if (strcmp(arguments[i], RESUME_OPTION) == 0)
+            resumeFile = arguments[++i];
+        else if (strcmp(arguments[i], DATASET_OPTION) == 0)
+            datasetPrefix = arguments[++i];
+        else
+            arguments[kept++] = arguments[i];
+    }
+
+    if (recordFile != NULL && replayFile != NULL)
+    {
+        fprintf(stderr, RECORD_OPTION " cannot be used with " REPLAY_OPTION "\n");
+        PrintUsage(arguments[0]);
+        return -1;
+    }
+
+    // a recording or replay starts from a new level, not a save
+    if (resumeFile != NULL && (recordFile != NULL || replayFile != NULL || headless.enabled))
+    {
+        fprintf(stderr, RESUME_OPTION " cannot be used with " RECORD_OPTION ", " REPLAY_OPTION " or --headless\n");
+        PrintUsage(arguments[0]);
+        return -1;
+    }
+
+    arguments[kept] = NULL;
+    return kept;
+}
+
 void ReleaseResources(void)
 {
     FreePaddle();
     FreeBall();
     freeBlockTextures();
     FreeAudioSystem();
+
+    CoreJobsDestroy(jobs);
+    jobs = NULL;
 }
 
-void UpdatePaddleInput(void)
+void UpdatePaddleInput(CoreInput *input)
 {
+    *input = (CoreInput){0};
+
     if (IsKeyPressed(KEY_M))
     {
         mouseControls = !mouseControls;
@@ -179,33 +401,25 @@ void UpdatePaddleInput(void)
 
     if (mouseControls)
     {
-        Vector2 mousePos = GetMousePosition();
-
-        // clamp Y to window, if needed
-        if (mousePos.y < 0)
-            mousePos.y = 0;
-        if (mousePos.y > SCREEN_HEIGHT)
-            mousePos.y = SCREEN_HEIGHT;
-
-        SetPaddlePosition(mousePos.x);
-
-        // updates mouse position 
-        SetMousePosition(GetPaddlePositionX(), mousePos.y);
+        input->paddleAbsolute = true;
+        input->paddleX = GetMousePosition().x;
     }
     else
     {
         // EnableCursor();
-        if (IsKeyDown(KEY_LEFT))
-            MovePaddle(PADDLE_LEFT);
-        if (IsKeyDown(KEY_RIGHT))
-            MovePaddle(PADDLE_RIGHT);
+        if (IsInputPaddleLeft())
+            input->paddleMove = PADDLE_LEFT;
+        if (IsInputPaddleRight())
+            input->paddleMove = PADDLE_RIGHT;
     }
 
+    input->releaseBall = IsInputReleaseBall();
+
     // Optional toggles
     if (IsKeyPressed(KEY_R))
-        ToggleReverse();
+        input->toggleReverse = true;
     if (IsKeyPressed(KEY_Z))
-        ChangePaddleSize(SIZE_DOWN);
+        input->paddleSizeChange = SIZE_DOWN;
     if (IsKeyPressed(KEY_X))
-        ChangePaddleSize(SIZE_UP);
+        input->paddleSizeChange = SIZE_UP;
 }
@@ -0,0 +1,416 @@
+/**
+ * @file analyze_levels.c
+ * @brief Measures how hard each level is by letting the bot play it many times
+ *
+ * Every game of a level is played by the headless bot from its own seed,
+ * spread over all the cores. For each level it reports how often and how
+ * quickly it was cleared, the lives lost, the blocks no game ever hit and
+ * the blocks walled in by solid blocks, which no ball can reach at all.
+ *
+ * Games are seeded by their number, so the report is the same whatever
+ * the number of threads. With no level files given it reads levelNN.data
+ * for every NN up to MAX_NUM_LEVELS in resource/levels.
+ *
+ *     bin/Release/analyze_levels --games 1000 --csv levels.csv --json levels.json
+ *
+ * usage: analyze_levels [--games n] [--threads n] [--seed n] [--max-seconds n]
+ *                       [--csv file] [--json file] [level...]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_game.h"
+#include "core/core_bot.h"
+#include "core/core_run.h"
+#include "core/core_thread.h"
+#include "tools_common.h"
+
+#define DEFAULT_GAMES     100
+#define DEFAULT_SECONDS   600   // a game still going after this counts as timed out
+
+// how one game went
+typedef struct GameResult {
+    bool cleared;
+    bool timedOut;
+    int livesLost;
+    unsigned long long ticks;
+    int blocksLeft;
+    uint16_t blocksHit[CORE_ROW_MAX];
+} GameResult;
+
+// everything known about a level before and after its games
+typedef struct Level {
+    const char *file;
+    char name[256];
+    bool loaded;
+
+    int blocks;                             // destructible blocks at the start
+    uint16_t destructible[CORE_ROW_MAX];
+    uint16_t unreachable[CORE_ROW_MAX];     // destructible, but fenced off by solid blocks
+    uint16_t everHit[CORE_ROW_MAX];
+
+    int games;
+    int cleared;
+    int timedOut;
+    double livesLost;                       // means over all games
+    double blocksLeft;
+    float *clearSeconds;                    // cleared games only, sorted
+} Level;
+
+// what the workers share while a level's games are played
+typedef struct PlayJob {
+    const Level *level;
+    CoreGame **games;   // one per worker
+    GameResult *results;
+    uint64_t seed;
+    int first;          // number of the level's first game, for its seed
+    unsigned long long maxTicks;
+} PlayJob;
+
+
+static void PlayGames(void *context, int worker, int begin, int end) {
+
+    const PlayJob *job = context;
+    CoreGame *game = job->games[worker];
+
+    for (int i = begin; i < end; i++) {
+        GameResult *result = &job->results[i];
+
+        CoreGameInit(game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+        if (!CoreGameNewLevel(game, job->level->file)) continue;
+
+        CoreRunStats stats;
+        CoreRunGame(game, job->seed, (uint32_t)(job->first + i), job->maxTicks, CoreBotInput, NULL, &stats);
+
+        result->cleared = stats.cleared;
+        result->timedOut = !stats.cleared && game->mode == MODE_PLAY;
+        result->livesLost = stats.livesLost;
+        result->ticks = stats.ticks;
+        result->blocksLeft = CoreBlocksRemaining(game);
+        memcpy(result->blocksHit, stats.blocksHit, sizeof(result->blocksHit));
+    }
+}
+
+
+// Loads the level once to learn its name and blocks
+static bool SurveyLevel(Level *level, CoreGame *game) {
+
+    CoreGameInit(game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    if (!CoreGameNewLevel(game, level->file)) return false;
+
+    snprintf(level->name, sizeof(level->name), "%.*s", (int)strcspn(game->levelName, "\r\n"), game->levelName);
+
+    uint16_t reached[CORE_ROW_MAX];
+    CoreReachableCells(&game->grid, reached);
+
+    level->blocks = 0;
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        level->destructible[row] = game->grid.active[row] & ~game->grid.solid[row];
+        level->unreachable[row] = level->destructible[row] & ~reached[row];
+        level->blocks += CoreBitCount(level->destructible[row]);
+    }
+
+    return true;
+}
+
+
+static void Summarize(Level *level, const GameResult *results, int games) {
+
+    level->games = games;
+    level->clearSeconds = malloc((games > 0 ? games : 1) * sizeof(float));
+
+    long long livesLost = 0;
+    long long blocksLeft = 0;
+
+    for (int i = 0; i < games; i++) {
+        const GameResult *result = &results[i];
+
+        if (result->cleared && level->clearSeconds != NULL)
+            level->clearSeconds[level->cleared] = (float)result->ticks / CORE_TICK_RATE;
+        if (result->cleared) level->cleared++;
+        if (result->timedOut) level->timedOut++;
+
+        livesLost += result->livesLost;
+        blocksLeft += result->blocksLeft;
+        for (int row = 0; row < CORE_ROW_MAX; row++) {
+            level->everHit[row] |= result->blocksHit[row];
+        }
+    }
+
+    if (level->clearSeconds != NULL) qsort(level->clearSeconds, level->cleared, sizeof(float), CompareFloats);
+
+    level->livesLost = games > 0 ? (double)livesLost / games : 0.0;
+    level->blocksLeft = games > 0 ? (double)blocksLeft / games : 0.0;
+}
+
+
+// Nearest-rank percentile of the clear times, or -1 when none cleared
+static double ClearPercentile(const Level *level, int percent) {
+    if (level->cleared == 0 || level->clearSeconds == NULL) return -1.0;
+    int rank = (percent * level->cleared + 99) / 100;
+    return level->clearSeconds[rank > 0 ? rank - 1 : 0];
+}
+
+
+// for the table, "-" when no game cleared
+static const char *SecondsText(double seconds, char *text, size_t size) {
+    if (seconds < 0.0) snprintf(text, size, "-");
+    else snprintf(text, size, "%.1f", seconds);
+    return text;
+}
+
+
+static int CountCells(const uint16_t *cells) {
+    int count = 0;
+    for (int row = 0; row < CORE_ROW_MAX; row++) count += CoreBitCount(cells[row]);
+    return count;
+}
+
+
+static void NeverHit(const Level *level, uint16_t *cells) {
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        cells[row] = level->destructible[row] & ~level->everHit[row];
+    }
+}
+
+
+static const int PERCENTILES[] = { 0, 10, 25, 50, 75, 90, 100 };
+static const char *PERCENTILE_NAMES[] = { "min", "p10", "p25", "median", "p75", "p90", "max" };
+#define PERCENTILE_COUNT (int)(sizeof(PERCENTILES) / sizeof(PERCENTILES[0]))
+
+
+static bool WriteCsv(const char *filename, const Level *levels, int count) {
+
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    fprintf(fp, "file,name,games,cleared,timed_out,clear_rate");
+    for (int p = 0; p < PERCENTILE_COUNT; p++) fprintf(fp, ",clear_%s_s", PERCENTILE_NAMES[p]);
+    fprintf(fp, ",lives_lost_mean,blocks,blocks_left_mean,never_hit,unreachable\n");
+
+    for (int i = 0; i < count; i++) {
+        const Level *level = &levels[i];
+        if (!level->loaded) continue;
+
+        uint16_t neverHit[CORE_ROW_MAX];
+        NeverHit(level, neverHit);
+
+        PrintCsvText(fp, level->file);
+        fputc(',', fp);
+        PrintCsvText(fp, level->name);
+        fprintf(fp, ",%d,%d,%d,%.4f", level->games, level->cleared, level->timedOut,
+                level->games > 0 ? (double)level->cleared / level->games : 0.0);
+        for (int p = 0; p < PERCENTILE_COUNT; p++) {
+            double seconds = ClearPercentile(level, PERCENTILES[p]);
+            if (seconds < 0.0) fprintf(fp, ",");
+            else fprintf(fp, ",%.2f", seconds);
+        }
+        fprintf(fp, ",%.3f,%d,%.2f,%d,%d\n", level->livesLost, level->blocks, level->blocksLeft,
+                CountCells(neverHit), CountCells(level->unreachable));
+    }
+
+    bool success = !ferror(fp);
+    if (fclose(fp) != 0) success = false;
+    return success;
+}
+
+
+static void PrintJsonText(FILE *fp, const char *text) {
+    fputc('"', fp);
+    for (; *text; text++) {
+        unsigned char ch = (unsigned char)*text;
+        if (ch == '"' || ch == '\\') fprintf(fp, "\\%c", ch);
+        else if (ch < 0x20) fprintf(fp, "\\u%04x", ch);
+        else fputc(ch, fp);
+    }
+    fputc('"', fp);
+}
+
+
+// [[row, col], ...]
+static void PrintJsonCells(FILE *fp, const uint16_t *cells) {
+    bool first = true;
+    fputc('[', fp);
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (uint32_t bits = cells[row]; bits; bits &= bits - 1) {
+            fprintf(fp, "%s[%d, %d]", first ? "" : ", ", row, CoreLowestBit(bits));
+            first = false;
+        }
+    }
+    fputc(']', fp);
+}
+
+
+static bool WriteJson(const char *filename, const Level *levels, int count, uint64_t seed, double maxSeconds) {
+
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    fprintf(fp, "{\n  \"seed\": %" PRIu64 ",\n  \"max_seconds\": %.0f,\n  \"levels\": [", seed, maxSeconds);
+
+    bool first = true;
+    for (int i = 0; i < count; i++) {
+        const Level *level = &levels[i];
+        if (!level->loaded) continue;
+
+        uint16_t neverHit[CORE_ROW_MAX];
+        NeverHit(level, neverHit);
+
+        fprintf(fp, "%s\n    {\n      \"file\": ", first ? "" : ",");
+        PrintJsonText(fp, level->file);
+        fprintf(fp, ",\n      \"name\": ");
+        PrintJsonText(fp, level->name);
+        fprintf(fp, ",\n      \"games\": %d,\n      \"cleared\": %d,\n      \"timed_out\": %d,\n",
+                level->games, level->cleared, level->timedOut);
+
+        fprintf(fp, "      \"clear_seconds\": {");
+        for (int p = 0; p < PERCENTILE_COUNT; p++) {
+            double seconds = ClearPercentile(level, PERCENTILES[p]);
+            fprintf(fp, "%s\"%s\": ", p ? ", " : "", PERCENTILE_NAMES[p]);
+            if (seconds < 0.0) fprintf(fp, "null");
+            else fprintf(fp, "%.2f", seconds);
+        }
+        fprintf(fp, "},\n");
+
+        fprintf(fp, "      \"lives_lost_mean\": %.3f,\n      \"blocks\": %d,\n      \"blocks_left_mean\": %.2f,\n",
+                level->livesLost, level->blocks, level->blocksLeft);
+        fprintf(fp, "      \"never_hit\": ");
+        PrintJsonCells(fp, neverHit);
+        fprintf(fp, ",\n      \"unreachable\": ");
+        PrintJsonCells(fp, level->unreachable);
+        fprintf(fp, "\n    }");
+        first = false;
+    }
+    fprintf(fp, "\n  ]\n}\n");
+
+    bool success = !ferror(fp);
+    if (fclose(fp) != 0) success = false;
+    return success;
+}
+
+
+static void Usage(void) {
+    fprintf(stderr, "usage: analyze_levels [--games n] [--threads n] [--seed n] [--max-seconds n]\n"
+                    "                      [--csv file] [--json file] [level...]\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+    int gameCount = DEFAULT_GAMES;
+    int threadCount = 0;
+    uint64_t seed = CORE_DEFAULT_SEED;
+    double maxSeconds = DEFAULT_SECONDS;
+    const char *csvFile = NULL;
+    const char *jsonFile = NULL;
+
+    static Level levels[MAX_LEVEL_FILES];
+    int levelCount = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) gameCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) maxSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csvFile = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonFile = argv[++i];
+        else if (argv[i][0] != '-' && levelCount < (int)(sizeof(levels) / sizeof(levels[0]))) levels[levelCount++].file = argv[i];
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (gameCount < 1 || threadCount < 0 || maxSeconds <= 0.0) {
+        Usage();
+        return 2;
+    }
+
+    if (levelCount == 0) {
+        const char *files[MAX_NUM_LEVELS];
+        levelCount = FindDefaultLevels(files);
+        if (levelCount == 0) return 1;
+        for (int i = 0; i < levelCount; i++) levels[i].file = files[i];
+    }
+
+    if (!CoreLoadOptionalBlockTypes(CORE_BLOCK_TYPES_FILE)) return 1;
+
+    CoreWorkers *workers = CoreWorkersCreate(threadCount);
+    if (workers == NULL) return 1;
+    threadCount = CoreWorkersCount(workers);
+
+    PlayJob job = { NULL, calloc(threadCount, sizeof(CoreGame *)), calloc(gameCount, sizeof(GameResult)),
+                    seed, 0, (unsigned long long)(maxSeconds * CORE_TICK_RATE) };
+    if (job.games == NULL || job.results == NULL) return 1;
+    for (int i = 0; i < threadCount; i++) {
+        job.games[i] = malloc(sizeof(CoreGame));
+        if (job.games[i] == NULL) return 1;
+    }
+
+    printf("%d games per level on %d threads, seed %" PRIu64 "\n\n", gameCount, threadCount, seed);
+    printf("%-30s %7s %8s %8s %8s %6s %6s %9s %11s\n",
+           "level", "cleared", "median s", "p90 s", "lives", "blocks", "left", "never hit", "unreachable");
+
+    double started = CoreTimeNow();
+    unsigned long long ticks = 0;
+    int failures = 0;
+
+    for (int i = 0; i < levelCount; i++) {
+        Level *level = &levels[i];
+
+        if (!SurveyLevel(level, job.games[0])) {
+            fprintf(stderr, "%s could not be loaded\n", level->file);
+            failures++;
+            continue;
+        }
+        level->loaded = true;
+
+        memset(job.results, 0, gameCount * sizeof(GameResult));
+        job.level = level;
+        job.first = i * gameCount;
+        CoreWorkersRun(workers, gameCount, 1, PlayGames, &job);
+
+        Summarize(level, job.results, gameCount);
+        for (int g = 0; g < gameCount; g++) ticks += job.results[g].ticks;
+
+        uint16_t neverHit[CORE_ROW_MAX];
+        NeverHit(level, neverHit);
+        char median[16], slow[16];
+        printf("%-30.30s %6.1f%% %8s %8s %8.2f %6d %6.1f %9d %11d\n",
+               level->name[0] ? level->name : level->file, 100.0 * level->cleared / gameCount,
+               SecondsText(ClearPercentile(level, 50), median, sizeof(median)),
+               SecondsText(ClearPercentile(level, 90), slow, sizeof(slow)), level->livesLost,
+               level->blocks, level->blocksLeft, CountCells(neverHit), CountCells(level->unreachable));
+        fflush(stdout);
+    }
+
+    double seconds = CoreTimeNow() - started;
+    printf("\n%llu ticks in %.1f s, %.0f ticks/s\n", ticks, seconds, seconds > 0.0 ? ticks / seconds : 0.0);
+
+    bool written = true;
+    if (csvFile != NULL && !WriteCsv(csvFile, levels, levelCount)) {
+        fprintf(stderr, "%s could not be written\n", csvFile);
+        written = false;
+    }
+    if (jsonFile != NULL && !WriteJson(jsonFile, levels, levelCount, seed, maxSeconds)) {
+        fprintf(stderr, "%s could not be written\n", jsonFile);
+        written = false;
+    }
+
+    for (int i = 0; i < levelCount; i++) free(levels[i].clearSeconds);
+    for (int i = 0; i < threadCount; i++) free(job.games[i]);
+    free(job.games);
+    free(job.results);
+    CoreWorkersDestroy(workers);
+
+    return written && failures == 0 ? 0 : 1;
+}
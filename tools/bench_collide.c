@@ -0,0 +1,330 @@
+/**
+ * @file bench_collide.c
+ * @brief Times the box overlap tests used by ball collision
+ *
+ * Compares testing block hitboxes one CoreRect at a time, the way
+ * CheckCollisionRecs() was used, with the core's batched row kernel at
+ * every SIMD level this CPU supports. For comparison it also times an
+ * all-balls-against-one-box kernel kept here, since the game looks up the
+ * few blocks near each ball rather than all balls near each block.
+ *
+ * Last it steps the level with the pool full of balls, moving them on 1, 2,
+ * 4 ... threads up to the CPU count, and reports ticks per second. Every
+ * run starts from the same state and must end with the same hash.
+ *
+ * usage: bench_collide [level file]
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "core/core_game.h"
+#include "core/core_hash.h"
+#include "core/core_thread.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BENCH_X86 1
+#include <immintrin.h>
+#else
+#define BENCH_X86 0
+#endif
+
+#if BENCH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+#define BOX_COUNT   4096    // probe boxes, cycled through
+#define ROUNDS      200
+#define BALL_COUNT  CORE_MAX_BALLS
+#define STEP_TICKS  (2 * CORE_TICK_RATE)    // per thread count, short enough that few balls are lost
+
+static CoreGame game;
+static CoreGame manyBalls;      // the level with every ball in play, copied for each run
+static CoreGame stepped;
+static CoreRect boxes[BOX_COUNT];
+static float ballX[BALL_COUNT];
+static float ballY[BALL_COUNT];
+
+// keeps the compiler from dropping the loops
+static volatile uint32_t sink;
+
+
+/*
+ * Sets bit i of mask for each ball i whose box overlaps or touches target.
+ * Every version compares the ball's corner against the target grown by
+ * the ball size, so all three give the same mask at the edges.
+ */
+typedef void (*OverlapManyFn)(const float *x, const float *y, int count, float width, float height, CoreRect target, uint32_t *mask);
+
+static void OverlapManyFrom(int start, const float *x, const float *y, int count, float width, float height, CoreRect target, uint32_t *mask) {
+
+    const float minX = target.x - width, maxX = target.x + target.width;
+    const float minY = target.y - height, maxY = target.y + target.height;
+
+    for (int i = start; i < count; i++) {
+        if (x[i] <= maxX && x[i] >= minX && y[i] <= maxY && y[i] >= minY)
+            mask[i / 32] |= 1u << (i % 32);
+    }
+}
+
+
+static void ClearMask(int count, uint32_t *mask) {
+    for (int i = 0; i < (count + 31) / 32; i++) mask[i] = 0;
+}
+
+
+static void OverlapManyScalar(const float *x, const float *y, int count, float width, float height, CoreRect target, uint32_t *mask) {
+    ClearMask(count, mask);
+    OverlapManyFrom(0, x, y, count, width, height, target, mask);
+}
+
+
+#if BENCH_X86
+
+TARGET_SSE2 static void OverlapManySSE2(const float *x, const float *y, int count, float width, float height, CoreRect target, uint32_t *mask) {
+
+    const __m128 minX = _mm_set1_ps(target.x - width);
+    const __m128 maxX = _mm_set1_ps(target.x + target.width);
+    const __m128 minY = _mm_set1_ps(target.y - height);
+    const __m128 maxY = _mm_set1_ps(target.y + target.height);
+
+    ClearMask(count, mask);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 bx = _mm_loadu_ps(x + i);
+        __m128 by = _mm_loadu_ps(y + i);
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(bx, maxX), _mm_cmpge_ps(bx, minX));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(by, maxY), _mm_cmpge_ps(by, minY)));
+        mask[i / 32] |= (uint32_t)_mm_movemask_ps(hit) << (i % 32);
+    }
+
+    OverlapManyFrom(i, x, y, count, width, height, target, mask);
+}
+
+
+TARGET_AVX2 static void OverlapManyAVX2(const float *x, const float *y, int count, float width, float height, CoreRect target, uint32_t *mask) {
+
+    const __m256 minX = _mm256_set1_ps(target.x - width);
+    const __m256 maxX = _mm256_set1_ps(target.x + target.width);
+    const __m256 minY = _mm256_set1_ps(target.y - height);
+    const __m256 maxY = _mm256_set1_ps(target.y + target.height);
+
+    ClearMask(count, mask);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 bx = _mm256_loadu_ps(x + i);
+        __m256 by = _mm256_loadu_ps(y + i);
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(bx, maxX, _CMP_LE_OQ), _mm256_cmp_ps(bx, minX, _CMP_GE_OQ));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(by, maxY, _CMP_LE_OQ), _mm256_cmp_ps(by, minY, _CMP_GE_OQ)));
+        mask[i / 32] |= (uint32_t)_mm256_movemask_ps(hit) << (i % 32);
+    }
+
+    OverlapManyFrom(i, x, y, count, width, height, target, mask);
+}
+
+#endif // BENCH_X86
+
+
+// the many-ball kernel for a level CoreSimdUse() has accepted
+static OverlapManyFn ManyKernel(CoreSimdLevel level) {
+    switch (level) {
+#if BENCH_X86
+        case CORE_SIMD_SSE2: return OverlapManySSE2;
+        case CORE_SIMD_AVX2: return OverlapManyAVX2;
+#endif
+        default:             return OverlapManyScalar;
+    }
+}
+
+
+static double Now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static float RandomIn(float low, float high) {
+    return low + (high - low) * (rand() / (float)RAND_MAX);
+}
+
+
+// every block hitbox in every row, one at a time
+static double TimeRectLoop(void) {
+
+    uint32_t hits = 0;
+    double start = Now();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < BOX_COUNT; i++) {
+            int row = i % CORE_ROW_MAX;
+            for (int col = 0; col < CORE_COL_MAX; col++) {
+                if (CoreRectOverlap(boxes[i], game.grid.hitbox[row][col])) hits |= 1u << col;
+            }
+        }
+    }
+
+    sink = hits;
+    return (Now() - start) * 1e9 / ((double)ROUNDS * BOX_COUNT * CORE_COL_MAX);
+}
+
+
+static double TimeRowKernel(void) {
+
+    const CoreBlockGrid *grid = &game.grid;
+    uint32_t hits = 0;
+    double start = Now();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < BOX_COUNT; i++) {
+            int row = i % CORE_ROW_MAX;
+            hits |= CoreOverlapRow(boxes[i], grid->left[row], grid->top[row], grid->right[row], grid->bottom[row]);
+        }
+    }
+
+    sink = hits;
+    return (Now() - start) * 1e9 / ((double)ROUNDS * BOX_COUNT * CORE_COL_MAX);
+}
+
+
+// all balls against each block in turn
+static double TimeManyKernel(OverlapManyFn overlapMany) {
+
+    uint32_t mask[(BALL_COUNT + 31) / 32];
+    uint32_t hits = 0;
+    int tests = 0;
+    double start = Now();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int row = 0; row < CORE_ROW_MAX; row++) {
+            for (int col = 0; col < CORE_COL_MAX; col++) {
+                overlapMany(ballX, ballY, BALL_COUNT, CORE_BALL_WIDTH, CORE_BALL_HEIGHT, game.grid.hitbox[row][col], mask);
+                hits |= mask[0];
+                tests += BALL_COUNT;
+            }
+        }
+    }
+
+    sink = hits;
+    return (Now() - start) * 1e9 / tests;
+}
+
+
+// the level with the pool filled, the balls fanned out over the lower half
+static void FillBalls(void) {
+
+    manyBalls = game;
+    CoreGameStartLife(&manyBalls);
+
+    CoreInput release = {0};
+    release.releaseBall = true;
+    CoreGameStep(&manyBalls, &release, CORE_TICK_DT);
+    CoreClearEvents(&manyBalls);
+
+    for (int i = 0; manyBalls.balls.count < CORE_MAX_BALLS; i++) {
+        float angle = 0.3f + (i % 500) * 0.005f;
+        CoreVec2 position = { 60.0f + i % 400, 400.0f + (i % 7) * 10 };
+        CoreVec2 velocity = { cosf(angle) * 400, sinf(angle) * 400 };
+        if (CoreAddBall(&manyBalls, position, velocity, 400, BALL_ACTIVE) < 0) break;
+    }
+}
+
+
+// ticks per second stepping the full pool on threads; hash gets the state at the end
+static double TimeManyBallSteps(int threads, uint64_t *hash) {
+
+    CoreWorkers *workers = threads > 1 ? CoreWorkersCreate(threads) : NULL;
+    if (threads > 1 && workers == NULL) return 0.0;
+
+    stepped = manyBalls;
+    CoreGameSetWorkers(&stepped, workers);
+
+    CoreInput input = {0};
+    double start = Now();
+    for (int tick = 0; tick < STEP_TICKS && stepped.mode == MODE_PLAY; tick++) {
+        CoreGameStep(&stepped, &input, CORE_TICK_DT);
+        CoreClearEvents(&stepped);
+    }
+    double seconds = Now() - start;
+
+    CoreGameSetWorkers(&stepped, NULL);
+    CoreWorkersDestroy(workers);
+
+    *hash = CoreGameHash(&stepped);
+    return STEP_TICKS / seconds;
+}
+
+
+int main(int argc, char *argv[]) {
+
+    const char *level = (argc > 1) ? argv[1] : "resource/levels/level01.data";
+
+    CoreGameInit(&game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    if (!CoreGameNewLevel(&game, level)) {
+        fprintf(stderr, "could not load %s\n", level);
+        return 1;
+    }
+
+    srand(1);
+    for (int i = 0; i < BOX_COUNT; i++) {
+        boxes[i] = (CoreRect){ RandomIn(35, 510), RandomIn(60, 540), RandomIn(22, 60), RandomIn(21, 60) };
+    }
+    for (int i = 0; i < BALL_COUNT; i++) {
+        ballX[i] = RandomIn(35, 510);
+        ballY[i] = RandomIn(60, 540);
+    }
+
+    printf("%-28s %10s\n", "test", "ns/test");
+    printf("%-28s %10.3f\n", "CoreRectOverlap loop", TimeRectLoop());
+
+    for (CoreSimdLevel simd = CORE_SIMD_SCALAR; simd <= CORE_SIMD_AVX2; simd++) {
+        if (!CoreSimdUse(simd)) continue;
+
+        char name[64];
+        snprintf(name, sizeof(name), "row kernel (%s)", CoreSimdName(simd));
+        printf("%-28s %10.3f\n", name, TimeRowKernel());
+        snprintf(name, sizeof(name), "many balls kernel (%s)", CoreSimdName(simd));
+        printf("%-28s %10.3f\n", name, TimeManyKernel(ManyKernel(simd)));
+    }
+    CoreSimdUse(CoreSimdBest());
+
+    FillBalls();
+    printf("\n%d balls, %d ticks\n", manyBalls.balls.count, STEP_TICKS);
+    printf("%-28s %10s %8s\n", "threads", "ticks/s", "speedup");
+
+    // powers of two up to the CPU count, and the count itself; at least two, to run the pool
+    int cpus = CoreCpuCount();
+    int last = cpus > 2 ? cpus : 2;
+    int threadCounts[32], runs = 0;
+    for (int threads = 1; threads < last && runs < 31; threads *= 2) threadCounts[runs++] = threads;
+    threadCounts[runs++] = last;
+
+    double serial = 0.0;
+    uint64_t serialHash = 0;
+    bool agree = true;
+
+    for (int run = 0; run < runs; run++) {
+        int threads = threadCounts[run];
+        uint64_t hash;
+        double rate = TimeManyBallSteps(threads, &hash);
+        if (threads == 1) {
+            serial = rate;
+            serialHash = hash;
+        }
+        printf("%-28d %10.0f %7.2fx%s\n", threads, rate, serial > 0.0 ? rate / serial : 0.0,
+               hash == serialHash ? "" : "  (state differs)");
+        agree &= hash == serialHash;
+    }
+    if (cpus < 2) printf("(one CPU: more threads only take turns)\n");
+
+    return agree ? 0 : 1;
+}
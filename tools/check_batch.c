@@ -0,0 +1,226 @@
+/**
+ * @file check_batch.c
+ * @brief Checks what the batch and raster APIs give back
+ *
+ * The bot plays a batch of games of one level, first with the batch on a
+ * single thread and then spread over more. Every step's rewards and done
+ * flags, and a raster of every game a few times a second, go into one
+ * fingerprint; the two runs must agree, since the batch promises results
+ * that do not depend on the thread count. Episodes are cut short so that
+ * games also restart along the way.
+ *
+ * Each raster is also checked on its own: only RASTER_KINDS are written,
+ * the gray palette gives the same picture, and every ball on the screen
+ * shows as a ball pixel. The fingerprint can be pinned with --expect, to
+ * catch a change in either API between builds, and --frame writes the
+ * first game's last raster as a PGM image to look at.
+ *
+ *     bin/Release/check_batch --games 64 --frame batch.pgm
+ *
+ * usage: check_batch [--games n] [--ticks n] [--threads n] [--expect hex]
+ *                    [--frame file] [level]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_batch.h"
+#include "core/core_bot.h"
+#include "core/core_game.h"
+#include "core/core_raster.h"
+
+#define DEFAULT_LEVEL   "resource/levels/level01.data"
+#define DEFAULT_GAMES   64
+#define DEFAULT_TICKS   (20 * CORE_TICK_RATE)
+#define EPISODE_TICKS   (8 * CORE_TICK_RATE)    // short, so games also restart from new seeds
+#define FRAME_INTERVAL  (CORE_TICK_RATE / 10)   // ticks between rasters of each game
+
+#define FRAME_SIZE      (CORE_RASTER_WIDTH * CORE_RASTER_HEIGHT)
+
+// what one run of the batch gave back
+typedef struct BatchRun {
+    uint64_t fingerprint;
+    long episodes;
+    double reward;
+    long frames;
+    long badFrames;         // rasters that failed a check
+    uint8_t lastFrame[FRAME_SIZE];  // the first game's, in gray
+} BatchRun;
+
+
+// FNV-1a, carried on from hash
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+
+// Rasterizes game both ways into kinds and gray; false if the two disagree or a ball is missing
+static bool CheckFrame(const CoreGame *game, uint8_t *kinds, uint8_t *gray) {
+
+    CoreRasterize(game, kinds, CORE_RASTER_WIDTH, CORE_RASTER_HEIGHT, NULL);
+    CoreRasterize(game, gray, CORE_RASTER_WIDTH, CORE_RASTER_HEIGHT, CoreRasterGray);
+
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        if (kinds[i] >= RASTER_KIND_COUNT || gray[i] != CoreRasterGray[kinds[i]]) return false;
+    }
+
+    const float scaleX = (float)CORE_RASTER_WIDTH / CORE_SCREEN_WIDTH;
+    const float scaleY = (float)CORE_RASTER_HEIGHT / CORE_SCREEN_HEIGHT;
+
+    // balls are drawn last, so the pixel under a ball's centre is always a ball
+    for (int i = 0; i < game->balls.count; i++) {
+        int col = (int)((RealToFloat(game->balls.x[i]) + CORE_BALL_WIDTH / 2.0f) * scaleX);
+        int row = (int)((RealToFloat(game->balls.y[i]) + CORE_BALL_HEIGHT / 2.0f) * scaleY);
+        if (col < 0 || col >= CORE_RASTER_WIDTH || row < 0 || row >= CORE_RASTER_HEIGHT) continue;
+        if (kinds[row * CORE_RASTER_WIDTH + col] != RASTER_BALL) return false;
+    }
+    return true;
+}
+
+
+static bool PlayBatch(BatchRun *run, const char *levelFile, int count, int ticks, int threads) {
+
+    CoreBatch *batch = CoreBatchCreate(count, levelFile, CORE_DEFAULT_SEED, threads);
+    CoreInput *actions = malloc(count * sizeof(*actions));
+    float *rewards = malloc(count * sizeof(*rewards));
+    bool *done = malloc(count * sizeof(*done));
+    uint8_t *kinds = malloc(FRAME_SIZE);
+    uint8_t *gray = malloc(FRAME_SIZE);
+
+    bool success = batch != NULL && actions != NULL && rewards != NULL && done != NULL
+        && kinds != NULL && gray != NULL;
+
+    if (batch != NULL) CoreBatchSetMaxTicks(batch, EPISODE_TICKS);
+
+    memset(run, 0, sizeof(*run));
+    run->fingerprint = 0xcbf29ce484222325ull;
+
+    for (int tick = 0; success && tick < ticks; tick++) {
+        for (int i = 0; i < count; i++) {
+            actions[i] = (CoreInput){ 0 };
+            CoreBotInput(NULL, CoreBatchGame(batch, i), &actions[i]);
+        }
+        CoreBatchStep(batch, actions, rewards, done);
+
+        run->fingerprint = HashBytes(run->fingerprint, rewards, count * sizeof(*rewards));
+        for (int i = 0; i < count; i++) {
+            run->fingerprint = HashBytes(run->fingerprint, &done[i], 1);
+            run->reward += rewards[i];
+            run->episodes += done[i];
+        }
+
+        if ((tick + 1) % FRAME_INTERVAL != 0 && tick + 1 != ticks) continue;
+
+        for (int i = 0; i < count; i++) {
+            if (!CheckFrame(CoreBatchGame(batch, i), kinds, gray)) run->badFrames++;
+            run->fingerprint = HashBytes(run->fingerprint, kinds, FRAME_SIZE);
+            run->frames++;
+            if (i == 0) memcpy(run->lastFrame, gray, FRAME_SIZE);
+        }
+    }
+
+    CoreBatchDestroy(batch);
+    free(actions);
+    free(rewards);
+    free(done);
+    free(kinds);
+    free(gray);
+    return success;
+}
+
+
+static bool WriteFrame(const char *filename, const uint8_t *pixels) {
+
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    fprintf(fp, "P5\n%d %d\n255\n", CORE_RASTER_WIDTH, CORE_RASTER_HEIGHT);
+    fwrite(pixels, 1, FRAME_SIZE, fp);
+
+    bool success = !ferror(fp);
+    if (fclose(fp) != 0) success = false;
+    return success;
+}
+
+
+static void PrintRun(const char *label, const BatchRun *run) {
+    printf("%-10s fingerprint %016" PRIx64 "  episodes %ld  reward %.0f  bad frames %ld of %ld\n",
+           label, run->fingerprint, run->episodes, run->reward, run->badFrames, run->frames);
+}
+
+
+static void Usage(void) {
+    fprintf(stderr, "usage: check_batch [--games n] [--ticks n] [--threads n] [--expect hex]\n"
+                    "                   [--frame file] [level]\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+    int count = DEFAULT_GAMES;
+    int ticks = DEFAULT_TICKS;
+    int threads = 0;
+    const char *expect = NULL;
+    const char *frameFile = NULL;
+    const char *levelFile = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) expect = argv[++i];
+        else if (strcmp(argv[i], "--frame") == 0 && i + 1 < argc) frameFile = argv[++i];
+        else if (argv[i][0] != '-' && levelFile == NULL) levelFile = argv[i];
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (count < 1 || ticks < 1 || threads < 0) {
+        Usage();
+        return 2;
+    }
+    if (levelFile == NULL) levelFile = DEFAULT_LEVEL;
+
+    if (!CoreLoadOptionalBlockTypes(CORE_BLOCK_TYPES_FILE)) return 1;
+
+    printf("level      %s, %d games, %d ticks, a %dx%d raster every %d ticks\n", levelFile, count, ticks,
+           CORE_RASTER_WIDTH, CORE_RASTER_HEIGHT, FRAME_INTERVAL);
+
+    // too large for the stack
+    static BatchRun serial, spread;
+
+    if (!PlayBatch(&serial, levelFile, count, ticks, 1) || !PlayBatch(&spread, levelFile, count, ticks, threads)) {
+        fprintf(stderr, "the batch could not be created\n");
+        return 1;
+    }
+    PrintRun("1 thread", &serial);
+    PrintRun(threads ? "threads" : "all cores", &spread);
+
+    bool success = serial.badFrames == 0 && spread.badFrames == 0;
+
+    if (spread.fingerprint != serial.fingerprint) {
+        printf("the runs disagree\n");
+        success = false;
+    }
+
+    if (expect != NULL) {
+        uint64_t expected = strtoull(expect, NULL, 16);
+        printf("expected   %016" PRIx64 ", %s\n", expected, expected == serial.fingerprint ? "matches" : "differs");
+        if (expected != serial.fingerprint) success = false;
+    }
+
+    if (frameFile != NULL && !WriteFrame(frameFile, serial.lastFrame)) success = false;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file check_jobs.c
+ * @brief Stress check for the job system
+ *
+ * Three runs, each repeated on 1 thread and on more:
+ *
+ * - graph: a random dependency graph of many more jobs than CORE_MAX_JOBS
+ *   slots, a fifth of them main-only. Every job checks that the jobs it was
+ *   added after have finished, and main-only jobs that they run on the
+ *   thread that created the system. The main thread then waits on all.
+ * - nested: jobs that add two more jobs and wait on them, Fibonacci style,
+ *   so waiting threads must run queued work rather than block.
+ * - pumped: decode jobs on any thread, each followed by a main-only upload,
+ *   with the main thread calling CoreJobsRunMain() between short sleeps
+ *   as the frontend does once a frame. It only waits when it is the one
+ *   thread there is.
+ *
+ * A failure is printed with the run it happened in and the exit code is 1.
+ *
+ *     bin/Debug/check_jobs --threads 8 --rounds 20
+ *
+ * usage: check_jobs [--jobs n] [--threads n] [--rounds n]
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_jobs.h"
+#include "core/core_thread.h"
+
+#define DEFAULT_JOBS    (8 * CORE_MAX_JOBS)
+#define DEFAULT_ROUNDS  4
+#define MAX_AFTER       3       // dependencies of one graph job
+#define MAIN_SHARE      5       // one graph job in this many is main-only
+#define NESTED_DEPTH    18      // Fibonacci number the nested run computes
+#define NESTED_LEAF     8       // below this the nested jobs stop splitting
+#define PUMPED_ASSETS   256
+
+static CoreJobs *jobs;
+static CORE_THREAD_LOCAL bool onMainThread;
+static volatile int failures;
+
+typedef struct GraphJob {
+    int after[MAX_AFTER];
+    int afterCount;
+    bool mainOnly;
+    int spin;
+    volatile int done;
+} GraphJob;
+
+typedef struct NestedJob {
+    int n;
+    long result;
+} NestedJob;
+
+typedef struct PumpedAsset {
+    volatile int decoded;
+    volatile int uploaded;
+} PumpedAsset;
+
+static GraphJob *graph;
+static CoreJob *graphIds;
+
+
+static void Fail(void) {
+    CoreAtomicAdd(&failures, 1);
+}
+
+
+// keeps a job busy long enough for others to overtake it
+static void Spin(int rounds) {
+    volatile unsigned x = 0;
+    for (int i = 0; i < rounds; i++) x += i;
+}
+
+
+static void RunGraphJob(void *data) {
+
+    GraphJob *job = data;
+
+    for (int i = 0; i < job->afterCount; i++) {
+        if (!CoreAtomicLoad(&graph[job->after[i]].done)) Fail();
+    }
+    if (job->mainOnly && !onMainThread) Fail();
+
+    Spin(job->spin);
+    CoreAtomicStore(&job->done, 1);
+}
+
+
+static bool CheckGraph(int count, unsigned seed) {
+
+    graph = calloc(count, sizeof(*graph));
+    graphIds = calloc(count, sizeof(*graphIds));
+    if (graph == NULL || graphIds == NULL) {
+        free(graph);
+        free(graphIds);
+        return false;
+    }
+
+    srand(seed);
+
+    for (int i = 0; i < count; i++) {
+        GraphJob *job = &graph[i];
+        CoreJob after[MAX_AFTER];
+
+        job->afterCount = (i == 0) ? 0 : rand() % (MAX_AFTER + 1);
+        for (int k = 0; k < job->afterCount; k++) {
+            job->after[k] = rand() % i;
+            after[k] = graphIds[job->after[k]];
+        }
+        job->mainOnly = rand() % MAIN_SHARE == 0;
+        job->spin = rand() % 2000;
+
+        graphIds[i] = CoreJobsAdd(jobs, RunGraphJob, job, after, job->afterCount,
+                                  job->mainOnly ? CORE_JOB_MAIN : CORE_JOB_ANY);
+        if (graphIds[i] == 0) Fail();
+    }
+
+    for (int i = 0; i < count; i++) CoreJobsWait(jobs, graphIds[i]);
+
+    for (int i = 0; i < count; i++) {
+        if (!graph[i].done || !CoreJobsDone(jobs, graphIds[i])) Fail();
+    }
+
+    free(graph);
+    free(graphIds);
+    return true;
+}
+
+
+static void RunNestedJob(void *data) {
+
+    NestedJob *job = data;
+
+    if (job->n < NESTED_LEAF) {
+        long a = 0, b = 1;
+        for (int i = 0; i < job->n; i++) {
+            long next = a + b;
+            a = b;
+            b = next;
+        }
+        job->result = a;
+        return;
+    }
+
+    NestedJob first = { job->n - 1, 0 };
+    NestedJob second = { job->n - 2, 0 };
+    CoreJob halves[2] = {
+        CoreJobsAdd(jobs, RunNestedJob, &first, NULL, 0, CORE_JOB_ANY),
+        CoreJobsAdd(jobs, RunNestedJob, &second, NULL, 0, CORE_JOB_ANY)
+    };
+
+    // a job with no function, standing for both halves
+    CoreJob both = CoreJobsAdd(jobs, NULL, NULL, halves, 2, CORE_JOB_ANY);
+    CoreJobsWait(jobs, both);
+
+    job->result = first.result + second.result;
+}
+
+
+static void CheckNested(void) {
+
+    long a = 0, b = 1;
+    for (int i = 0; i < NESTED_DEPTH; i++) {
+        long next = a + b;
+        a = b;
+        b = next;
+    }
+
+    NestedJob root = { NESTED_DEPTH, 0 };
+    CoreJobsWait(jobs, CoreJobsAdd(jobs, RunNestedJob, &root, NULL, 0, CORE_JOB_ANY));
+
+    if (root.result != a) Fail();
+}
+
+
+static void DecodeAsset(void *data) {
+    PumpedAsset *asset = data;
+    Spin(20000);
+    CoreAtomicStore(&asset->decoded, 1);
+}
+
+
+static void UploadAsset(void *data) {
+    PumpedAsset *asset = data;
+    if (!onMainThread || !CoreAtomicLoad(&asset->decoded)) Fail();
+    CoreAtomicStore(&asset->uploaded, 1);
+}
+
+
+static void CheckPumped(void) {
+
+    static PumpedAsset assets[PUMPED_ASSETS];
+    CoreJob uploads[PUMPED_ASSETS];
+
+    memset(assets, 0, sizeof(assets));
+
+    for (int i = 0; i < PUMPED_ASSETS; i++) {
+        CoreJob decoded = CoreJobsAdd(jobs, DecodeAsset, &assets[i], NULL, 0, CORE_JOB_ANY);
+        uploads[i] = CoreJobsAdd(jobs, UploadAsset, &assets[i], &decoded, 1, CORE_JOB_MAIN);
+        if (decoded == 0 || uploads[i] == 0) Fail();
+    }
+
+    // with one thread nobody else decodes, so the main thread lends a hand
+    // the way a frame would wait for something it cannot draw without
+    const bool alone = CoreJobsThreadCount(jobs) == 1;
+
+    for (int i = 0; i < PUMPED_ASSETS; i++) {
+        while (!CoreJobsDone(jobs, uploads[i])) {
+            if (CoreJobsRunMain(jobs) == 0) {
+                if (alone) CoreJobsWait(jobs, uploads[i]);
+                else CoreSleep(0.001);
+            }
+        }
+    }
+
+    for (int i = 0; i < PUMPED_ASSETS; i++) {
+        if (!assets[i].uploaded) Fail();
+    }
+}
+
+
+static bool RunChecks(int threads, int count, int rounds) {
+
+    jobs = CoreJobsCreate(threads);
+    if (jobs == NULL) {
+        fprintf(stderr, "the job threads could not be started\n");
+        return false;
+    }
+
+    const char *names[] = { "graph", "nested", "pumped" };
+    bool success = true;
+
+    for (int check = 0; check < 3; check++) {
+        CoreAtomicStore(&failures, 0);
+        double start = CoreTimeNow();
+
+        for (int round = 0; round < rounds; round++) {
+            if (check == 0 && !CheckGraph(count, round + 1)) {
+                fprintf(stderr, "out of memory\n");
+                CoreJobsDestroy(jobs);
+                return false;
+            }
+            if (check == 1) CheckNested();
+            if (check == 2) CheckPumped();
+        }
+
+        int failed = CoreAtomicLoad(&failures);
+        printf("%2d threads  %-7s %s  %.2fs\n", CoreJobsThreadCount(jobs), names[check],
+               failed ? "FAILED" : "ok    ", CoreTimeNow() - start);
+        if (failed) success = false;
+    }
+
+    CoreJobsDestroy(jobs);
+    return success;
+}
+
+
+static void Usage(void) {
+    fprintf(stderr, "usage: check_jobs [--jobs n] [--threads n] [--rounds n]\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+    int count = DEFAULT_JOBS;
+    int threads = 0;
+    int rounds = DEFAULT_ROUNDS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atoi(argv[++i]);
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (count < 1 || threads < 0 || rounds < 1) {
+        Usage();
+        return 2;
+    }
+    if (threads == 0) threads = CoreCpuCount();
+    if (threads < 2) threads = 2;
+
+    onMainThread = true;
+
+    printf("%d graph jobs against %d slots, %d rounds of each check\n", count, CORE_MAX_JOBS, rounds);
+
+    bool success = RunChecks(1, count, rounds);
+    if (!RunChecks(threads, count, rounds)) success = false;
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,400 @@
+/**
+ * @file generate_levels.c
+ * @brief Makes new levels at random and keeps the ones the bot finds as hard as asked
+ *
+ * Each level is picked from a set of candidates drawn from the constraints:
+ * the mix of blocks, how full the rows are, how many special blocks, and
+ * the symmetry the level editor gives by hand, mirrored left to right like
+ * its FlipBoardHorizontal and repeating down the board like its
+ * ScrollBoardVertical. Blocks walled in by solid ones are taken out again.
+ *
+ * Every candidate is played by the headless bot from several seeds, all
+ * candidates of a level at once on all the cores. A candidate's difficulty
+ * is the share of lives the bot loses on it, a game not cleared losing all
+ * of them, so 0 is a level the bot never drops a ball on and 1 one it never
+ * clears. The candidate closest to the target is written as a level file,
+ * <prefix>001.data, <prefix>002.data and so on, with a time bonus of twice
+ * the bot's median clear time.
+ *
+ * Candidates and games are seeded by their number, so the levels are the
+ * same whatever the number of threads.
+ *
+ *     bin/Release/generate_levels --levels 100 --mirror --difficulty 0.4 --prefix resource/levels/arcade
+ *
+ * usage: generate_levels [--levels n] [--candidates n] [--games n] [--threads n] [--seed n]
+ *                        [--blocks chars] [--fill f] [--rows n] [--specials n] [--special-blocks chars]
+ *                        [--mirror] [--bands n] [--difficulty d] [--max-seconds n]
+ *                        [--name text] [--prefix path]
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_game.h"
+#include "core/core_bot.h"
+#include "core/core_run.h"
+#include "core/core_thread.h"
+#include "tools_common.h"
+
+#define DEFAULT_LEVELS      10
+#define DEFAULT_CANDIDATES  8
+#define DEFAULT_GAMES       16
+#define MAX_GAMES           256
+#define DEFAULT_SECONDS     300     // a game still going after this counts as not cleared
+#define DEFAULT_BLOCKS      "rgbtpyrgbtpy0123"
+#define DEFAULT_SPECIALS    "BXmsR<>"
+
+// time bonus, from the bot's median clear time
+#define MIN_TIME            60
+#define MAX_TIME            600
+#define DEFAULT_TIME        120     // when the bot never cleared it
+
+// what a level may be made of
+typedef struct Constraints {
+    const char *blocks;         // drawn from with repeats as weights
+    float fill;                 // chance a cell in the block rows has a block
+    int rows;                   // blocks go in the top rows only, leaving room to play
+    int specials;
+    const char *specialBlocks;
+    bool mirror;
+    int bands;                  // rows repeat every this many, 0 for no repeat
+    float difficulty;
+} Constraints;
+
+typedef struct Candidate {
+    char blocks[CORE_ROW_MAX][CORE_COL_MAX];
+    int blockCount;             // destructible
+    uint64_t seed;              // its games are streams of this
+
+    int cleared;
+    int livesLost;              // a game not cleared counts all its lives
+    float clearSeconds[MAX_GAMES];
+    float difficulty;
+    float median;               // -1 when never cleared
+} Candidate;
+
+// how one game went
+typedef struct GameResult {
+    bool cleared;
+    int livesLost;
+    unsigned long long ticks;
+} GameResult;
+
+// what the workers share while a level's candidates are played
+typedef struct PlayJob {
+    const CoreGame *starts;     // one per candidate, the level set up and nothing played
+    const Candidate *candidates;
+    CoreGame **games;           // one per worker
+    GameResult *results;        // candidate by game
+    int gameCount;
+    unsigned long long maxTicks;
+} PlayJob;
+
+
+static void PlayGames(void *context, int worker, int begin, int end) {
+
+    const PlayJob *job = context;
+    CoreGame *game = job->games[worker];
+
+    for (int i = begin; i < end; i++) {
+        int candidate = i / job->gameCount;
+        GameResult *result = &job->results[i];
+
+        memcpy(game, &job->starts[candidate], sizeof(*game));
+
+        CoreRunStats stats;
+        CoreRunGame(game, job->candidates[candidate].seed, (uint32_t)(i % job->gameCount), job->maxTicks,
+                    CoreBotInput, NULL, &stats);
+
+        result->cleared = stats.cleared;
+        result->livesLost = stats.cleared ? stats.livesLost : CORE_INITIAL_LIVES;
+        result->ticks = stats.ticks;
+    }
+}
+
+
+static char Pick(CoreRng *rng, const char *chars) {
+    return chars[CoreRngRange(rng, (int)strlen(chars))];
+}
+
+
+/*
+ * Draws the pattern the symmetry leaves free, the left half and middle
+ * column of the first band, then copies it out: mirrored into the right
+ * half, then repeated down the block rows. Each row leans to one block so
+ * the level reads as stripes, as most of the originals do.
+ */
+static void DrawBlocks(const Constraints *constraints, CoreRng *rng, char blocks[CORE_ROW_MAX][CORE_COL_MAX]) {
+
+    memset(blocks, '.', CORE_ROW_MAX * CORE_COL_MAX);
+
+    int rows = constraints->bands > 0 && constraints->bands < constraints->rows ? constraints->bands : constraints->rows;
+    int cols = constraints->mirror ? (CORE_COL_MAX + 1) / 2 : CORE_COL_MAX;
+
+    for (int row = 0; row < rows; row++) {
+        char stripe = Pick(rng, constraints->blocks);
+        for (int col = 0; col < cols; col++) {
+            if (CoreRngRange(rng, 1000) >= (int)(constraints->fill * 1000.0f)) continue;
+            blocks[row][col] = CoreRngRange(rng, 4) > 0 ? stripe : Pick(rng, constraints->blocks);
+        }
+    }
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = cols; col < CORE_COL_MAX; col++) {
+            blocks[row][col] = blocks[row][CORE_COL_MAX - 1 - col];
+        }
+    }
+
+    for (int row = rows; row < constraints->rows; row++) {
+        memcpy(blocks[row], blocks[row % rows], CORE_COL_MAX);
+    }
+
+    // specials last, in mirrored pairs when mirrored
+    for (int placed = 0; placed < constraints->specials;) {
+        int row = CoreRngRange(rng, constraints->rows);
+        int col = CoreRngRange(rng, CORE_COL_MAX);
+        char special = Pick(rng, constraints->specialBlocks);
+
+        if (constraints->mirror && col != CORE_COL_MAX / 2 && placed + 1 < constraints->specials) {
+            blocks[row][CORE_COL_MAX - 1 - col] = special;
+            placed++;
+        } else if (constraints->mirror) {
+            col = CORE_COL_MAX / 2;
+        }
+        blocks[row][col] = special;
+        placed++;
+    }
+}
+
+
+/*
+ * A fresh candidate and the game it starts as. Blocks no ball could reach
+ * are emptied; a mirrored board is mirrored in what it walls in too.
+ */
+static void MakeCandidate(const Constraints *constraints, uint64_t seed, uint32_t number,
+                          Candidate *candidate, CoreGame *start) {
+
+    CoreRng rng;
+    CoreRngStream(&rng, seed, number);
+
+    memset(candidate, 0, sizeof(*candidate));
+    DrawBlocks(constraints, &rng, candidate->blocks);
+    candidate->seed = CoreRngNext64(&rng);
+
+    CoreGameInit(start, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    CoreGameSetLevel(start, "", DEFAULT_TIME, candidate->blocks);
+
+    uint16_t reached[CORE_ROW_MAX];
+    CoreReachableCells(&start->grid, reached);
+
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        uint16_t destructible = start->grid.active[row] & ~start->grid.solid[row];
+        for (uint32_t bits = destructible & ~reached[row]; bits; bits &= bits - 1) {
+            int col = CoreLowestBit(bits);
+            candidate->blocks[row][col] = '.';
+            CoreAddBlock(start, row, col, '.');
+        }
+        candidate->blockCount += CoreBitCount(destructible & reached[row]);
+    }
+}
+
+
+static void Summarize(Candidate *candidate, const GameResult *results, int games) {
+
+    for (int i = 0; i < games; i++) {
+        if (results[i].cleared) candidate->clearSeconds[candidate->cleared++] = (float)results[i].ticks / CORE_TICK_RATE;
+        candidate->livesLost += results[i].livesLost;
+    }
+
+    qsort(candidate->clearSeconds, candidate->cleared, sizeof(float), CompareFloats);
+    candidate->median = candidate->cleared > 0 ? candidate->clearSeconds[(candidate->cleared - 1) / 2] : -1.0f;
+    candidate->difficulty = (float)candidate->livesLost / (games * CORE_INITIAL_LIVES);
+}
+
+
+// Closest to the target difficulty, then quicker to clear; empty boards never win
+static bool Better(const Candidate *a, const Candidate *b, float target) {
+
+    if (b == NULL) return a->blockCount > 0;
+    if (a->blockCount == 0) return false;
+
+    float missA = a->difficulty > target ? a->difficulty - target : target - a->difficulty;
+    float missB = b->difficulty > target ? b->difficulty - target : target - b->difficulty;
+    if (missA != missB) return missA < missB;
+
+    if (a->median < 0.0f || b->median < 0.0f) return a->median >= 0.0f && b->median < 0.0f;
+    return a->median < b->median;
+}
+
+
+static int TimeBonus(const Candidate *candidate) {
+    if (candidate->median < 0.0f) return DEFAULT_TIME;
+    int seconds = ((int)(candidate->median * 2.0f) + 9) / 10 * 10;
+    return seconds < MIN_TIME ? MIN_TIME : seconds > MAX_TIME ? MAX_TIME : seconds;
+}
+
+
+static bool WriteLevel(const char *filename, const char *name, int timeBonus, const char blocks[CORE_ROW_MAX][CORE_COL_MAX]) {
+
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    fprintf(fp, "%s\n%d\n", name, timeBonus);
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        fprintf(fp, "%.*s\n", CORE_COL_MAX, blocks[row]);
+    }
+
+    bool success = !ferror(fp);
+    if (fclose(fp) != 0) success = false;
+    return success;
+}
+
+
+// every character must be a block the game knows
+static bool KnownBlocks(const char *chars) {
+    if (chars[0] == '\0') return false;
+    for (; *chars; chars++) {
+        if (!CoreGetBlockType(*chars)->defined) return false;
+    }
+    return true;
+}
+
+
+static void Usage(void) {
+    fprintf(stderr, "usage: generate_levels [--levels n] [--candidates n] [--games n] [--threads n] [--seed n]\n"
+                    "                       [--blocks chars] [--fill f] [--rows n] [--specials n] [--special-blocks chars]\n"
+                    "                       [--mirror] [--bands n] [--difficulty d] [--max-seconds n]\n"
+                    "                       [--name text] [--prefix path]\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+    int levelCount = DEFAULT_LEVELS;
+    int candidateCount = DEFAULT_CANDIDATES;
+    int gameCount = DEFAULT_GAMES;
+    int threadCount = 0;
+    uint64_t seed = CORE_DEFAULT_SEED;
+    double maxSeconds = DEFAULT_SECONDS;
+    const char *name = "Generated";
+    const char *prefix = "generated";
+
+    Constraints constraints = { DEFAULT_BLOCKS, 0.6f, 10, 3, DEFAULT_SPECIALS, false, 0, 0.3f };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) levelCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--candidates") == 0 && i + 1 < argc) candidateCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) gameCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--blocks") == 0 && i + 1 < argc) constraints.blocks = argv[++i];
+        else if (strcmp(argv[i], "--fill") == 0 && i + 1 < argc) constraints.fill = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc) constraints.rows = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--specials") == 0 && i + 1 < argc) constraints.specials = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--special-blocks") == 0 && i + 1 < argc) constraints.specialBlocks = argv[++i];
+        else if (strcmp(argv[i], "--mirror") == 0) constraints.mirror = true;
+        else if (strcmp(argv[i], "--bands") == 0 && i + 1 < argc) constraints.bands = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc) constraints.difficulty = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) maxSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) name = argv[++i];
+        else if (strcmp(argv[i], "--prefix") == 0 && i + 1 < argc) prefix = argv[++i];
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (levelCount < 1 || candidateCount < 1 || gameCount < 1 || gameCount > MAX_GAMES || threadCount < 0 ||
+        constraints.fill < 0.0f || constraints.fill > 1.0f || constraints.rows < 1 || constraints.rows > CORE_ROW_MAX ||
+        constraints.specials < 0 || constraints.bands < 0 || constraints.difficulty < 0.0f ||
+        constraints.difficulty > 1.0f || maxSeconds <= 0.0) {
+        Usage();
+        return 2;
+    }
+
+    if (!CoreLoadOptionalBlockTypes(CORE_BLOCK_TYPES_FILE)) return 1;
+
+    if (!KnownBlocks(constraints.blocks) || (constraints.specials > 0 && !KnownBlocks(constraints.specialBlocks))) {
+        fprintf(stderr, "--blocks and --special-blocks take characters of known block types\n");
+        return 2;
+    }
+
+    CoreWorkers *workers = CoreWorkersCreate(threadCount);
+    if (workers == NULL) return 1;
+    threadCount = CoreWorkersCount(workers);
+
+    Candidate *candidates = malloc(candidateCount * sizeof(Candidate));
+    CoreGame *starts = malloc(candidateCount * sizeof(CoreGame));
+    PlayJob job = { starts, candidates, calloc(threadCount, sizeof(CoreGame *)),
+                    calloc((size_t)candidateCount * gameCount, sizeof(GameResult)), gameCount,
+                    (unsigned long long)(maxSeconds * CORE_TICK_RATE) };
+    if (candidates == NULL || starts == NULL || job.games == NULL || job.results == NULL) return 1;
+    for (int i = 0; i < threadCount; i++) {
+        job.games[i] = malloc(sizeof(CoreGame));
+        if (job.games[i] == NULL) return 1;
+    }
+
+    printf("%d levels of %d candidates, %d games each, on %d threads, seed %" PRIu64 "\n\n",
+           levelCount, candidateCount, gameCount, threadCount, seed);
+    printf("%-34s %10s %7s %8s %6s %5s\n", "file", "difficulty", "cleared", "median s", "blocks", "time");
+
+    double started = CoreTimeNow();
+    unsigned long long ticks = 0;
+    int failures = 0;
+
+    for (int level = 0; level < levelCount; level++) {
+
+        for (int c = 0; c < candidateCount; c++) {
+            MakeCandidate(&constraints, seed, (uint32_t)(level * candidateCount + c), &candidates[c], &starts[c]);
+        }
+
+        CoreWorkersRun(workers, candidateCount * gameCount, 1, PlayGames, &job);
+
+        const Candidate *best = NULL;
+        for (int c = 0; c < candidateCount; c++) {
+            Summarize(&candidates[c], &job.results[c * gameCount], gameCount);
+            if (Better(&candidates[c], best, constraints.difficulty)) best = &candidates[c];
+        }
+        for (int i = 0; i < candidateCount * gameCount; i++) ticks += job.results[i].ticks;
+
+        char filename[1024], title[256];
+        snprintf(filename, sizeof(filename), "%s%03d.data", prefix, level + 1);
+        snprintf(title, sizeof(title), "%s %d", name, level + 1);
+
+        if (best == NULL) {
+            fprintf(stderr, "%s: every candidate was empty; give more --fill or --blocks\n", filename);
+            failures++;
+            continue;
+        }
+        if (!WriteLevel(filename, title, TimeBonus(best), best->blocks)) {
+            fprintf(stderr, "%s could not be written\n", filename);
+            failures++;
+            continue;
+        }
+
+        char median[16];
+        if (best->median < 0.0f) snprintf(median, sizeof(median), "-");
+        else snprintf(median, sizeof(median), "%.1f", best->median);
+        printf("%-34.34s %10.2f %6.1f%% %8s %6d %5d\n", filename, best->difficulty,
+               100.0 * best->cleared / gameCount, median, best->blockCount, TimeBonus(best));
+        fflush(stdout);
+    }
+
+    double seconds = CoreTimeNow() - started;
+    printf("\n%llu ticks in %.1f s, %.0f ticks/s, %.0f levels/hour\n", ticks, seconds,
+           seconds > 0.0 ? ticks / seconds : 0.0, seconds > 0.0 ? (levelCount - failures) * 3600.0 / seconds : 0.0);
+
+    for (int i = 0; i < threadCount; i++) free(job.games[i]);
+    free(job.games);
+    free(job.results);
+    free(starts);
+    free(candidates);
+    CoreWorkersDestroy(workers);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1200 @@
+/**
+ * @file sweep.c
+ * @brief Plays a grid of level x seed x bot strategy games over worker processes
+ *
+ * The same program is both ends. Run as the coordinator, it splits every
+ * level and strategy into shards of a few games and hands them out to the
+ * workers that connect to it, over TCP or a Unix socket; --spawn starts
+ * that many workers on this machine, and workers on other machines join
+ * with --connect. Each worker plays its shards headless, as many games at
+ * a time as it has threads for, and sends back the totals.
+ *
+ * Workers ask for work when they are free, so fast ones do more. Once
+ * nothing is left to hand out, a free worker takes over the shard that has
+ * been running longest elsewhere, and whichever copy finishes first
+ * counts. A shard whose worker drops, reports a failure or runs past
+ * --timeout is queued again, up to --retries times, and a local worker
+ * that drops is replaced. Totals for each level and strategy are printed
+ * as soon as their last shard is in.
+ *
+ * Game n of a level is seeded by its number, the same for every strategy,
+ * so strategies are compared on the same games and the totals do not
+ * depend on how the shards were spread. That holds only while every worker
+ * plays a game exactly as the coordinator would: a worker joins with
+ * whether it was built for fixed point and the hash of a short fixed game,
+ * and one that differs from the coordinator in either is turned away.
+ *
+ *     bin/Release/sweep --spawn 8 --games 1000 --strategies bot,follow --csv sweep.csv
+ *     bin/Release/sweep --listen tcp:0.0.0.0:7070 --spawn 8 ...     (then on other machines:)
+ *     bin/Release/sweep --connect tcp:coordinator-host:7070 --threads 8
+ *
+ * usage: sweep [--listen address] [--spawn n] [--games n] [--shard-games n] [--strategies list]
+ *              [--seed n] [--max-seconds n] [--retries n] [--timeout n] [--csv file] [level...]
+ *        sweep --connect address [--threads n]
+ *
+ * Addresses are tcp:host:port or unix:path. Every message is one line of
+ * text, so workers and coordinator need not share a byte order:
+ *
+ *     worker       HELLO <protocol> <fixed point> <fingerprint>
+ *     coordinator  LEVEL <level> <time> <blocks, two hex digits each> <name>
+ *     coordinator  JOB <shard> <level> <strategy> <first game> <games> <seed> <max ticks>
+ *     worker       RESULT <shard> <games> <cleared> <timed out> <lives lost> <ticks>
+ *                         <clear ticks> <fastest clear> <slowest clear> <blocks left>
+ *     worker       FAIL <shard> <reason>
+ *     coordinator  BYE
+ */
+
+#if defined(_WIN32)
+#include <winsock2.h>   // before windows.h, which core_thread.h pulls in
+#include <ws2tcpip.h>
+#include <process.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_game.h"
+#include "core/core_bot.h"
+#include "core/core_hash.h"
+#include "core/core_run.h"
+#include "core/core_thread.h"
+#include "tools_common.h"
+
+#if defined(_WIN32)
+typedef SOCKET Socket;
+#define NO_SOCKET INVALID_SOCKET
+#define CloseSocket closesocket
+#else
+typedef int Socket;
+#define NO_SOCKET (-1)
+#define CloseSocket close
+extern char **environ;
+#endif
+
+#define PROTOCOL            2
+#define DEFAULT_ADDRESS     "tcp:127.0.0.1:7070"
+#define DEFAULT_GAMES       100
+#define DEFAULT_SHARD_GAMES 10
+#define DEFAULT_SECONDS     600     // a game still going after this counts as timed out
+#define DEFAULT_RETRIES     2
+#define DEFAULT_TIMEOUT     600     // seconds a shard may run before its worker is given up on
+#define CONNECT_WAIT        10.0    // seconds spawned workers have to connect, and workers to find the coordinator
+#define MAX_WORKERS         60      // within what select() takes everywhere
+#define MESSAGE_MAX         1024
+#define PROBE_TICKS         (30 * CORE_TICK_RATE)   // played for the build fingerprint
+
+
+// -- strategies --------------------------------------------------------------
+
+// Moves the paddle under the lowest ball, with no look ahead; the bot before it traced balls
+static void FollowInput(void *context, const CoreGame *game, CoreInput *input) {
+
+    (void)context;
+
+    if (CoreBallWaiting(game)) input->releaseBall = true;
+
+    int lowest = -1;
+    for (int i = 0; i < game->balls.count; i++) {
+        if (game->balls.state[i] == BALL_ACTIVE && (lowest < 0 || game->balls.y[i] > game->balls.y[lowest])) lowest = i;
+    }
+    if (lowest < 0) return;
+
+    float target = RealToFloat(game->balls.x[lowest]) + CORE_BALL_WIDTH / 2.0f;
+    float center = game->paddle.position + CorePaddleSize(game) / 2.0f;
+
+    int direction = PADDLE_NONE;
+    if (target < center - 3.0f) direction = PADDLE_LEFT;
+    else if (target > center + 3.0f) direction = PADDLE_RIGHT;
+
+    if (game->paddle.reverse && direction != PADDLE_NONE)
+        direction = direction == PADDLE_LEFT ? PADDLE_RIGHT : PADDLE_LEFT;
+
+    input->paddleMove = direction;
+}
+
+
+// Releases the ball and leaves the paddle where it is, for a floor to compare against
+static void IdleInput(void *context, const CoreGame *game, CoreInput *input) {
+    (void)context;
+    if (CoreBallWaiting(game)) input->releaseBall = true;
+}
+
+
+static const struct {
+    const char *name;
+    CoreInputFn input;
+} strategies[] = {
+    { "bot", CoreBotInput },
+    { "follow", FollowInput },
+    { "idle", IdleInput },
+};
+
+#define STRATEGY_COUNT (int)(sizeof(strategies) / sizeof(strategies[0]))
+
+
+static int FindStrategy(const char *name, size_t length) {
+    for (int i = 0; i < STRATEGY_COUNT; i++) {
+        if (strlen(strategies[i].name) == length && strncmp(strategies[i].name, name, length) == 0) return i;
+    }
+    return -1;
+}
+
+
+// -- sockets -----------------------------------------------------------------
+
+static bool StartSockets(void) {
+#if defined(_WIN32)
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    signal(SIGPIPE, SIG_IGN);  // a worker gone mid-send shows up as an error instead
+    return true;
+#endif
+}
+
+
+// Keeps spawned workers from inheriting the socket, which would hold connections open after they close here
+static void KeepToSelf(Socket s) {
+#if defined(_WIN32)
+    SetHandleInformation((HANDLE)s, HANDLE_FLAG_INHERIT, 0);
+#else
+    fcntl(s, F_SETFD, FD_CLOEXEC);
+#endif
+}
+
+
+typedef struct Address {
+    bool isUnix;
+    char host[256];
+    char port[16];
+    char path[108];             // sun_path on every system that has one
+} Address;
+
+
+static bool ParseAddress(const char *text, Address *address) {
+
+    memset(address, 0, sizeof(*address));
+
+    if (strncmp(text, "unix:", 5) == 0) {
+#if defined(_WIN32)
+        fprintf(stderr, "unix sockets are not supported here, use tcp:host:port\n");
+        return false;
+#else
+        address->isUnix = true;
+        return snprintf(address->path, sizeof(address->path), "%s", text + 5) < (int)sizeof(address->path) &&
+               address->path[0] != '\0';
+#endif
+    }
+
+    if (strncmp(text, "tcp:", 4) != 0) return false;
+    text += 4;
+
+    const char *colon = strrchr(text, ':');
+    if (colon == NULL || colon == text || colon - text >= (int)sizeof(address->host)) return false;
+    snprintf(address->host, sizeof(address->host), "%.*s", (int)(colon - text), text);
+    return snprintf(address->port, sizeof(address->port), "%s", colon + 1) < (int)sizeof(address->port) &&
+           address->port[0] != '\0';
+}
+
+
+static Socket OpenSocket(const Address *address, bool listening) {
+
+#if !defined(_WIN32)
+    if (address->isUnix) {
+        struct sockaddr_un local = {0};
+        local.sun_family = AF_UNIX;
+        memcpy(local.sun_path, address->path, strlen(address->path) + 1);
+
+        Socket s = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == NO_SOCKET) return NO_SOCKET;
+        KeepToSelf(s);
+
+        if (listening) unlink(address->path);  // left over from a run that did not finish
+        int result = listening ? bind(s, (struct sockaddr *)&local, sizeof(local))
+                               : connect(s, (struct sockaddr *)&local, sizeof(local));
+        if (result != 0 || (listening && listen(s, MAX_WORKERS) != 0)) {
+            CloseSocket(s);
+            return NO_SOCKET;
+        }
+        return s;
+    }
+#endif
+
+    struct addrinfo hints = {0}, *found = NULL;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    if (getaddrinfo(address->host, address->port, &hints, &found) != 0) return NO_SOCKET;
+
+    Socket s = NO_SOCKET;
+    for (struct addrinfo *at = found; at != NULL && s == NO_SOCKET; at = at->ai_next) {
+        s = socket(at->ai_family, at->ai_socktype, at->ai_protocol);
+        if (s == NO_SOCKET) continue;
+        KeepToSelf(s);
+
+        int result;
+        if (listening) {
+            int reuse = 1;
+            setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+            result = bind(s, at->ai_addr, (int)at->ai_addrlen) == 0 ? listen(s, MAX_WORKERS) : -1;
+        } else {
+            result = connect(s, at->ai_addr, (int)at->ai_addrlen);
+        }
+
+        if (result != 0) {
+            CloseSocket(s);
+            s = NO_SOCKET;
+        }
+    }
+
+    freeaddrinfo(found);
+    return s;
+}
+
+
+static bool SendLine(Socket s, const char *line) {
+    for (size_t sent = 0, length = strlen(line); sent < length;) {
+        int count = send(s, line + sent, (int)(length - sent), 0);
+        if (count <= 0) return false;
+        sent += (size_t)count;
+    }
+    return true;
+}
+
+
+// Lines arriving on a socket, a few at a time
+typedef struct LineReader {
+    Socket socket;
+    char buffer[MESSAGE_MAX * 4];
+    int length;
+} LineReader;
+
+
+/*
+ * Moves the next whole line, without its newline, into line. When none is
+ * buffered whole and read is set, receives once, which blocks until
+ * something arrives.
+ *
+ * @return 1 with a line, 0 if none is whole yet, -1 once the socket is closed or the line too long
+ */
+static int NextLine(LineReader *reader, char *line, bool read) {
+
+    for (;;) {
+        char *end = memchr(reader->buffer, '\n', reader->length);
+        if (end != NULL) {
+            int length = (int)(end - reader->buffer);
+            if (length >= MESSAGE_MAX) return -1;
+
+            memcpy(line, reader->buffer, length);
+            line[length] = '\0';
+            if (length > 0 && line[length - 1] == '\r') line[length - 1] = '\0';
+
+            reader->length -= length + 1;
+            memmove(reader->buffer, end + 1, reader->length);
+            return 1;
+        }
+
+        if (!read) return 0;
+        if (reader->length == (int)sizeof(reader->buffer)) return -1;
+
+        int count = recv(reader->socket, reader->buffer + reader->length, (int)sizeof(reader->buffer) - reader->length, 0);
+        if (count <= 0) return -1;
+        reader->length += count;
+        read = false;  // once per call, so the coordinator never blocks on one worker
+    }
+}
+
+
+// -- the games ---------------------------------------------------------------
+
+// One level as it travels: everything CoreGameSetLevel() needs
+typedef struct Level {
+    const char *file;
+    char name[256];
+    int time;
+    char blocks[CORE_ROW_MAX][CORE_COL_MAX];
+    bool known;                 // on a worker, sent by the coordinator
+} Level;
+
+// Totals of some games; shards are merged into their level and strategy
+typedef struct Totals {
+    int games;
+    int cleared;
+    int timedOut;
+    long long livesLost;
+    unsigned long long ticks;
+    unsigned long long clearTicks;  // cleared games only
+    unsigned long long fastest;     // 0 until something clears
+    unsigned long long slowest;
+    long long blocksLeft;
+} Totals;
+
+
+static void AddTotals(Totals *to, const Totals *from) {
+    if (from->cleared > 0 && (to->cleared == 0 || from->fastest < to->fastest)) to->fastest = from->fastest;
+    if (from->slowest > to->slowest) to->slowest = from->slowest;
+    to->games += from->games;
+    to->cleared += from->cleared;
+    to->timedOut += from->timedOut;
+    to->livesLost += from->livesLost;
+    to->ticks += from->ticks;
+    to->clearTicks += from->clearTicks;
+    to->blocksLeft += from->blocksLeft;
+}
+
+
+// A shard on a worker, played by all its threads
+typedef struct PlayJob {
+    const Level *level;
+    CoreInputFn input;
+    int first;
+    uint64_t seed;
+    unsigned long long maxTicks;
+    CoreGame **games;           // one per thread
+    Totals *results;            // one per game
+} PlayJob;
+
+
+static void PlayGames(void *context, int worker, int begin, int end) {
+
+    const PlayJob *job = context;
+    CoreGame *game = job->games[worker];
+
+    for (int i = begin; i < end; i++) {
+        Totals *result = &job->results[i];
+
+        CoreGameInit(game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+        CoreGameSetLevel(game, job->level->name, job->level->time, job->level->blocks);
+
+        CoreRunStats stats;
+        CoreRunGame(game, job->seed, (uint32_t)(job->first + i), job->maxTicks, job->input, NULL, &stats);
+
+        result->games = 1;
+        result->cleared = stats.cleared;
+        result->timedOut = !stats.cleared && game->mode == MODE_PLAY;
+        result->livesLost = stats.livesLost;
+        result->ticks = stats.ticks;
+        result->clearTicks = stats.cleared ? stats.ticks : 0;
+        result->fastest = result->slowest = result->clearTicks;
+        result->blocksLeft = CoreBlocksRemaining(game);
+    }
+}
+
+
+static bool EncodeLevel(const Level *level, int index, char *line, size_t size) {
+
+    static const char digits[] = "0123456789abcdef";
+    char hex[CORE_ROW_MAX * CORE_COL_MAX * 2 + 1];
+    const unsigned char *blocks = (const unsigned char *)level->blocks;
+
+    for (int i = 0; i < CORE_ROW_MAX * CORE_COL_MAX; i++) {
+        hex[i * 2] = digits[blocks[i] >> 4];
+        hex[i * 2 + 1] = digits[blocks[i] & 15];
+    }
+    hex[sizeof(hex) - 1] = '\0';
+
+    return snprintf(line, size, "LEVEL %d %d %s %s\n", index, level->time, hex, level->name) < (int)size;
+}
+
+
+static int HexDigit(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    return -1;
+}
+
+
+static bool DecodeLevel(const char *line, Level *levels, int levelCount) {
+
+    int index, time, offset;
+    if (sscanf(line, "LEVEL %d %d %n", &index, &time, &offset) != 2 || index < 0 || index >= levelCount) return false;
+
+    Level *level = &levels[index];
+    const char *hex = line + offset;
+    unsigned char *blocks = (unsigned char *)level->blocks;
+
+    for (int i = 0; i < CORE_ROW_MAX * CORE_COL_MAX; i++) {
+        int high = HexDigit(hex[i * 2]), low = HexDigit(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) return false;
+        blocks[i] = (unsigned char)(high << 4 | low);
+    }
+
+    const char *name = hex + CORE_ROW_MAX * CORE_COL_MAX * 2;
+    if (*name == ' ') name++;
+    snprintf(level->name, sizeof(level->name), "%s", name);
+    level->time = time;
+    level->known = true;
+    return true;
+}
+
+
+#ifdef CORE_FIXED_POINT
+#define FIXED_POINT 1
+#else
+#define FIXED_POINT 0
+#endif
+
+/*
+ * CoreGameHash() of a fixed board played by the bot for PROBE_TICKS. Two
+ * builds with the same fingerprint seed, step and steer the same way, so
+ * their games of a shard come out the same.
+ */
+static uint64_t BuildFingerprint(void) {
+
+    static const char kinds[] = "rgbtpyBXms0123";
+    char blocks[CORE_ROW_MAX][CORE_COL_MAX];
+
+    for (int row = 0; row < CORE_ROW_MAX; row++) {
+        for (int col = 0; col < CORE_COL_MAX; col++) {
+            bool filled = row >= 2 && row < 8;
+            blocks[row][col] = filled ? kinds[(row * CORE_COL_MAX + col) % (sizeof(kinds) - 1)] : '.';
+        }
+    }
+
+    CoreGame *game = malloc(sizeof(CoreGame));
+    if (game == NULL) return 0;
+
+    CoreGameInit(game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    CoreGameSetLevel(game, "probe", DEFAULT_SECONDS, blocks);
+
+    CoreRunStats stats;
+    CoreRunGame(game, CORE_DEFAULT_SEED, 0, PROBE_TICKS, CoreBotInput, NULL, &stats);
+
+    uint64_t fingerprint = CoreGameHash(game);
+    free(game);
+    return fingerprint;
+}
+
+
+// -- worker ------------------------------------------------------------------
+
+static int RunWorker(const char *addressText, int threadCount) {
+
+    Address address;
+    if (!ParseAddress(addressText, &address)) {
+        fprintf(stderr, "bad address '%s'\n", addressText);
+        return 2;
+    }
+
+    // the coordinator may still be starting
+    double started = CoreTimeNow();
+    Socket s;
+    while ((s = OpenSocket(&address, false)) == NO_SOCKET) {
+        if (CoreTimeNow() - started > CONNECT_WAIT) {
+            fprintf(stderr, "could not connect to %s\n", addressText);
+            return 1;
+        }
+        CoreSleep(0.1);
+    }
+
+    CoreWorkers *workers = CoreWorkersCreate(threadCount);
+    if (workers == NULL) return 1;
+    threadCount = CoreWorkersCount(workers);
+
+    PlayJob job = {0};
+    job.games = calloc(threadCount, sizeof(CoreGame *));
+    Level *levels = NULL;
+    int levelCount = 0;
+    Totals *results = NULL;
+    int resultCount = 0;
+    if (job.games == NULL) return 1;
+    for (int i = 0; i < threadCount; i++) {
+        if ((job.games[i] = malloc(sizeof(CoreGame))) == NULL) return 1;
+    }
+
+    LineReader reader = { s, {0}, 0 };
+    char line[MESSAGE_MAX];
+    snprintf(line, sizeof(line), "HELLO %d %d %016" PRIx64 "\n", PROTOCOL, FIXED_POINT, BuildFingerprint());
+    bool ok = SendLine(s, line);
+    bool finished = false;
+
+    while (ok && NextLine(&reader, line, true) > 0) {
+
+        int index;
+        if (strcmp(line, "BYE") == 0) {
+            finished = true;
+            break;
+
+        } else if (sscanf(line, "LEVEL %d", &index) == 1) {
+            if (index >= levelCount && index < 1 << 16) {
+                Level *grown = realloc(levels, (index + 1) * sizeof(Level));
+                if (grown == NULL) break;
+                memset(grown + levelCount, 0, (index + 1 - levelCount) * sizeof(Level));
+                levels = grown;
+                levelCount = index + 1;
+            }
+            if (!DecodeLevel(line, levels, levelCount)) {
+                fprintf(stderr, "bad level from the coordinator\n");
+                break;
+            }
+
+        } else if (strncmp(line, "JOB ", 4) == 0) {
+            int shard, level, strategy, first, games;
+            uint64_t seed;
+            unsigned long long maxTicks;
+            if (sscanf(line, "JOB %d %d %d %d %d %" SCNu64 " %llu", &shard, &level, &strategy, &first, &games,
+                       &seed, &maxTicks) != 7) break;
+
+            if (level < 0 || level >= levelCount || !levels[level].known || strategy < 0 ||
+                strategy >= STRATEGY_COUNT || games < 1 || first < 0) {
+                snprintf(line, sizeof(line), "FAIL %d bad job\n", shard);
+                ok = SendLine(s, line);
+                continue;
+            }
+
+            if (games > resultCount) {
+                Totals *grown = realloc(results, games * sizeof(Totals));
+                if (grown == NULL) {
+                    snprintf(line, sizeof(line), "FAIL %d out of memory\n", shard);
+                    ok = SendLine(s, line);
+                    continue;
+                }
+                results = grown;
+                resultCount = games;
+            }
+
+            job.level = &levels[level];
+            job.input = strategies[strategy].input;
+            job.first = first;
+            job.seed = seed;
+            job.maxTicks = maxTicks;
+            job.results = results;
+            CoreWorkersRun(workers, games, 1, PlayGames, &job);
+
+            Totals totals = {0};
+            for (int i = 0; i < games; i++) AddTotals(&totals, &results[i]);
+
+            snprintf(line, sizeof(line), "RESULT %d %d %d %d %lld %llu %llu %llu %llu %lld\n", shard, totals.games,
+                     totals.cleared, totals.timedOut, totals.livesLost, totals.ticks, totals.clearTicks,
+                     totals.fastest, totals.slowest, totals.blocksLeft);
+            ok = SendLine(s, line);
+        }
+    }
+
+    CloseSocket(s);
+    for (int i = 0; i < threadCount; i++) free(job.games[i]);
+    free(job.games);
+    free(levels);
+    free(results);
+    CoreWorkersDestroy(workers);
+
+    // a coordinator turns away workers of another build without a word
+    if (!finished) fprintf(stderr, "the coordinator closed the connection before the sweep was done\n");
+    return finished ? 0 : 1;
+}
+
+
+// -- coordinator -------------------------------------------------------------
+
+typedef enum { SHARD_QUEUED, SHARD_RUNNING, SHARD_DONE, SHARD_FAILED } SHARD_STATE;
+
+typedef struct Shard {
+    int level;
+    int strategy;
+    int first;
+    int games;
+    SHARD_STATE state;
+    int failures;
+    int runners;                // workers playing it; more than one once taken over
+    double started;             // by its first runner still at it
+} Shard;
+
+// one level and strategy
+typedef struct Cell {
+    Totals totals;
+    int shards;
+    int finished;               // done or failed
+    int failed;
+} Cell;
+
+typedef struct Worker {
+    bool connected;
+    LineReader reader;
+    bool greeted;
+    int shard;                  // -1 when free
+    double started;
+    bool *levelsSent;
+    bool leaving;               // sent BYE
+} Worker;
+
+typedef struct Coordinator {
+    Level *levels;
+    int levelCount;
+    int strategyList[STRATEGY_COUNT];
+    int strategyCount;
+    int gamesPerLevel;
+    uint64_t seed;
+    unsigned long long maxTicks;
+    int retries;
+    double timeout;
+    uint64_t fingerprint;       // BuildFingerprint() here, which workers must match
+
+    Shard *shards;
+    int shardCount;
+    int *queue;                 // ring of queued shard numbers; a shard is in it at most once
+    int queueHead;
+    int queueLength;
+    int finished;
+
+    Cell *cells;                // level by strategy
+    Worker workers[MAX_WORKERS];
+    int retried;
+    int stolen;
+    unsigned long long ticks;
+
+    // local workers
+    const char *program;
+    char connectAddress[300];
+    int spawnBudget;            // replacements left
+    bool spawning;
+} Coordinator;
+
+
+static void Enqueue(Coordinator *c, int shard) {
+    c->queue[(c->queueHead + c->queueLength++) % c->shardCount] = shard;
+    c->shards[shard].state = SHARD_QUEUED;
+}
+
+
+static bool SpawnWorker(Coordinator *c) {
+
+#if defined(_WIN32)
+    return _spawnl(_P_NOWAIT, c->program, c->program, "--connect", c->connectAddress, NULL) != -1;
+#else
+    char *arguments[] = { (char *)c->program, "--connect", c->connectAddress, NULL };
+    pid_t pid;
+    return posix_spawnp(&pid, c->program, NULL, NULL, arguments, environ) == 0;
+#endif
+}
+
+
+static void PrintCell(const Coordinator *c, int level, int strategy) {
+
+    const Cell *cell = &c->cells[level * STRATEGY_COUNT + c->strategyList[strategy]];
+    const Totals *t = &cell->totals;
+    const Level *l = &c->levels[level];
+
+    char mean[16], fastest[16];
+    if (t->cleared == 0) {
+        snprintf(mean, sizeof(mean), "-");
+        snprintf(fastest, sizeof(fastest), "-");
+    } else {
+        snprintf(mean, sizeof(mean), "%.1f", (double)t->clearTicks / t->cleared / CORE_TICK_RATE);
+        snprintf(fastest, sizeof(fastest), "%.1f", (double)t->fastest / CORE_TICK_RATE);
+    }
+
+    printf("%-30.30s %-8s %6d %6.1f%% %8s %8s %8.2f %6.1f%s\n", l->name[0] ? l->name : l->file,
+           strategies[c->strategyList[strategy]].name, t->games, t->games > 0 ? 100.0 * t->cleared / t->games : 0.0,
+           mean, fastest, t->games > 0 ? (double)t->livesLost / t->games : 0.0,
+           t->games > 0 ? (double)t->blocksLeft / t->games : 0.0, cell->failed > 0 ? "  (shards failed)" : "");
+    fflush(stdout);
+}
+
+
+static void FinishShard(Coordinator *c, int number, bool failed) {
+
+    Shard *shard = &c->shards[number];
+    shard->state = failed ? SHARD_FAILED : SHARD_DONE;
+    c->finished++;
+
+    int strategy = 0;
+    while (c->strategyList[strategy] != shard->strategy) strategy++;
+
+    Cell *cell = &c->cells[shard->level * STRATEGY_COUNT + shard->strategy];
+    cell->finished++;
+    if (failed) cell->failed++;
+    if (cell->finished == cell->shards) PrintCell(c, shard->level, strategy);
+}
+
+
+// A shard that came to nothing on one worker: queue it again while retries last
+static void ShardFailed(Coordinator *c, int number, const char *why) {
+
+    Shard *shard = &c->shards[number];
+    shard->runners--;
+    if (shard->state != SHARD_RUNNING || shard->runners > 0) return;  // done already, or still running elsewhere
+
+    if (++shard->failures > c->retries) {
+        fprintf(stderr, "shard %d failed %d times (%s), giving up on it\n", number, shard->failures, why);
+        FinishShard(c, number, true);
+        return;
+    }
+
+    c->retried++;
+    Enqueue(c, number);
+}
+
+
+static void DropWorker(Coordinator *c, Worker *worker, const char *why) {
+
+    bool unexpected = !worker->leaving;
+
+    CloseSocket(worker->reader.socket);
+    worker->connected = false;
+    free(worker->levelsSent);
+    worker->levelsSent = NULL;
+
+    if (worker->shard >= 0) ShardFailed(c, worker->shard, why);
+    worker->shard = -1;
+
+    // keep the local pool at strength while there is work
+    if (unexpected && c->spawning && c->finished < c->shardCount && c->spawnBudget > 0) {
+        c->spawnBudget--;
+        if (!SpawnWorker(c)) fprintf(stderr, "could not start a replacement worker\n");
+    }
+}
+
+
+// The next shard for a free worker: queued work first, else the longest running one not yet doubled up
+static int TakeShard(Coordinator *c) {
+
+    while (c->queueLength > 0) {
+        int number = c->queue[c->queueHead];
+        c->queueHead = (c->queueHead + 1) % c->shardCount;
+        c->queueLength--;
+        if (c->shards[number].state == SHARD_QUEUED) return number;
+    }
+
+    int oldest = -1;
+    for (int i = 0; i < c->shardCount; i++) {
+        const Shard *shard = &c->shards[i];
+        if (shard->state == SHARD_RUNNING && shard->runners == 1 &&
+            (oldest < 0 || shard->started < c->shards[oldest].started)) oldest = i;
+    }
+    if (oldest >= 0) c->stolen++;
+    return oldest;
+}
+
+
+static void Assign(Coordinator *c, Worker *worker) {
+
+    int number = TakeShard(c);
+    if (number < 0) return;
+
+    Shard *shard = &c->shards[number];
+    char line[MESSAGE_MAX];
+
+    if (!worker->levelsSent[shard->level]) {
+        if (!EncodeLevel(&c->levels[shard->level], shard->level, line, sizeof(line)) ||
+            !SendLine(worker->reader.socket, line)) {
+            if (shard->state == SHARD_QUEUED) Enqueue(c, number);
+            DropWorker(c, worker, "send failed");
+            return;
+        }
+        worker->levelsSent[shard->level] = true;
+    }
+
+    snprintf(line, sizeof(line), "JOB %d %d %d %d %d %" PRIu64 " %llu\n", number, shard->level, shard->strategy,
+             shard->level * c->gamesPerLevel + shard->first, shard->games, c->seed, c->maxTicks);
+
+    bool first = shard->runners == 0;
+    shard->state = SHARD_RUNNING;
+    shard->runners++;
+    worker->shard = number;
+    worker->started = CoreTimeNow();
+    if (first) shard->started = worker->started;
+
+    if (!SendLine(worker->reader.socket, line)) DropWorker(c, worker, "send failed");
+}
+
+
+static void HandleLine(Coordinator *c, Worker *worker, const char *line) {
+
+    int protocol, fixedPoint, number;
+    uint64_t fingerprint;
+    Totals totals = {0};
+
+    if (sscanf(line, "HELLO %d", &protocol) == 1) {
+        if (protocol != PROTOCOL || sscanf(line, "HELLO %*d %d %" SCNx64, &fixedPoint, &fingerprint) != 2) {
+            DropWorker(c, worker, "wrong protocol");
+            return;
+        }
+        if (fixedPoint != FIXED_POINT || fingerprint != c->fingerprint) {
+            fprintf(stderr, "turned a worker away: it plays games differently (%s build, fingerprint %016" PRIx64
+                    ", here %s, %016" PRIx64 ")\n", fixedPoint ? "fixed-point" : "float", fingerprint,
+                    FIXED_POINT ? "fixed-point" : "float", c->fingerprint);
+            worker->leaving = true;     // a replacement would be the same build
+            DropWorker(c, worker, "different build");
+            return;
+        }
+        worker->greeted = true;
+
+    } else if (sscanf(line, "RESULT %d %d %d %d %lld %llu %llu %llu %llu %lld", &number, &totals.games,
+                      &totals.cleared, &totals.timedOut, &totals.livesLost, &totals.ticks, &totals.clearTicks,
+                      &totals.fastest, &totals.slowest, &totals.blocksLeft) == 10) {
+        if (number != worker->shard) {
+            DropWorker(c, worker, "result for another shard");
+            return;
+        }
+        worker->shard = -1;
+
+        Shard *shard = &c->shards[number];
+        c->ticks += totals.ticks;
+        if (totals.games != shard->games) {
+            ShardFailed(c, number, "wrong number of games");
+            return;
+        }
+
+        shard->runners--;
+        if (shard->state != SHARD_RUNNING) return;  // the other copy got there first
+
+        AddTotals(&c->cells[shard->level * STRATEGY_COUNT + shard->strategy].totals, &totals);
+        FinishShard(c, number, false);
+
+    } else if (sscanf(line, "FAIL %d", &number) == 1 && number == worker->shard) {
+        worker->shard = -1;
+        ShardFailed(c, number, line + 5);
+
+    } else {
+        DropWorker(c, worker, "bad message");
+    }
+}
+
+
+static bool WriteCsv(const char *filename, const Coordinator *c) {
+
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    fprintf(fp, "file,name,strategy,games,cleared,timed_out,clear_rate,clear_mean_s,clear_min_s,clear_max_s,"
+                "lives_lost_mean,blocks_left_mean,failed_shards\n");
+
+    for (int level = 0; level < c->levelCount; level++) {
+        for (int s = 0; s < c->strategyCount; s++) {
+            const Cell *cell = &c->cells[level * STRATEGY_COUNT + c->strategyList[s]];
+            const Totals *t = &cell->totals;
+
+            PrintCsvText(fp, c->levels[level].file);
+            fputc(',', fp);
+            PrintCsvText(fp, c->levels[level].name);
+            fprintf(fp, ",%s,%d,%d,%d,%.4f,", strategies[c->strategyList[s]].name, t->games, t->cleared, t->timedOut,
+                    t->games > 0 ? (double)t->cleared / t->games : 0.0);
+            if (t->cleared > 0)
+                fprintf(fp, "%.2f,%.2f,%.2f,", (double)t->clearTicks / t->cleared / CORE_TICK_RATE,
+                        (double)t->fastest / CORE_TICK_RATE, (double)t->slowest / CORE_TICK_RATE);
+            else
+                fprintf(fp, ",,,");
+            fprintf(fp, "%.3f,%.2f,%d\n", t->games > 0 ? (double)t->livesLost / t->games : 0.0,
+                    t->games > 0 ? (double)t->blocksLeft / t->games : 0.0, cell->failed);
+        }
+    }
+
+    bool success = !ferror(fp);
+    if (fclose(fp) != 0) success = false;
+    return success;
+}
+
+
+// Loads a level to send: its name, time bonus and block characters
+static bool ReadLevel(Level *level, CoreGame *game) {
+
+    CoreGameInit(game, CORE_SCREEN_WIDTH, CORE_SCREEN_HEIGHT);
+    if (!CoreGameNewLevel(game, level->file)) return false;
+
+    snprintf(level->name, sizeof(level->name), "%.*s", (int)strcspn(game->levelName, "\r\n"), game->levelName);
+    level->time = game->timeRemaining;
+    memcpy(level->blocks, game->grid.type, sizeof(level->blocks));
+    return true;
+}
+
+
+static int RunCoordinator(Coordinator *c, const char *addressText, int spawnCount, const char *csvFile) {
+
+    Address address;
+    if (!ParseAddress(addressText, &address)) {
+        fprintf(stderr, "bad address '%s'\n", addressText);
+        return 2;
+    }
+
+    Socket listener = OpenSocket(&address, true);
+    if (listener == NO_SOCKET) {
+        fprintf(stderr, "could not listen on %s\n", addressText);
+        return 1;
+    }
+
+    // port 0 lets the system pick; the workers need to know which
+    if (!address.isUnix && strcmp(address.port, "0") == 0) {
+        struct sockaddr_storage bound;
+        socklen_t length = sizeof(bound);
+        if (getsockname(listener, (struct sockaddr *)&bound, &length) == 0 &&
+            getnameinfo((struct sockaddr *)&bound, length, NULL, 0, address.port, sizeof(address.port),
+                        NI_NUMERICSERV) == 0) {
+            printf("listening on port %s\n", address.port);
+        }
+    }
+
+    // local workers reach a wildcard address over loopback
+    if (address.isUnix) snprintf(c->connectAddress, sizeof(c->connectAddress), "unix:%s", address.path);
+    else snprintf(c->connectAddress, sizeof(c->connectAddress), "tcp:%s:%s",
+                  strcmp(address.host, "0.0.0.0") == 0 || strcmp(address.host, "::") == 0 ? "localhost" : address.host,
+                  address.port);
+
+    c->spawning = spawnCount > 0;
+    c->spawnBudget = spawnCount * (c->retries + 1);
+    for (int i = 0; i < spawnCount; i++) {
+        if (!SpawnWorker(c)) {
+            fprintf(stderr, "could not start worker %d\n", i + 1);
+            CloseSocket(listener);
+            return 1;
+        }
+    }
+
+    printf("%d shards on %s, %d local workers\n\n", c->shardCount, addressText, spawnCount);
+    printf("%-30s %-8s %6s %7s %8s %8s %8s %6s\n", "level", "strategy", "games", "cleared", "mean s", "best s",
+           "lives", "left");
+
+    double started = CoreTimeNow();
+    double lastWorker = started;
+    char line[MESSAGE_MAX];
+
+    while (c->finished < c->shardCount) {
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(listener, &readable);
+        Socket highest = listener;
+        int connected = 0;
+
+        for (int i = 0; i < MAX_WORKERS; i++) {
+            Worker *worker = &c->workers[i];
+            if (!worker->connected) continue;
+            FD_SET(worker->reader.socket, &readable);
+            if (worker->reader.socket > highest) highest = worker->reader.socket;
+            connected++;
+        }
+
+        double now = CoreTimeNow();
+        if (connected > 0) lastWorker = now;
+        else if (c->spawning && now - lastWorker > CONNECT_WAIT) {
+            fprintf(stderr, "no workers left\n");
+            break;
+        }
+
+        struct timeval wait = { 0, 100000 };
+        if (select((int)highest + 1, &readable, NULL, NULL, &wait) < 0) {
+#if !defined(_WIN32)
+            if (errno == EINTR) continue;
+#endif
+            break;
+        }
+
+        if (FD_ISSET(listener, &readable)) {
+            Socket s = accept(listener, NULL, NULL);
+            int slot = 0;
+            while (slot < MAX_WORKERS && c->workers[slot].connected) slot++;
+
+            if (s != NO_SOCKET) KeepToSelf(s);
+            if (s != NO_SOCKET && slot < MAX_WORKERS) {
+                Worker *worker = &c->workers[slot];
+                memset(worker, 0, sizeof(*worker));
+                worker->connected = true;
+                worker->reader.socket = s;
+                worker->shard = -1;
+                worker->levelsSent = calloc(c->levelCount, sizeof(bool));
+                if (worker->levelsSent == NULL) DropWorker(c, worker, "out of memory");
+            } else if (s != NO_SOCKET) {
+                CloseSocket(s);
+            }
+        }
+
+        for (int i = 0; i < MAX_WORKERS; i++) {
+            Worker *worker = &c->workers[i];
+            if (!worker->connected) continue;
+
+            if (FD_ISSET(worker->reader.socket, &readable)) {
+                int got = NextLine(&worker->reader, line, true);
+                while (got > 0 && worker->connected) {
+                    HandleLine(c, worker, line);
+                    if (worker->connected) got = NextLine(&worker->reader, line, false);
+                }
+                if (got < 0 && worker->connected) DropWorker(c, worker, "disconnected");
+            }
+
+            if (worker->connected && worker->shard >= 0 && now - worker->started > c->timeout)
+                DropWorker(c, worker, "timed out");
+
+            if (worker->connected && worker->greeted && worker->shard < 0 && c->finished < c->shardCount)
+                Assign(c, worker);
+        }
+
+#if !defined(_WIN32)
+        while (waitpid(-1, NULL, WNOHANG) > 0) {
+        }
+#endif
+    }
+
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        Worker *worker = &c->workers[i];
+        if (!worker->connected) continue;
+        worker->leaving = true;
+        SendLine(worker->reader.socket, "BYE\n");
+        worker->shard = -1;  // a copy still running elsewhere is not needed any more
+        DropWorker(c, worker, "finished");
+    }
+    CloseSocket(listener);
+#if !defined(_WIN32)
+    if (address.isUnix) unlink(address.path);
+#endif
+
+    double seconds = CoreTimeNow() - started;
+    int failed = 0;
+    for (int i = 0; i < c->shardCount; i++) {
+        if (c->shards[i].state != SHARD_DONE) failed++;
+    }
+
+    printf("\n%llu ticks in %.1f s, %.0f ticks/s; %d shards retried, %d taken over, %d failed\n", c->ticks,
+           seconds, seconds > 0.0 ? c->ticks / seconds : 0.0, c->retried, c->stolen, failed);
+
+    if (csvFile != NULL && !WriteCsv(csvFile, c)) {
+        fprintf(stderr, "%s could not be written\n", csvFile);
+        return 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+
+static void Usage(void) {
+    fprintf(stderr, "usage: sweep [--listen address] [--spawn n] [--games n] [--shard-games n] [--strategies list]\n"
+                    "             [--seed n] [--max-seconds n] [--retries n] [--timeout n] [--csv file] [level...]\n"
+                    "       sweep --connect address [--threads n]\n"
+                    "addresses are tcp:host:port or unix:path; strategies are");
+    for (int i = 0; i < STRATEGY_COUNT; i++) fprintf(stderr, "%s %s", i ? "," : "", strategies[i].name);
+    fprintf(stderr, "\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+    const char *listenAddress = DEFAULT_ADDRESS;
+    const char *connectAddress = NULL;
+    const char *strategyText = "bot";
+    const char *csvFile = NULL;
+    int spawnCount = 0;
+    int threadCount = 1;
+    int shardGames = DEFAULT_SHARD_GAMES;
+    double maxSeconds = DEFAULT_SECONDS;
+
+    static Level levels[MAX_LEVEL_FILES];
+    static Coordinator c;
+    c.gamesPerLevel = DEFAULT_GAMES;
+    c.seed = CORE_DEFAULT_SEED;
+    c.retries = DEFAULT_RETRIES;
+    c.timeout = DEFAULT_TIMEOUT;
+    c.program = argv[0];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--listen") == 0 && i + 1 < argc) listenAddress = argv[++i];
+        else if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc) connectAddress = argv[++i];
+        else if (strcmp(argv[i], "--spawn") == 0 && i + 1 < argc) spawnCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) c.gamesPerLevel = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--shard-games") == 0 && i + 1 < argc) shardGames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--strategies") == 0 && i + 1 < argc) strategyText = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) c.seed = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) maxSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--retries") == 0 && i + 1 < argc) c.retries = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) c.timeout = atof(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csvFile = argv[++i];
+        else if (argv[i][0] != '-' && c.levelCount < (int)(sizeof(levels) / sizeof(levels[0]))) levels[c.levelCount++].file = argv[i];
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (spawnCount < 0 || spawnCount > MAX_WORKERS || threadCount < 0 || c.gamesPerLevel < 1 || shardGames < 1 ||
+        maxSeconds <= 0.0 || c.retries < 0 || c.timeout <= 0.0) {
+        Usage();
+        return 2;
+    }
+
+    for (const char *at = strategyText; *at;) {
+        size_t length = strcspn(at, ",");
+        int strategy = FindStrategy(at, length);
+        bool listed = false;
+        for (int i = 0; i < c.strategyCount; i++) listed |= c.strategyList[i] == strategy;
+        if (strategy < 0 || listed) {
+            Usage();
+            return 2;
+        }
+        c.strategyList[c.strategyCount++] = strategy;
+        at += length;
+        if (*at == ',') at++;
+    }
+    if (c.strategyCount == 0) {
+        Usage();
+        return 2;
+    }
+
+    if (!StartSockets()) return 1;
+
+    // workers need the same file to know the same blocks
+    if (!CoreLoadOptionalBlockTypes(CORE_BLOCK_TYPES_FILE)) return 1;
+
+    if (connectAddress != NULL) return RunWorker(connectAddress, threadCount);
+
+    if (c.levelCount == 0) {
+        const char *files[MAX_NUM_LEVELS];
+        c.levelCount = FindDefaultLevels(files);
+        if (c.levelCount == 0) return 1;
+        for (int i = 0; i < c.levelCount; i++) levels[i].file = files[i];
+    }
+
+    CoreGame *game = malloc(sizeof(CoreGame));
+    if (game == NULL) return 1;
+    for (int i = 0; i < c.levelCount; i++) {
+        if (!ReadLevel(&levels[i], game)) {
+            fprintf(stderr, "%s could not be loaded\n", levels[i].file);
+            return 1;
+        }
+    }
+    free(game);
+
+    c.levels = levels;
+    c.maxTicks = (unsigned long long)(maxSeconds * CORE_TICK_RATE);
+    c.fingerprint = BuildFingerprint();
+
+    int shardsPerCell = (c.gamesPerLevel + shardGames - 1) / shardGames;
+    c.shardCount = c.levelCount * c.strategyCount * shardsPerCell;
+    c.shards = calloc(c.shardCount, sizeof(Shard));
+    c.queue = calloc(c.shardCount, sizeof(int));
+    c.cells = calloc((size_t)c.levelCount * STRATEGY_COUNT, sizeof(Cell));
+    if (c.shards == NULL || c.queue == NULL || c.cells == NULL) return 1;
+
+    for (int level = 0, number = 0; level < c.levelCount; level++) {
+        for (int s = 0; s < c.strategyCount; s++) {
+            c.cells[level * STRATEGY_COUNT + c.strategyList[s]].shards = shardsPerCell;
+            for (int first = 0; first < c.gamesPerLevel; first += shardGames, number++) {
+                Shard *shard = &c.shards[number];
+                shard->level = level;
+                shard->strategy = c.strategyList[s];
+                shard->first = first;
+                shard->games = first + shardGames <= c.gamesPerLevel ? shardGames : c.gamesPerLevel - first;
+                Enqueue(&c, number);
+            }
+        }
+    }
+
+    int result = RunCoordinator(&c, listenAddress, spawnCount, csvFile);
+
+    free(c.shards);
+    free(c.queue);
+    free(c.cells);
+    return result;
+}
@@ -0,0 +1,38 @@
+#include <stdio.h>
+
+#include "tools_common.h"
+
+
+int FindDefaultLevels(const char *files[MAX_NUM_LEVELS]) {
+
+    static char names[MAX_NUM_LEVELS][64];
+    int count = 0;
+
+    for (int i = 1; i <= MAX_NUM_LEVELS; i++) {
+        snprintf(names[i - 1], sizeof(names[i - 1]), LEVEL_PATTERN, i);
+        FILE *fp = fopen(names[i - 1], "r");
+        if (fp == NULL) continue;
+        fclose(fp);
+        files[count++] = names[i - 1];
+    }
+
+    if (count == 0) fprintf(stderr, "no levels found; run from the repository root or name the level files\n");
+    return count;
+}
+
+
+void PrintCsvText(FILE *fp, const char *text) {
+    fputc('"', fp);
+    for (; *text; text++) {
+        if (*text == '"') fputc('"', fp);
+        fputc(*text, fp);
+    }
+    fputc('"', fp);
+}
+
+
+int CompareFloats(const void *a, const void *b) {
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
@@ -0,0 +1,29 @@
+#ifndef _TOOLS_COMMON_H_
+#define _TOOLS_COMMON_H_
+
+/*
+ * Pieces the level tools share: finding the shipped levels, writing CSV
+ * and sorting clear times.
+ */
+
+#include <stdio.h>
+
+#define LEVEL_PATTERN     "resource/levels/level%02d.data"
+#define MAX_NUM_LEVELS    80                    // as the original game
+#define MAX_LEVEL_FILES   (MAX_NUM_LEVELS + 256) // named on the command line, or found
+
+/**
+ * @brief Finds levelNN.data for every NN up to MAX_NUM_LEVELS in resource/levels
+ *
+ * The names stay valid until the program exits.
+ * @return how many were found, after saying so on stderr if none were
+ */
+int FindDefaultLevels(const char *files[MAX_NUM_LEVELS]);
+
+// text as one CSV field, quoted, with quotes doubled
+void PrintCsvText(FILE *fp, const char *text);
+
+// qsort() comparison for ascending floats
+int CompareFloats(const void *a, const void *b);
+
+#endif // _TOOLS_COMMON_H_
@@ -0,0 +1,285 @@
+/**
+ * @file verify_replay.c
+ * @brief Checks that a replay plays out the same every time
+ *
+ * Plays the replay several times at once, each run on its own thread and
+ * each moving balls over a different number of workers, hashing the game
+ * after every tick. Reports the first tick where a run's hashes part from
+ * the first run's, and which parts of the state differ there.
+ *
+ * The hashes can be saved and compared by another build, to check Debug
+ * against Release or one compiler against another:
+ *
+ *     bin/Debug/verify_replay --write debug.hash session.rep
+ *     bin/Release/verify_replay --compare debug.hash session.rep
+ *
+ * usage: verify_replay [--runs n] [--write file] [--compare file] <replay>
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/core_bytes.h"
+#include "core/core_game.h"
+#include "core/core_hash.h"
+#include "core/core_replay.h"
+#include "core/core_thread.h"
+
+#define DEFAULT_RUNS 4
+#define MAX_RUNS     16
+
+static const char HASH_MAGIC[4] = { 'X', 'B', 'H', 'L' };
+
+// one play of the replay: tick 0 is the state before the first step
+typedef struct Run {
+    const CoreReplay *source;
+    int threads;            // ball workers, 0 for none
+    uint64_t *hashes;       // HASH_PART_COUNT per tick
+    unsigned long long ticks;
+    uint64_t finalHash;     // CoreGameHash() after the last tick
+    bool failed;
+} Run;
+
+
+static void HashTick(const CoreGame *game, uint64_t *out) {
+    for (int part = 0; part < HASH_PART_COUNT; part++) {
+        out[part] = CoreHashPart(game, part);
+    }
+}
+
+
+static void PlayRun(void *arg) {
+
+    Run *run = arg;
+
+    // each run reads the file's entries through its own copy
+    CoreReplay replay = *run->source;
+    CoreGame *game = malloc(sizeof(*game));
+    CoreWorkers *workers = run->threads ? CoreWorkersCreate(run->threads) : NULL;
+
+    if (game == NULL || (run->threads && workers == NULL) || !CoreReplayStart(&replay, game)) {
+        run->failed = true;
+        free(game);
+        CoreWorkersDestroy(workers);
+        return;
+    }
+    CoreGameSetWorkers(game, workers);
+
+    HashTick(game, run->hashes);
+    run->ticks = 0;
+
+    while (CoreReplayStep(&replay, game)) {
+        CoreClearEvents(game);
+        run->ticks++;
+        HashTick(game, run->hashes + run->ticks * HASH_PART_COUNT);
+    }
+    run->finalHash = CoreGameHash(game);
+
+    free(game);
+    CoreWorkersDestroy(workers);
+}
+
+
+// The first tick where b differs from a, or -1; parts gets the parts that differ there
+static long long FirstDifference(const uint64_t *a, unsigned long long aTicks,
+                                 const uint64_t *b, unsigned long long bTicks, char *parts, size_t size) {
+
+    unsigned long long ticks = aTicks < bTicks ? aTicks : bTicks;
+
+    for (unsigned long long tick = 0; tick <= ticks; tick++) {
+        const uint64_t *ha = a + tick * HASH_PART_COUNT;
+        const uint64_t *hb = b + tick * HASH_PART_COUNT;
+        if (memcmp(ha, hb, HASH_PART_COUNT * sizeof(*ha)) == 0) continue;
+
+        parts[0] = '\0';
+        for (int part = 0; part < HASH_PART_COUNT; part++) {
+            if (ha[part] == hb[part]) continue;
+            if (parts[0] != '\0') strncat(parts, ", ", size - strlen(parts) - 1);
+            strncat(parts, CoreHashPartName(part), size - strlen(parts) - 1);
+        }
+        return (long long)tick;
+    }
+
+    if (aTicks != bTicks) {
+        snprintf(parts, size, "length, %llu ticks against %llu", bTicks, aTicks);
+        return (long long)ticks + 1;
+    }
+    return -1;
+}
+
+
+static void WriteU64(FILE *fp, uint64_t value) {
+    unsigned char bytes[8];
+    CorePutU64(bytes, value);
+    fwrite(bytes, 1, sizeof(bytes), fp);
+}
+
+static bool ReadU64(FILE *fp, uint64_t *value) {
+    unsigned char bytes[8];
+    if (fread(bytes, 1, sizeof(bytes), fp) != sizeof(bytes)) return false;
+    *value = CoreGetU64(bytes);
+    return true;
+}
+
+
+static bool WriteHashes(const char *filename, const Run *run) {
+
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return false;
+    }
+
+    fwrite(HASH_MAGIC, 1, sizeof(HASH_MAGIC), fp);
+    WriteU64(fp, HASH_PART_COUNT);
+    WriteU64(fp, run->ticks);
+    for (unsigned long long i = 0; i < (run->ticks + 1) * HASH_PART_COUNT; i++) {
+        WriteU64(fp, run->hashes[i]);
+    }
+
+    bool success = !ferror(fp);
+    if (fclose(fp) != 0) success = false;
+    return success;
+}
+
+
+static uint64_t *ReadHashes(const char *filename, unsigned long long *ticks) {
+
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        printf("File '%s' could not be opened.", filename);
+        return NULL;
+    }
+
+    char magic[4];
+    uint64_t parts, count = 0;
+    uint64_t *hashes = NULL;
+
+    if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic) && memcmp(magic, HASH_MAGIC, sizeof(magic)) == 0
+        && ReadU64(fp, &parts) && parts == HASH_PART_COUNT && ReadU64(fp, &count) && count < SIZE_MAX / 64) {
+
+        hashes = malloc((count + 1) * HASH_PART_COUNT * sizeof(*hashes));
+        for (uint64_t i = 0; hashes != NULL && i < (count + 1) * HASH_PART_COUNT; i++) {
+            if (!ReadU64(fp, &hashes[i])) {
+                free(hashes);
+                hashes = NULL;
+            }
+        }
+    }
+    fclose(fp);
+
+    if (hashes == NULL) fprintf(stderr, "%s: not a hash file from this tool\n", filename);
+    *ticks = count;
+    return hashes;
+}
+
+
+static void Usage(void) {
+    fprintf(stderr, "usage: verify_replay [--runs n] [--write file] [--compare file] <replay>\n");
+}
+
+
+int main(int argc, char *argv[]) {
+
+    int runCount = DEFAULT_RUNS;
+    const char *writeFile = NULL;
+    const char *compareFile = NULL;
+    const char *replayFile = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) runCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--write") == 0 && i + 1 < argc) writeFile = argv[++i];
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) compareFile = argv[++i];
+        else if (argv[i][0] != '-' && replayFile == NULL) replayFile = argv[i];
+        else {
+            Usage();
+            return 2;
+        }
+    }
+    if (replayFile == NULL || runCount < 1 || runCount > MAX_RUNS) {
+        Usage();
+        return 2;
+    }
+
+    if (!CoreLoadOptionalBlockTypes(CORE_BLOCK_TYPES_FILE)) return 1;
+
+    CoreReplay replay;
+    if (!CoreReplayLoad(&replay, replayFile)) return 1;
+    printf("replay    %s, %llu ticks\n", replayFile, replay.ticks);
+
+    // the first run is serial, the rest spread balls over more and more workers
+    static Run runs[MAX_RUNS];
+    static CoreThread threads[MAX_RUNS];
+
+    for (int i = 0; i < runCount; i++) {
+        runs[i].source = &replay;
+        runs[i].threads = i == 0 ? 0 : 1 << ((i - 1) % 4);
+        runs[i].hashes = malloc((replay.ticks + 1) * HASH_PART_COUNT * sizeof(uint64_t));
+        if (runs[i].hashes == NULL) return 1;
+    }
+
+    for (int i = 1; i < runCount; i++) {
+        if (!CoreThreadStart(&threads[i], PlayRun, &runs[i])) runs[i].failed = true;
+    }
+    PlayRun(&runs[0]);
+    for (int i = 1; i < runCount; i++) {
+        if (!runs[i].failed) CoreThreadJoin(threads[i]);
+    }
+
+    if (runs[0].failed) {
+        fprintf(stderr, "the replay could not be played\n");
+        return 1;
+    }
+
+    const uint64_t *first = runs[0].hashes;
+    bool agree = true;
+    char parts[128];
+
+    printf("run 0     serial        final state %016" PRIx64 "\n", runs[0].finalHash);
+
+    for (int i = 1; i < runCount; i++) {
+        printf("run %-2d    %2d workers    ", i, runs[i].threads);
+        if (runs[i].failed) {
+            printf("could not be played\n");
+            agree = false;
+            continue;
+        }
+
+        long long tick = FirstDifference(first, runs[0].ticks, runs[i].hashes, runs[i].ticks, parts, sizeof(parts));
+        if (tick < 0) {
+            printf("agrees\n");
+        } else {
+            printf("diverges at tick %lld (%s)\n", tick, parts);
+            agree = false;
+        }
+    }
+
+    if (compareFile != NULL) {
+        unsigned long long ticks;
+        uint64_t *saved = ReadHashes(compareFile, &ticks);
+        if (saved == NULL) return 1;
+
+        long long tick = FirstDifference(saved, ticks, first, runs[0].ticks, parts, sizeof(parts));
+        printf("compare   %s: ", compareFile);
+        if (tick < 0) {
+            printf("agrees\n");
+        } else {
+            printf("diverges at tick %lld (%s)\n", tick, parts);
+            agree = false;
+        }
+        free(saved);
+    }
+
+    if (writeFile != NULL && !WriteHashes(writeFile, &runs[0])) {
+        fprintf(stderr, "%s could not be written\n", writeFile);
+        return 1;
+    }
+
+    for (int i = 0; i < runCount; i++) free(runs[i].hashes);
+    CoreReplayFree(&replay);
+
+    return agree ? 0 : 1;
+}